@@ -0,0 +1,138 @@
+/******************************************************************************
+* Fully-fixsliced implementation of the AES-128 decryption in C.
+* It relies on the same round keys as the encryption (aes128_keyschedule_ffs
+* and aes128_keyschedule_ffs_lut) and reuses its building blocks:
+* - the inverse S-box is computed as L^-1 o S' o L^-1, where S' refers to the
+*   bitsliced S-box without the final NOTs (see sbox) and L to the linear part
+*   of the S-box affine transformation. Because the NOTs are moved to the round
+*   keys, the state is ready for S'^-1 after each AddRoundKey.
+* - InvMixColumns is computed as MixColumns o P where P multiplies each column
+*   by 04x^2 + 05, which boils down to x + 4(x + ROT2(x)). In the fixsliced
+*   representation, ROT2 rotates each column by 2 rows and, for the rounds
+*   relying on mixcolumns_0 and mixcolumns_2, by 2 columns as well.
+*
+* See the paper at https://eprint.iacr.org/2020/1123.pdf for more details on
+* the encryption.
+******************************************************************************/
+#include "aes.h"
+#include "internal-aes.h"
+
+/******************************************************************************
+* Applies the linear part of the inverse S-box affine transformation, i.e.
+* b_i = b_{i+2} ^ b_{i+5} ^ b_{i+7}, where state[i] holds the bits b_{7-i}.
+******************************************************************************/
+static void inv_affine_lin(uint32_t* state) {
+	uint32_t t0 = state[0], t1 = state[1], t2 = state[2], t3 = state[3];
+	uint32_t t4 = state[4], t5 = state[5], t6 = state[6], t7 = state[7];
+	state[0] = t1 ^ t3 ^ t6;
+	state[1] = t2 ^ t4 ^ t7;
+	state[2] = t3 ^ t5 ^ t0;
+	state[3] = t4 ^ t6 ^ t1;
+	state[4] = t5 ^ t7 ^ t2;
+	state[5] = t6 ^ t0 ^ t3;
+	state[6] = t7 ^ t1 ^ t4;
+	state[7] = t0 ^ t2 ^ t5;
+}
+
+/******************************************************************************
+* Bitsliced inverse S-box (without the NOTs, which are included in the round
+* keys).
+******************************************************************************/
+static void inv_sbox(uint32_t* state) {
+	inv_affine_lin(state);
+	sbox(state);
+	inv_affine_lin(state);
+}
+
+/******************************************************************************
+* Computes x + 4(x + ROT2(x)) so that InvMixColumns = MixColumns o P.
+* ROT2 rotates each column by 2 rows (i.e. ROR by 16 bits) and, if the rows
+* are shifted by an odd number of positions w.r.t. each other in the fixsliced
+* representation (i.e. for rounds i s.t. (i%2) == 0), by 2 columns (i.e.
+* BYTE_ROR_4).
+******************************************************************************/
+static void inv_mixcolumns_pre(uint32_t* state, int odd) {
+	uint32_t u[8];
+	for(int i = 0; i < 8; i++) {
+		u[i] = ROR(state[i], 16);
+		if (odd)
+			u[i] = BYTE_ROR_4(u[i]);
+		u[i] ^= state[i];
+	}
+	// state += 4u over GF(2^8), state[0] holding the MSBs
+	state[0] ^= u[2];
+	state[1] ^= u[3];
+	state[2] ^= u[4] ^ u[0];
+	state[3] ^= u[5] ^ u[0] ^ u[1];
+	state[4] ^= u[6] ^ u[1];
+	state[5] ^= u[7] ^ u[0];
+	state[6] ^= u[0] ^ u[1];
+	state[7] ^= u[1];
+}
+
+static void inv_mixcolumns_0(uint32_t* state) {
+	inv_mixcolumns_pre(state, 1);
+	mixcolumns_0(state);
+}
+
+static void inv_mixcolumns_1(uint32_t* state) {
+	inv_mixcolumns_pre(state, 0);
+	mixcolumns_1(state);
+}
+
+static void inv_mixcolumns_2(uint32_t* state) {
+	inv_mixcolumns_pre(state, 1);
+	mixcolumns_2(state);
+}
+
+static void inv_mixcolumns_3(uint32_t* state) {
+	inv_mixcolumns_pre(state, 0);
+	mixcolumns_3(state);
+}
+
+/******************************************************************************
+* Fully-fixsliced AES-128 decryption (the ShiftRows is completely omitted).
+* Two 128-bit blocks ctext0, ctext1 are decrypted into ptext0, ptext1 without
+* any operating mode. The round keys are the encryption ones, assumed to be
+* pre-computed.
+* Note that ctext0, ctext1 can refer to the same block and that the ptext
+* parameters can be the same as the ctext ones.
+******************************************************************************/
+void aes128_decrypt_ffs(unsigned char* ptext0, unsigned char* ptext1,
+					const unsigned char* ctext0, const unsigned char* ctext1,
+					const uint32_t* rkeys_ffs) {
+	uint32_t state[8]; 					// 256-bit internal state
+	packing(state, ctext0, ctext1);		// packs into bitsliced representation
+	ark(state, rkeys_ffs + 80); 		// 10th round
+	double_shiftrows(state); 			// 10th round (resynchronization)
+	inv_sbox(state); 					// 10th round
+	ark(state, rkeys_ffs + 72); 		// 9th round
+	inv_mixcolumns_0(state); 			// 9th round
+	inv_sbox(state); 					// 9th round
+	ark(state, rkeys_ffs + 64); 		// 8th round
+	inv_mixcolumns_3(state); 			// 8th round
+	inv_sbox(state); 					// 8th round
+	ark(state, rkeys_ffs + 56); 		// 7th round
+	inv_mixcolumns_2(state); 			// 7th round
+	inv_sbox(state); 					// 7th round
+	ark(state, rkeys_ffs + 48); 		// 6th round
+	inv_mixcolumns_1(state); 			// 6th round
+	inv_sbox(state); 					// 6th round
+	ark(state, rkeys_ffs + 40); 		// 5th round
+	inv_mixcolumns_0(state); 			// 5th round
+	inv_sbox(state); 					// 5th round
+	ark(state, rkeys_ffs + 32); 		// 4th round
+	inv_mixcolumns_3(state); 			// 4th round
+	inv_sbox(state); 					// 4th round
+	ark(state, rkeys_ffs + 24); 		// 3rd round
+	inv_mixcolumns_2(state); 			// 3rd round
+	inv_sbox(state); 					// 3rd round
+	ark(state, rkeys_ffs + 16); 		// 2nd round
+	inv_mixcolumns_1(state); 			// 2nd round
+	inv_sbox(state); 					// 2nd round
+	ark(state, rkeys_ffs + 8); 			// 1st round
+	inv_mixcolumns_0(state); 			// 1st round
+	inv_sbox(state); 					// 1st round
+	ark(state, rkeys_ffs); 				// key whitening
+	unpacking(ptext0, ptext1, state);	// unpacks the state to the output
+}
@@ -53,7 +53,7 @@ void packing(uint32_t* out, const unsigned char* in0,
 /******************************************************************************
 * Unpacks the 256-bit internal state in two 128-bit blocs out0, out1.
 ******************************************************************************/
-static void unpacking(unsigned char* out0, unsigned char* out1, uint32_t* in) {
+void unpacking(unsigned char* out0, unsigned char* out1, uint32_t* in) {
 	uint32_t tmp;
 	SWAPMOVE(in[4], in[0], 0x0f0f0f0f, 4);
 	SWAPMOVE(in[5], in[1], 0x0f0f0f0f, 4);
@@ -81,7 +81,7 @@ static void unpacking(unsigned char* out0, unsigned char* out1, uint32_t* in) {
 * XOR the round key to the internal state. The round keys are expected to be 
 * pre-computed and to be packed in the fixsliced representation.
 ******************************************************************************/
-static void ark(uint32_t* state, const uint32_t* rkey) {
+void ark(uint32_t* state, const uint32_t* rkey) {
 	for(int i = 0; i < 8; i++)
 		state[i] ^= rkey[i];
 }
@@ -217,7 +217,7 @@ void sbox(uint32_t* state) {
 /******************************************************************************
 * Applies the ShiftRows transformation twice (i.e. SR^2) on the internal state.
 ******************************************************************************/
-static void double_shiftrows(uint32_t* state) {
+void double_shiftrows(uint32_t* state) {
     uint32_t tmp;
 	for(int i = 0; i < 8; i++)
         SWAPMOVE(state[i], state[i], 0x0f000f00, 4);
@@ -228,7 +228,7 @@ static void double_shiftrows(uint32_t* state) {
 * For fully-fixsliced implementations, it is used for rounds i s.t. (i%4) == 0.
 * For semi-fixsliced implementations, it is used for rounds i s.t. (i%2) == 0.
 ******************************************************************************/
-static void mixcolumns_0(uint32_t* state) {
+void mixcolumns_0(uint32_t* state) {
 	uint32_t t0, t1, t2, t3, t4;
 	t3 = ROR(BYTE_ROR_6(state[0]),8);
 	t0 = state[0] ^ t3;
@@ -260,7 +260,7 @@ static void mixcolumns_0(uint32_t* state) {
 * Computation of the MixColumns transformation in the fixsliced representation.
 * For fully-fixsliced implementations only, for round i s.t. (i%4) == 1.
 ******************************************************************************/
-static void mixcolumns_1(uint32_t* state) {
+void mixcolumns_1(uint32_t* state) {
 	uint32_t t0, t1, t2;
 	t0 = state[0] ^ ROR(BYTE_ROR_4(state[0]),8);
 	t1 = state[7] ^ ROR(BYTE_ROR_4(state[7]),8);
@@ -313,7 +313,7 @@ static void mixcolumns_1(uint32_t* state) {
 * Computation of the MixColumns transformation in the fixsliced representation.
 * For fully-fixsliced implementations only, for rounds i s.t. (i%4) == 2.
 ******************************************************************************/
-static void mixcolumns_2(uint32_t* state) {
+void mixcolumns_2(uint32_t* state) {
 	uint32_t t0, t1, t2, t3, t4;
 	t3 = ROR(BYTE_ROR_2(state[0]),8);
 	t0 = state[0] ^ t3;
@@ -347,7 +347,7 @@ static void mixcolumns_2(uint32_t* state) {
 * For semi-fixsliced implementations, it is used for rounds i s.t. (i%2) == 1.
 * Based on Käsper-Schwabe, similar to https://github.com/Ko-/aes-armcortexm.
 ******************************************************************************/
-static void mixcolumns_3(uint32_t* state) {
+void mixcolumns_3(uint32_t* state) {
 	uint32_t t0, t1, t2;
 	t0 = state[7] ^ ROR(state[7],8);
 	t2 = state[0] ^ ROR(state[0],8);
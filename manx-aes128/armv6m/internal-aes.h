@@ -35,6 +35,17 @@
 void packing(uint32_t* out, const unsigned char* in0,
 		const unsigned char* in1);
 
+void unpacking(unsigned char* out0, unsigned char* out1, uint32_t* in);
+
+void ark(uint32_t* state, const uint32_t* rkey);
+
 void sbox(uint32_t* state);
 
+void double_shiftrows(uint32_t* state);
+
+void mixcolumns_0(uint32_t* state);
+void mixcolumns_1(uint32_t* state);
+void mixcolumns_2(uint32_t* state);
+void mixcolumns_3(uint32_t* state);
+
 #endif 	// INTERNAL_AES_H_
\ No newline at end of file
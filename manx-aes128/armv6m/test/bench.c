@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../manx.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define UNIT "cycles"
+static uint64_t ticks(void) { return __rdtsc(); }
+#else
+#include <time.h>
+#define UNIT "ns"
+static uint64_t ticks(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+#endif
+
+/**
+ * Number of timed runs (the median is reported) and number of calls per run.
+ * The code being the C one meant for microcontrollers, these figures are only
+ * relevant to compare functions with each other.
+ */
+#define RUNS    101
+#define NCALLS  256
+
+static int cmp_u64(const void *x, const void *y)
+{
+    uint64_t a = *(const uint64_t *)x, b = *(const uint64_t *)y;
+    return (a > b) - (a < b);
+}
+
+static uint64_t median(uint64_t t[RUNS])
+{
+    qsort(t, RUNS, sizeof(t[0]), cmp_u64);
+    return t[RUNS/2];
+}
+
+/**
+ * Time NCALLS calls, each processing per messages, and print the median cost
+ * of a message (any non-zero return value being reported by the exit code).
+ */
+#define BENCH_CALL(name, per, call)                                               \
+    do {                                                                       \
+        uint64_t t[RUNS];                                                      \
+        for (size_t r = 0; r < RUNS; r++) {                                    \
+            uint64_t start = ticks();                                          \
+            for (size_t i = 0; i < NCALLS; i++)                                \
+                sink ^= (call);                                                \
+            t[r] = ticks() - start;                                            \
+        }                                                                      \
+        printf("%-28s %10.1f\n", name, (double)median(t)/(NCALLS*(per)));     \
+    } while (0)
+
+int main(void) {
+    uint8_t      key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    uint8_t      n[16] = {0}, a[16] = {0}, m[2*BLOCKBYTES] = {0}, p[2*BLOCKBYTES];
+    uint8_t      c1[BLOCKBYTES], c1b[BLOCKBYTES], c2[2*BLOCKBYTES], c3[2*BLOCKBYTES];
+    uint8_t      b0[BLOCKBYTES] = {0}, b1[BLOCKBYTES] = {0};
+    uint32_t     rkeys[88];
+    size_t       clen1, clen1b, clen2, clen3, len;
+    volatile int sink = 0;
+
+    aes128_keyschedule_ffs_lut(rkeys, key);
+    manx1_aes128_enc(c1, &clen1, key, n, 96, m, 30, a, 32);
+    manx2_aes128_enc(c2, &clen2, key, n, 64, m, 32, a, 16, NULL, NULL);
+    manx2_aes128_enc(c3, &clen3, key, n, 64, m, 96, a, 16, NULL, NULL);
+
+    printf("%-28s %10s\n", UNIT "/call", "");
+    BENCH_CALL("aes128_keyschedule_ffs_lut", 1, (aes128_keyschedule_ffs_lut(rkeys, key), 0));
+    BENCH_CALL("aes128_encrypt_ffs (2 blocks)", 1, (aes128_encrypt_ffs(b0, b1, b0, b1, rkeys), 0));
+    BENCH_CALL("aes128_decrypt_ffs (2 blocks)", 1, (aes128_decrypt_ffs(b0, b1, b0, b1, rkeys), 0));
+
+    printf("\n%-28s %10s\n", UNIT "/message", "");
+    BENCH_CALL("manx1 enc (96,32,30)", 1, manx1_aes128_enc(c1, &len, key, n, 96, m, 30, a, 32));
+    BENCH_CALL("manx1 enc_x2 (96,32,30)", 2, manx1_aes128_enc_x2(c1, &len, c1b, &clen1b, key,
+                                             n, 96, m, 30, a, 32, n, 96, m, 30, a, 32));
+    BENCH_CALL("manx1 dec (96,32,30)", 1, manx1_aes128_dec(p, &len, key, n, 96, c1, clen1, a, 32));
+    BENCH_CALL("manx2 enc (64,16,32)", 1, manx2_aes128_enc(c2, &len, key, n, 64, m, 32, a, 16, NULL, NULL));
+    BENCH_CALL("manx2 dec (64,16,32)", 1, manx2_aes128_dec(p, &len, key, n, 64, c2, clen2, a, 16));
+    BENCH_CALL("manx2 enc (64,16,96)", 1, manx2_aes128_enc(c3, &len, key, n, 64, m, 96, a, 16, NULL, NULL));
+    BENCH_CALL("manx2 dec (64,16,96)", 1, manx2_aes128_dec(p, &len, key, n, 64, c3, clen3, a, 16));
+
+    return sink != 0;
+}
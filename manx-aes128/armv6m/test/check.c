@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <string.h>
+#include "../manx.h"
+
+/**
+ * Known-answer ciphertexts (same as for x86_64, the Manx1 configuration
+ * being the same).
+ */
+static const char *kat_manx1_96_30_64  = "60bc7d2ed795cd6a29666588a66aad75";
+static const char *kat_manx1_128_63_0  = "f98151c4dca6e92eb49cfd199b091e33";
+
+static int failures = 0;
+
+static void check(int cond, const char *what)
+{
+    if (!cond) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static int hexeq(const uint8_t *buf, size_t len, const char *hex)
+{
+    char tmp[2*BLOCKBYTES + 1];
+    for (size_t i = 0; i < len; i++)
+        sprintf(tmp + 2*i, "%02x", buf[i]);
+    return strcmp(tmp, hex) == 0;
+}
+
+static void fill(uint8_t *buf, size_t len, uint8_t seed)
+{
+    for (size_t i = 0; i < len; i++)
+        buf[i] = (uint8_t)(seed + 0x9d*i + (i >> 1));
+}
+
+static void check_kat(const uint8_t key[16])
+{
+    uint8_t ad[16], nonce[16], ptext[16], ctext[BLOCKBYTES], ctext1[BLOCKBYTES];
+    size_t  outlen, outlen1;
+
+    for (size_t i = 0; i < 16; i++)
+        ad[i] = nonce[i] = i;
+    memcpy(ptext, "\x7f\x43\xf6\xaf\x88\x5a\x30\x8d\x31\x31\x98\xa2\xe0\x37\x07\x34", 16);
+
+    manx1_aes128_enc(ctext, &outlen, key, nonce, 96, ptext, 30, ad, 64);
+    check(hexeq(ctext, outlen/8, kat_manx1_96_30_64), "manx1_aes128_enc KAT (96, 30, 64)");
+    manx1_aes128_enc(ctext, &outlen, key, nonce, 128, ptext, 63, ad, 0);
+    check(hexeq(ctext, outlen/8, kat_manx1_128_63_0), "manx1_aes128_enc KAT (128, 63, 0)");
+
+    manx1_aes128_enc_x2(ctext, &outlen, ctext1, &outlen1, key,
+                        nonce, 96, ptext, 30, ad, 64, nonce, 128, ptext, 63, ad, 0);
+    check(hexeq(ctext, outlen/8, kat_manx1_96_30_64), "manx1_aes128_enc_x2 KAT (96, 30, 64)");
+    check(hexeq(ctext1, outlen1/8, kat_manx1_128_63_0), "manx1_aes128_enc_x2 KAT (128, 63, 0)");
+}
+
+/**
+ * Paired encryption against two single-message ones, each message being
+ * paired with a different parameter set, rejected ones included.
+ */
+static void check_pairs(const uint8_t key[16])
+{
+    uint8_t n0[16], a0[16], m0[16], n1[16], a1[16], m1[16];
+    uint8_t c0[BLOCKBYTES], c1[BLOCKBYTES], ref0[BLOCKBYTES], ref1[BLOCKBYTES];
+    size_t  clen0, clen1, rlen0, rlen1;
+    int     ok = 1;
+
+    for (size_t nlen = 64; nlen <= 128; nlen += 8) {
+        for (size_t alen = 0; alen <= MANX1_ALPHAMAX + 8; alen += 8) {
+            for (size_t mlen = 0; mlen < 72; mlen += 5) {
+                size_t nlen1 = 192 - nlen, alen1 = MANX1_ALPHAMAX - alen % MANX1_ALPHAMAX, mlen1 = 63 - mlen % 64;
+                int    ret0, ret1, ret;
+
+                fill(n0, sizeof(n0), nlen);
+                fill(a0, sizeof(a0), alen + 7);
+                fill(m0, sizeof(m0), mlen + 13);
+                fill(n1, sizeof(n1), nlen1 + 1);
+                fill(a1, sizeof(a1), alen1 + 3);
+                fill(m1, sizeof(m1), mlen1 + 5);
+                ret0 = manx1_aes128_enc(ref0, &rlen0, key, n0, nlen, m0, mlen, a0, alen);
+                ret1 = manx1_aes128_enc(ref1, &rlen1, key, n1, nlen1, m1, mlen1, a1, alen1);
+                ret  = manx1_aes128_enc_x2(c0, &clen0, c1, &clen1, key,
+                                           n0, nlen, m0, mlen, a0, alen,
+                                           n1, nlen1, m1, mlen1, a1, alen1);
+                ok &= ret == (ret0 ? ret0 : ret1);
+                ok &= clen0 == rlen0 && clen1 == rlen1;
+                ok &= ret0 || memcmp(c0, ref0, BLOCKBYTES) == 0;
+                ok &= ret1 || memcmp(c1, ref1, BLOCKBYTES) == 0;
+            }
+        }
+    }
+    check(ok, "manx1_aes128_enc_x2 matches manx1_aes128_enc");
+}
+
+/**
+ * Decryption against encryption for random blocks.
+ */
+static void check_aes_dec(const uint8_t key[16])
+{
+    uint32_t rkeys[88];
+    uint8_t  p0[16], p1[16], c0[16], c1[16], q0[16], q1[16];
+    int      ok = 1;
+
+    aes128_keyschedule_ffs_lut(rkeys, key);
+    for (size_t i = 0; i < 64; i++) {
+        fill(p0, sizeof(p0), i);
+        fill(p1, sizeof(p1), i + 0x80);
+        aes128_encrypt_ffs(c0, c1, p0, p1, rkeys);
+        aes128_decrypt_ffs(q0, q1, c0, c1, rkeys);
+        ok &= memcmp(p0, q0, 16) == 0 && memcmp(p1, q1, 16) == 0;
+    }
+    check(ok, "aes128_decrypt_ffs inverts aes128_encrypt_ffs");
+}
+
+static int bits_equal(const uint8_t *x, const uint8_t *y, size_t bitlen)
+{
+    if (memcmp(x, y, bitlen/8))
+        return 0;
+    if (bitlen % 8)
+        return ((x[bitlen/8] ^ y[bitlen/8]) & (0xff << (8 - bitlen%8))) == 0;
+    return 1;
+}
+
+/**
+ * Decryption round trips over all the valid parameter sets, a flipped
+ * ciphertext bit being rejected.
+ */
+static void check_roundtrips(const uint8_t key[16])
+{
+    uint8_t n[16], a[16], m[2*BLOCKBYTES], c[2*BLOCKBYTES], p[2*BLOCKBYTES];
+    size_t  clen, plen;
+    int     ok1 = 1, ok2 = 1;
+
+    for (size_t nlen = 0; nlen <= BLOCKBITS; nlen += 8) {
+        for (size_t alen = 0; alen <= MANX1_ALPHAMAX; alen += 8) {
+            for (size_t mlen = 0; mlen < BLOCKBITS; mlen++) {
+                fill(n, sizeof(n), nlen);
+                fill(a, sizeof(a), alen + 7);
+                fill(m, sizeof(m), mlen + 13);
+                if (manx1_aes128_enc(c, &clen, key, n, nlen, m, mlen, a, alen))
+                    continue;
+                ok1 &= manx1_aes128_dec(p, &plen, key, n, nlen, c, clen, a, alen) == 0;
+                ok1 &= plen == mlen && bits_equal(p, m, mlen);
+                c[mlen % BLOCKBYTES] ^= 0x10;
+                ok1 &= manx1_aes128_dec(p, &plen, key, n, nlen, c, clen, a, alen) != 0;
+            }
+        }
+    }
+    check(ok1, "manx1_aes128_dec inverts manx1_aes128_enc");
+
+    // r = n - (ν + α* + 2) has to be non-negative
+    for (size_t nlen = MANX_TAU; nlen + MANX2_ALPHASTAR + 2 <= BLOCKBITS; nlen += 8) {
+        for (size_t alen = 0; alen <= MANX2_ALPHAMAX; alen += 8) {
+            if (!MANX2_VARIABLE_ADLEN && alen != MANX2_ALPHAMAX)
+                continue;
+            for (size_t mlen = 0; mlen < 2*BLOCKBITS; mlen++) {
+                fill(n, sizeof(n), nlen);
+                fill(a, sizeof(a), alen + 7);
+                fill(m, sizeof(m), mlen + 13);
+                if (manx2_aes128_enc(c, &clen, key, n, nlen, m, mlen, a, alen, NULL, NULL))
+                    continue;
+                ok2 &= manx2_aes128_dec(p, &plen, key, n, nlen, c, clen, a, alen) == 0;
+                ok2 &= plen == mlen && bits_equal(p, m, mlen);
+                c[(mlen*7) % (clen/8)] ^= 0x01;
+                ok2 &= manx2_aes128_dec(p, &plen, key, n, nlen, c, clen, a, alen) != 0;
+            }
+        }
+    }
+    check(ok2, "manx2_aes128_dec inverts manx2_aes128_enc");
+}
+
+int main(void) {
+    uint8_t key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+
+    check_kat(key);
+    check_pairs(key);
+    check_aes_dec(key);
+    check_roundtrips(key);
+
+    printf("%s\n", failures ? "checks FAILED" : "all checks passed");
+    return failures != 0;
+}
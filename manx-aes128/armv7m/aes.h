@@ -15,6 +15,11 @@ void aes256_encrypt_ffs(unsigned char ctext0[16], unsigned char ctext1[16],
 				const unsigned char ptext0[16], const unsigned char ptext1[16],
 				const uint32_t rkeys[120]);
 
+/* Fully-fixsliced decryption function (C only, relies on the encryption round keys) */
+void aes128_decrypt_ffs(unsigned char ptext0[16], unsigned char ptext1[16],
+				const unsigned char ctext0[16], const unsigned char ctext1[16],
+				const uint32_t rkeys[88]);
+
 /* Semi-fixsliced encryption functions */
 void aes128_encrypt_sfs(unsigned char ctext0[16], unsigned char ctext1[16],
 				const unsigned char ptext0[16], const unsigned char ptext1[16],
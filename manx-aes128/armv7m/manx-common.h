@@ -173,7 +173,8 @@ static inline size_t depad_10(uint8_t *out, const uint8_t in[BLOCKBYTES])
     // copy outlen bits from input to output
     for(size_t i = 0; i < outlen/8; i++)
         out[i] = in[i];
-    out[(outlen+7)/8] = tmp & (0xff << (8-bit));
+    // the byte holding the padding bit is kept up to this bit (excluded)
+    out[outlen/8] = tmp & (0xff << (bit+1));
 
     return outlen;
 }
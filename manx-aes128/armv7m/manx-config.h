@@ -19,4 +19,17 @@
  */
 #define MANX2_ALPHAMAX 16
 
+/**
+ *  Preprocessor directive to indicate whether the decryption functions are
+ *  built. They rely on the fixsliced AES decryption, which is only available
+ *  in C (see ../armv6m/aes_decrypt.c) and not in ARMv7-M assembly yet.
+ */
+#ifndef MANX_DECRYPT
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+#define MANX_DECRYPT 0
+#else
+#define MANX_DECRYPT 1
+#endif
+#endif
+
 #endif
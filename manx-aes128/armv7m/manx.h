@@ -59,6 +59,77 @@ int manx1_enc(uint8_t c[], size_t *clen,
         enc_func  encrypt,
         kexp_func kexpand);
 
+/**
+ * @brief Authenticated encryption using Manx1-AES128, the fixsliced AES
+ * being called directly (see README.md).
+ *
+ * @param c The output ciphertext (should be at least 16-byte long)
+ * @param clen The length of the ciphertext
+ * @param k The encryption key
+ * @param n The nonce
+ * @param nlen The nonce length (in bits)
+ * @param m The message to secure
+ * @param mlen The message length (in bits)
+ * @param a The additional data to authenticate
+ * @param alen The additional data length (in bits)
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+int manx1_aes128_enc(uint8_t c[], size_t *clen,
+        const uint8_t k[],
+        const uint8_t n[], size_t nlen,
+        const uint8_t m[], size_t mlen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Authenticated encryption of two independent messages under the same
+ * key using Manx1-AES128. Both V[1] blocks are encrypted by a single call to
+ * the two-block fixsliced AES, then both V[2] blocks, so that no AES slot is
+ * wasted. The ciphertexts are the same as with manx1_aes128_enc.
+ *
+ * @param c0 The output ciphertext of the 1st message (16-byte long)
+ * @param clen0 The length of the 1st ciphertext (0 if the message is rejected)
+ * @param c1 The output ciphertext of the 2nd message (16-byte long)
+ * @param clen1 The length of the 2nd ciphertext (0 if the message is rejected)
+ * @param k The encryption key
+ * @param n0, nlen0, m0, mlen0, a0, alen0 The 1st nonce, message and AD
+ * @param n1, nlen1, m1, mlen1, a1, alen1 The 2nd nonce, message and AD
+ *
+ * @return 0 if both messages have been encrypted, the error code of the 1st
+ * rejected message otherwise (the other one being encrypted anyway)
+ */
+int manx1_aes128_enc_x2(uint8_t c0[], size_t *clen0,
+        uint8_t c1[], size_t *clen1,
+        const uint8_t k[],
+        const uint8_t n0[], size_t nlen0,
+        const uint8_t m0[], size_t mlen0,
+        const uint8_t a0[], size_t alen0,
+        const uint8_t n1[], size_t nlen1,
+        const uint8_t m1[], size_t mlen1,
+        const uint8_t a1[], size_t alen1);
+
+/**
+ * @brief Authenticated decryption using Manx1-AES128, relying on the fixsliced
+ * AES decryption (only built if MANX_DECRYPT is set, see manx-config.h).
+ *
+ * @param p The output plaintext
+ * @param plen The length of the plaintext
+ * @param k The encryption key
+ * @param n The nonce
+ * @param nlen The nonce length (in bits)
+ * @param c The ciphertext to decrypt/verify
+ * @param clen The ciphertext length (in bits)
+ * @param a The additional data
+ * @param alen The additional data length (in bits)
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+int manx1_aes128_dec(uint8_t p[], size_t *plen,
+        const uint8_t k[],
+        const uint8_t n[], size_t nlen,
+        const uint8_t c[], size_t clen,
+        const uint8_t a[], size_t alen);
+
 /**
  * @brief Authenticated decryption using Manx1.
  *
@@ -111,6 +182,42 @@ int manx2_enc(uint8_t c[], size_t *clen,
         enc_func  encrypt,
         kexp_func kexpand);
 
+/**
+ * @brief Authenticated encryption using Manx2-AES128, the fixsliced AES
+ * being called directly (see README.md). The encrypt and kexpand parameters
+ * are ignored.
+ */
+int manx2_aes128_enc(uint8_t c[], size_t *clen,
+        const uint8_t k[],
+        const uint8_t n[], size_t nlen,
+        const uint8_t m[], size_t mlen,
+        const uint8_t a[], size_t alen,
+        enc_func  encrypt,
+        kexp_func kexpand);
+
+/**
+ * @brief Authenticated decryption using Manx2-AES128, relying on the fixsliced
+ * AES decryption (only built if MANX_DECRYPT is set, see manx-config.h). Both
+ * blocks of short messages are decrypted by a single call.
+ *
+ * @param p The output plaintext
+ * @param plen The length of the plaintext
+ * @param k The encryption key
+ * @param n The nonce (optional for short messages)
+ * @param nlen The nonce length (in bits)
+ * @param c The ciphertext to decrypt/verify
+ * @param clen The ciphertext length (in bits)
+ * @param a The additional data
+ * @param alen The additional data length (in bits)
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+int manx2_aes128_dec(uint8_t p[], size_t *plen,
+        const uint8_t k[],
+        const uint8_t n[], size_t nlen,
+        const uint8_t c[], size_t clen,
+        const uint8_t a[], size_t alen);
+
 /**
  * @brief Authenticated decryption using Manx2.
  *
@@ -103,41 +103,43 @@ static inline void xor_block(uint8_t *dst, const uint8_t *src1, const uint8_t *s
     *d++ = *s1++ ^ *s2++;
 }
 
-int manx1_aes128_enc(uint8_t c[], size_t *clen,
-            const uint8_t k[],
+/**
+ * @brief Check the Manx1 parameters and build the input blocks
+ * (V[1], V[2] || pad_{n-v2}(M)) from the nonce, the AD and the message.
+ *
+ * @param v The output blocks (2*BLOCKBYTES bytes)
+ * @param n The nonce
+ * @param nlen The nonce length (in bits)
+ * @param m The message to secure
+ * @param mlen The message length (in bits)
+ * @param a The additional data to authenticate
+ * @param alen The additional data length (in bits)
+ *
+ * @return 0 if the parameters are valid, error code of manx1_aes128_enc otherwise
+ */
+static int init_blocks(uint8_t v[2*BLOCKBYTES],
             const uint8_t n[], size_t nlen,
             const uint8_t m[], size_t mlen,
             const uint8_t a[], size_t alen)
 {
     size_t  oct;
     size_t  bit;
-    uint8_t v[2*BLOCKBYTES];
-    uint8_t *v1 = v;
-    uint8_t *v2 = v + BLOCKBYTES;
     size_t  s   = MAX(BLOCKBITS - nlen + MANX_TAU , MANX1_ALPHAMAX);
 
-    roundkeys_t roundkeys;
-    aes128_keyschedule_ffs_lut(roundkeys.rk, k);
+    for (size_t i = 0; i < 2*BLOCKBYTES; i++)
+        v[i] = 0x00;
 
     // ensure that |M| < n − τ
-    if (mlen >= BLOCKBITS - MANX_TAU) {
-        *clen = 0;
+    if (mlen >= BLOCKBITS - MANX_TAU)
         return 1;
-    }
     // ensure that [AD| < α_max
-    if (alen > MANX1_ALPHAMAX) {
-        *clen = 0;
+    if (alen > MANX1_ALPHAMAX)
         return 2;
-    }
     // ensure that |M| < n - |V[2]|
-    if (mlen >= BLOCKBITS - (s - (BLOCKBITS - nlen))) {
-        *clen = 0;
+    if (mlen >= BLOCKBITS - (s - (BLOCKBITS - nlen)))
         return 3;
-    }
 
     // build (V[1],V[2]) <- vencode(N,A)
-    for (size_t i = 0; i < 2*BLOCKBYTES; i++)
-        v[i] = 0x00;
     oct = 0; // current byte position in b is set to 0
     bit = 0; // current bit position in oct is set to 0
     concat_bits(v, &oct, &bit, n, nlen);
@@ -151,6 +153,28 @@ int manx1_aes128_enc(uint8_t c[], size_t *clen,
     // append pad_{n-v2}(M) to (V[1],V[2])
     concat_bits(v, &oct, &bit, m, mlen);
     SETBIT(v[oct], 7-bit);
+    return 0;
+}
+
+int manx1_aes128_enc(uint8_t c[], size_t *clen,
+            const uint8_t k[],
+            const uint8_t n[], size_t nlen,
+            const uint8_t m[], size_t mlen,
+            const uint8_t a[], size_t alen)
+{
+    int     ret;
+    uint8_t v[2*BLOCKBYTES];
+    uint8_t *v1 = v;
+    uint8_t *v2 = v + BLOCKBYTES;
+
+    roundkeys_t roundkeys;
+    aes128_keyschedule_ffs_lut(roundkeys.rk, k);
+
+    ret = init_blocks(v, n, nlen, m, mlen, a, alen);
+    if (ret) {
+        *clen = 0;
+        return ret;
+    }
 
     // V[1] <- E_K(V[1])
     aes128_encrypt_ffs(v1, v1, v1, v1, roundkeys.rk);
@@ -162,7 +186,7 @@ int manx1_aes128_enc(uint8_t c[], size_t *clen,
     xor_block(v2, v2, v1);
 
     // C <- E_K(V[2])
-    aes128_encrypt_ffs(c, v2, c, v2, roundkeys.rk);
+    aes128_encrypt_ffs(c, c, v2, v2, roundkeys.rk);
 
     // C <- C ^ V[1]
     xor_block(c, c, v1);  
@@ -170,3 +194,120 @@ int manx1_aes128_enc(uint8_t c[], size_t *clen,
     *clen = BLOCKBITS;
     return 0;
 }
+
+int manx1_aes128_enc_x2(uint8_t c0[], size_t *clen0,
+            uint8_t c1[], size_t *clen1,
+            const uint8_t k[],
+            const uint8_t n0[], size_t nlen0,
+            const uint8_t m0[], size_t mlen0,
+            const uint8_t a0[], size_t alen0,
+            const uint8_t n1[], size_t nlen1,
+            const uint8_t m1[], size_t mlen1,
+            const uint8_t a1[], size_t alen1)
+{
+    int     ret0, ret1;
+    uint8_t v[4*BLOCKBYTES];
+    uint8_t c[2*BLOCKBYTES];
+    uint8_t *v01 = v;                   // V[1] of message 0
+    uint8_t *v02 = v + BLOCKBYTES;      // V[2] of message 0
+    uint8_t *v11 = v + 2*BLOCKBYTES;    // V[1] of message 1
+    uint8_t *v12 = v + 3*BLOCKBYTES;    // V[2] of message 1
+
+    roundkeys_t roundkeys;
+    aes128_keyschedule_ffs_lut(roundkeys.rk, k);
+
+    // a rejected message is still processed (its blocks being valid), only
+    // its ciphertext is discarded
+    ret0 = init_blocks(v, n0, nlen0, m0, mlen0, a0, alen0);
+    ret1 = init_blocks(v + 2*BLOCKBYTES, n1, nlen1, m1, mlen1, a1, alen1);
+
+    // V[1] <- E_K(V[1]) for both messages
+    aes128_encrypt_ffs(v01, v11, v01, v11, roundkeys.rk);
+
+    // V[1] <- 2V[1]
+    doubling(v01);
+    doubling(v11);
+
+    // V[2] <- V[1] ^ (V[2] || pad_{n-v2}(M))
+    xor_block(v02, v02, v01);
+    xor_block(v12, v12, v11);
+
+    // C <- E_K(V[2]) ^ V[1] for both messages
+    aes128_encrypt_ffs(c, c + BLOCKBYTES, v02, v12, roundkeys.rk);
+    xor_block(c, c, v01);
+    xor_block(c + BLOCKBYTES, c + BLOCKBYTES, v11);
+
+    *clen0 = 0;
+    *clen1 = 0;
+    if (!ret0) {
+        for (size_t i = 0; i < BLOCKBYTES; i++)
+            c0[i] = c[i];
+        *clen0 = BLOCKBITS;
+    }
+    if (!ret1) {
+        for (size_t i = 0; i < BLOCKBYTES; i++)
+            c1[i] = c[BLOCKBYTES + i];
+        *clen1 = BLOCKBITS;
+    }
+    return ret0 ? ret0 : ret1;
+}
+
+#if MANX_DECRYPT
+int manx1_aes128_dec(uint8_t p[], size_t *plen,
+            const uint8_t k[],
+            const uint8_t n[], size_t nlen,
+            const uint8_t c[], size_t clen,
+            const uint8_t a[], size_t alen)
+{
+    size_t  v2len;
+    uint8_t v2_tilde[BLOCKBYTES];
+    uint8_t v[2*BLOCKBYTES];
+    uint8_t *v1 = v;
+    uint8_t *v2 = v + BLOCKBYTES;
+
+    roundkeys_t roundkeys;
+    aes128_keyschedule_ffs_lut(roundkeys.rk, k);
+
+    v2len = MAX(BLOCKBITS - nlen + MANX_TAU, MANX1_ALPHAMAX) - (BLOCKBITS - nlen);
+
+    // ensure that the |C| = n
+    if (clen != BLOCKBITS) {
+        *plen = 0;
+        return 1;
+    }
+    // build (V[1],V[2]) <- vencode(N,A), ensuring that |AD| < α_max
+    if (init_blocks(v, n, nlen, NULL, 0, a, alen)) {
+        *plen = 0;
+        return 2;
+    }
+
+    // S <- E_K(V[1])
+    aes128_encrypt_ffs(v1, v1, v1, v1, roundkeys.rk);
+
+    // S <- 2S
+    doubling(v1);
+
+    // \tilde{v2} <- E_K^{-1}(S ^ C) ^ S
+    for (size_t i = 0; i < BLOCKBYTES; i++)
+        v2_tilde[i] = v1[i] ^ c[i];
+    aes128_decrypt_ffs(v2_tilde, v2_tilde, v2_tilde, v2_tilde, roundkeys.rk);
+    xor_block(v2_tilde, v2_tilde, v1);
+
+    // ensure v2 = \tilde{v2}
+    if (sec_memcmp_bits(v2, v2_tilde, v2len)) {
+        *plen = 0;
+        return 3;
+    }
+
+    // depad plaintext
+    *plen = depad_10(v2_tilde, v2_tilde);
+    if (*plen < v2len) {
+        *plen = 0;
+        return 3;
+    }
+    *plen -= v2len;
+    lshift(p, v2_tilde + (v2len/8), *plen, v2len%8);
+
+    return 0;
+}
+#endif
@@ -75,7 +75,8 @@ static void init_tiny_msg(uint8_t b[],
     inc_bitpos(&oct, &bit, MANX2_ALPHASTAR - alen);
 #endif
     concat_bits(b, &oct, &bit, m, mlen);           // b <- N || xx || \bar{A} || M
-    SETBIT(b[oct], 7-bit);                         // b <- N || xx || \bar{A} || pad_r(M)
+    if (mlen < r)                                  // no padding if |M| = r
+        SETBIT(b[oct], 7-bit);                     // b <- N || xx || \bar{A} || pad_r(M)
 }
 
 static void init_short_msg(uint8_t b[],
@@ -134,6 +135,9 @@ int manx2_aes128_enc(uint8_t c[], size_t *clen,
     size_t r = BLOCKBITS - (nlen + MANX2_ALPHASTAR + 2);
     roundkeys_t roundkeys;
 
+    (void) encrypt; // the fixsliced AES is called directly, two blocks at a time
+    (void) kexpand;
+
     // nlen has to be >= TAU to ensure BLOCKBITS/2-bit privacy and TAU-bit authenticity
     if (nlen < MANX_TAU) {
         *clen = 0;
@@ -170,3 +174,89 @@ int manx2_aes128_enc(uint8_t c[], size_t *clen,
 
     return 0;
 }
+
+#if MANX_DECRYPT
+int manx2_aes128_dec(uint8_t p[], size_t *plen,
+            const uint8_t k[],
+            const uint8_t n[], size_t nlen,
+            const uint8_t c[], size_t clen,
+            const uint8_t a[], size_t alen)
+{
+    size_t  r = BLOCKBITS - (nlen + MANX2_ALPHASTAR + 2);
+    size_t  hlen = nlen + 2 + MANX2_ALPHASTAR; // |N || xx || \bar{A}|
+    uint8_t t[BLOCKBYTES];  // expected header
+    uint8_t s1[BLOCKBYTES];
+    uint8_t s2[BLOCKBYTES];
+    uint8_t ds;
+    size_t  oct;
+    size_t  bit;
+    size_t  len;
+    roundkeys_t roundkeys;
+
+    if (clen != BLOCKBITS && clen != 2*BLOCKBITS) {
+        *plen = 0;
+        return 1;
+    }
+
+    // precomputes the round keys
+    aes128_keyschedule_ffs_lut(roundkeys.rk, k);
+
+    // in case of tiny message
+    if (clen == BLOCKBITS) {
+        aes128_decrypt_ffs(s1, s1, c, c, roundkeys.rk);
+        init_tiny_msg(t, n, nlen, a, alen, c, 0);
+        ds = GETBIT(s1[(nlen+1)/8], 7-((nlen+1)%8));
+        CHGBIT(t[(nlen+1)/8], 7-((nlen+1)%8), ds);
+
+        // ensures \tilde{N} == N && \tilde{b} == 1x && \tilde{A} == \bar{A}
+        if (sec_memcmp_bits(s1, t, hlen)) {
+            *plen = 0;
+            return 2;
+        }
+
+        len = ds ? BLOCKBITS : depad_10(s1, s1);
+        if (len < hlen) {
+            *plen = 0;
+            return 2;
+        }
+        *plen = len - hlen;
+        lshift(p, s1 + hlen/8, *plen, hlen%8);
+    }
+    // in case of short message, both blocks are decrypted at once
+    else {
+        (void) n; // nonce is not required for decryption in case of short messages
+        aes128_decrypt_ffs(s1, s2, c, c + BLOCKBYTES, roundkeys.rk);
+
+        init_tiny_msg(t, s2, nlen, a, alen, c, 0);
+        CLRBIT(t[(nlen+1)/8], 7-((nlen+1)%8));
+        CLRBIT(t[nlen/8], 7-(nlen%8));
+
+        // ensures \tilde{N}[1] == \tilde{N}[2] && \tilde{b}[1] == 00 && \tilde{A} == \bar{A}
+        if (sec_memcmp_bits(s1, t, hlen)) {
+            *plen = 0;
+            return 3;
+        }
+        // ensures \tilde{b}[2] == 01
+        if (GETBIT(s2[nlen/8], 7-(nlen%8)) != 0 || GETBIT(s2[(nlen+1)/8], 7-((nlen+1)%8)) != 1) {
+            *plen = 0;
+            return 4;
+        }
+        len = depad_10(s2, s2);
+        if (len < nlen + 2) {
+            *plen = 0;
+            return 4;
+        }
+
+        // M <- \tilde{M}[1] || depad_{r'}(\tilde{M}[2])
+        lshift(p, s1 + hlen/8, r, hlen%8);
+        oct = r / 8;
+        bit = r % 8;
+        len -= nlen + 2;
+        lshift(s2, s2 + (nlen + 2)/8, len, (nlen + 2)%8);
+        concat_bits(p, &oct, &bit, s2, len);
+        *plen = r + len;
+    }
+
+    return 0;
+}
+#endif
@@ -0,0 +1 @@
+../../manx/manx-ctx.c
\ No newline at end of file
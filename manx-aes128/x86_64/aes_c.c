@@ -0,0 +1,387 @@
+#include "block_cipher.h"
+
+/**
+ * Portable and constant-time AES-128 in C, used when AES-NI is not available.
+ * The round keys follow the same layout as the AES-NI ones (i.e. the standard
+ * expanded key), so that both implementations can be used interchangeably.
+ * The S-box is computed with the bitsliced circuit from Boyar, Peralta and
+ * Calik (see ../armv6m/aes_encrypt.c), on 32 bytes at a time (i.e. 2 blocks)
+ * while the linear layers are computed on bytes without any table lookup.
+ */
+
+#define SWAPMOVE64(x, mask, n) do {                                           \
+    uint64_t t = ((x) ^ ((x) >> (n))) & (mask);                               \
+    (x) ^= t ^ (t << (n));                                                    \
+  } while (0)
+
+/**
+ * Transpose the 8x8 bit matrix x whose rows are bytes (involution).
+ */
+static inline uint64_t transpose8(uint64_t x)
+{
+  SWAPMOVE64(x, 0x00aa00aa00aa00aaULL, 7);
+  SWAPMOVE64(x, 0x0000cccc0000ccccULL, 14);
+  SWAPMOVE64(x, 0x00000000f0f0f0f0ULL, 28);
+  return x;
+}
+
+/**
+ * Bitsliced AES S-box based on Boyar, Peralta and Calik.
+ * See http://www.cs.yale.edu/homes/peralta/CircuitStuff/SLP_AES_113.txt
+ * state[i] holds the bit 7-i of 32 bytes.
+ */
+static void sbox(uint32_t* state)
+{
+  uint32_t t0, t1, t2, t3, t4, t5,
+    t6, t7, t8, t9, t10, t11, t12,
+    t13, t14, t15, t16, t17;
+  t0       = state[3] ^ state[5];
+  t1       = state[0] ^ state[6];
+  t2       = t1 ^ t0;
+  t3       = state[4] ^ t2;
+  t4       = t3 ^ state[5];
+  t5       = t2 & t4;
+  t6       = t4 ^ state[7];
+  t7       = t3 ^ state[1];
+  t8       = state[0] ^ state[3];
+  t9       = t7 ^ t8;
+  t10      = t8 & t9;
+  t11      = state[7] ^ t9;
+  t12      = state[0] ^ state[5];
+  t13      = state[1] ^ state[2];
+  t14      = t4 ^ t13;
+  t15      = t14 ^ t9;
+  t16      = t0 & t15;
+  t17      = t16 ^ t10;
+  state[1] = t14 ^ t12;
+  state[2] = t12 & t14;
+  state[2] ^= t10;
+  state[4] = t13 ^ t9;
+  state[5] = t1 ^ state[4];
+  t3       = t1 & state[4];
+  t10      = state[0] ^ state[4];
+  t13      ^= state[7];
+  state[3] ^= t13;
+  t16      = state[3] & state[7];
+  t16      ^= t5;
+  t16      ^= state[2];
+  state[1] ^= t16;
+  state[0] ^= t13;
+  t16      = state[0] & t11;
+  t16      ^= t3;
+  state[2] ^= t16;
+  state[2] ^= t10;
+  state[6] ^= t13;
+  t10      = state[6] & t13;
+  t3       ^= t10;
+  t3       ^= t17;
+  state[5] ^= t3;
+  t3       = state[6] ^ t12;
+  t10      = t3 & t6;
+  t5       ^= t10;
+  t5       ^= t7;
+  t5       ^= t17;
+  t7       = t5 & state[5];
+  t10      = state[2] ^ t7;
+  t7       ^= state[1];
+  t5       ^= state[1];
+  t16      = t5 & t10;
+  state[1] ^= t16;
+  t17      = state[1] & state[0];
+  t11      = state[1] & t11;
+  t16      = state[5] ^ state[2];
+  t7       &= t16;
+  t7       ^= state[2];
+  t16      = t10 ^ t7;
+  state[2] &= t16;
+  t10      ^= state[2];
+  t10      &= state[1];
+  t5       ^= t10;
+  t10      = state[1] ^ t5;
+  state[4] &= t10;
+  t11      ^= state[4];
+  t1       &= t10;
+  state[6] &= t5;
+  t10      = t5 & t13;
+  state[4] ^= t10;
+  state[5] ^= t7;
+  state[2] ^= state[5];
+  state[5] = t5 ^ state[2];
+  t5       = state[5] & t14;
+  t10      = state[5] & t12;
+  t12      = t7 ^ state[2];
+  t4       &= t12;
+  t2       &= t12;
+  t3       &= state[2];
+  state[2] &= t6;
+  state[2] ^= t4;
+  t13      = state[4] ^ state[2];
+  state[3] &= t7;
+  state[1] ^= t7;
+  state[5] ^= state[1];
+  t6       = state[5] & t15;
+  state[4] ^= t6;
+  t0       &= state[5];
+  state[5] = state[1] & t9;
+  state[5] ^= state[4];
+  state[1] &= t8;
+  t6       = state[1] ^ state[5];
+  t0       ^= state[1];
+  state[1] = t3 ^ t0;
+  t15      = state[1] ^ state[3];
+  t2       ^= state[1];
+  state[0] = t2 ^ state[5];
+  state[3] = t2 ^ t13;
+  state[1] = state[3] ^ state[5];
+  state[1] ^= 0xffffffff;
+  t0       ^= state[6];
+  state[5] = t7 & state[7];
+  t14      = t4 ^ state[5];
+  state[6] = t1 ^ t14;
+  state[6] ^= t5;
+  state[6] ^= state[4];
+  state[2] = t17 ^ state[6];
+  state[5] = t15 ^ state[2];
+  state[2] ^= t6;
+  state[2] ^= t10;
+  state[2] ^= 0xffffffff;
+  t14      ^= t11;
+  t0       ^= t14;
+  state[6] ^= t0;
+  state[6] ^= 0xffffffff;
+  state[7] = t1 ^ t0;
+  state[7] ^= 0xffffffff;
+  state[4] = t14 ^ state[3];
+}
+
+/**
+ * Apply the S-box to 32 bytes.
+ */
+static void subbytes(uint8_t b[32])
+{
+  uint32_t state[8] = {0};
+  uint64_t x;
+  int      i, j;
+
+  for(j = 0; j < 4; j++) {
+    x = 0;
+    for(i = 0; i < 8; i++)
+      x |= (uint64_t)b[8*j + i] << (8*i);
+    x = transpose8(x);
+    for(i = 0; i < 8; i++)
+      state[7-i] |= (uint32_t)((x >> (8*i)) & 0xff) << (8*j);
+  }
+  sbox(state);
+  for(j = 0; j < 4; j++) {
+    x = 0;
+    for(i = 0; i < 8; i++)
+      x |= (uint64_t)((state[7-i] >> (8*j)) & 0xff) << (8*i);
+    x = transpose8(x);
+    for(i = 0; i < 8; i++)
+      b[8*j + i] = (x >> (8*i)) & 0xff;
+  }
+}
+
+/**
+ * Linear part of the inverse of the S-box affine transformation.
+ */
+static inline uint8_t affine_inv(uint8_t x)
+{
+  return ((x << 1) | (x >> 7)) ^ ((x << 3) | (x >> 5)) ^ ((x << 6) | (x >> 2));
+}
+
+/**
+ * Apply the inverse S-box to 32 bytes, relying on the fact that
+ * InvSbox(x) = L^-1(Sbox(L^-1(x ^ 0x63)) ^ 0x63) where L is the linear part
+ * of the S-box affine transformation.
+ */
+static void inv_subbytes(uint8_t b[32])
+{
+  int i;
+  for(i = 0; i < 32; i++)
+    b[i] = affine_inv(b[i] ^ 0x63);
+  subbytes(b);
+  for(i = 0; i < 32; i++)
+    b[i] = affine_inv(b[i] ^ 0x63);
+}
+
+static inline uint8_t xtime(uint8_t x)
+{
+  return (x << 1) ^ (0x1b & -(x >> 7));
+}
+
+static void shiftrows(uint8_t b[BLOCKBYTES])
+{
+  uint8_t t[BLOCKBYTES];
+  int     c, r;
+  for(c = 0; c < 4; c++)
+    for(r = 0; r < 4; r++)
+      t[4*c + r] = b[4*((c + r) % 4) + r];
+  for(c = 0; c < BLOCKBYTES; c++)
+    b[c] = t[c];
+}
+
+static void inv_shiftrows(uint8_t b[BLOCKBYTES])
+{
+  uint8_t t[BLOCKBYTES];
+  int     c, r;
+  for(c = 0; c < 4; c++)
+    for(r = 0; r < 4; r++)
+      t[4*((c + r) % 4) + r] = b[4*c + r];
+  for(c = 0; c < BLOCKBYTES; c++)
+    b[c] = t[c];
+}
+
+static void mixcolumns(uint8_t b[BLOCKBYTES])
+{
+  uint8_t a0, a1, a2, a3, t;
+  int     c;
+  for(c = 0; c < BLOCKBYTES; c += 4) {
+    a0 = b[c]; a1 = b[c+1]; a2 = b[c+2]; a3 = b[c+3];
+    t = a0 ^ a1 ^ a2 ^ a3;
+    b[c]   = a0 ^ t ^ xtime(a0 ^ a1);
+    b[c+1] = a1 ^ t ^ xtime(a1 ^ a2);
+    b[c+2] = a2 ^ t ^ xtime(a2 ^ a3);
+    b[c+3] = a3 ^ t ^ xtime(a3 ^ a0);
+  }
+}
+
+/**
+ * InvMixColumns as MixColumns preceded by the multiplication by 4x^2 + 5.
+ */
+static void inv_mixcolumns(uint8_t b[BLOCKBYTES])
+{
+  uint8_t u, v;
+  int     c;
+  for(c = 0; c < BLOCKBYTES; c += 4) {
+    u = xtime(xtime(b[c] ^ b[c+2]));
+    v = xtime(xtime(b[c+1] ^ b[c+3]));
+    b[c] ^= u; b[c+1] ^= v; b[c+2] ^= u; b[c+3] ^= v;
+  }
+  mixcolumns(b);
+}
+
+static inline void ark(uint8_t b[BLOCKBYTES], const uint8_t rkey[BLOCKBYTES])
+{
+  int i;
+  for(i = 0; i < BLOCKBYTES; i++)
+    b[i] ^= rkey[i];
+}
+
+void aes128_kexp_c(roundkeys_t* roundkeys, const unsigned char key[KEYBYTES])
+{
+  static const uint8_t rcon[10] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36};
+  uint8_t* rk = (uint8_t*)roundkeys->rk;
+  uint8_t  t[32] = {0};
+  int      i, j;
+
+  for(i = 0; i < KEYBYTES; i++)
+    rk[i] = key[i];
+  for(i = 1; i < 11; i++) {
+    // SubWord(RotWord(w[4i-1])) ^ Rcon[i]
+    for(j = 0; j < 4; j++)
+      t[j] = rk[16*i - 4 + (j + 1) % 4];
+    subbytes(t);
+    t[0] ^= rcon[i-1];
+    for(j = 0; j < 4; j++)
+      rk[16*i + j] = rk[16*i - 16 + j] ^ t[j];
+    for(j = 4; j < 16; j++)
+      rk[16*i + j] = rk[16*i - 16 + j] ^ rk[16*i + j - 4];
+  }
+}
+
+void aes128_kexp_inv_c(roundkeys_t* roundkeys_inv, const roundkeys_t* roundkeys)
+{
+  const uint8_t* rk  = (const uint8_t*)roundkeys->rk;
+  uint8_t*       irk = (uint8_t*)roundkeys_inv->rk;
+  int            i, j;
+
+  for(i = 0; i < 11; i++) {
+    for(j = 0; j < BLOCKBYTES; j++)
+      irk[BLOCKBYTES*i + j] = rk[BLOCKBYTES*(10-i) + j];
+    if (i > 0 && i < 10)
+      inv_mixcolumns(irk + BLOCKBYTES*i);
+  }
+}
+
+/**
+ * Encrypt 2 blocks held in b with the round keys rk.
+ */
+static void encrypt_x2(uint8_t b[2*BLOCKBYTES], const uint8_t* rk)
+{
+  int r;
+  ark(b, rk);
+  ark(b + BLOCKBYTES, rk);
+  for(r = 1; r < 11; r++) {
+    subbytes(b);
+    shiftrows(b);
+    shiftrows(b + BLOCKBYTES);
+    if (r < 10) {
+      mixcolumns(b);
+      mixcolumns(b + BLOCKBYTES);
+    }
+    ark(b, rk + BLOCKBYTES*r);
+    ark(b + BLOCKBYTES, rk + BLOCKBYTES*r);
+  }
+}
+
+/**
+ * Decrypt 2 blocks held in b with the equivalent inverse cipher round keys rk.
+ */
+static void decrypt_x2(uint8_t b[2*BLOCKBYTES], const uint8_t* rk)
+{
+  int r;
+  ark(b, rk);
+  ark(b + BLOCKBYTES, rk);
+  for(r = 1; r < 11; r++) {
+    inv_subbytes(b);
+    inv_shiftrows(b);
+    inv_shiftrows(b + BLOCKBYTES);
+    if (r < 10) {
+      inv_mixcolumns(b);
+      inv_mixcolumns(b + BLOCKBYTES);
+    }
+    ark(b, rk + BLOCKBYTES*r);
+    ark(b + BLOCKBYTES, rk + BLOCKBYTES*r);
+  }
+}
+
+void aes128_enc_c(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys)
+{
+  aes128_enc_blocks_c(out, in, 1, roundkeys);
+}
+
+void aes128_dec_inv_c(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys_inv)
+{
+  aes128_dec_inv_blocks_c(out, in, 1, roundkeys_inv);
+}
+
+void aes128_enc_blocks_c(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys)
+{
+  uint8_t b[2*BLOCKBYTES] = {0};
+  size_t  i, n;
+
+  for(; nblocks > 0; nblocks -= n, in += n*BLOCKBYTES, out += n*BLOCKBYTES) {
+    n = (nblocks > 1) ? 2 : 1;
+    for(i = 0; i < n*BLOCKBYTES; i++)
+      b[i] = in[i];
+    encrypt_x2(b, (const uint8_t*)roundkeys->rk);
+    for(i = 0; i < n*BLOCKBYTES; i++)
+      out[i] = b[i];
+  }
+}
+
+void aes128_dec_inv_blocks_c(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys_inv)
+{
+  uint8_t b[2*BLOCKBYTES] = {0};
+  size_t  i, n;
+
+  for(; nblocks > 0; nblocks -= n, in += n*BLOCKBYTES, out += n*BLOCKBYTES) {
+    n = (nblocks > 1) ? 2 : 1;
+    for(i = 0; i < n*BLOCKBYTES; i++)
+      b[i] = in[i];
+    decrypt_x2(b, (const uint8_t*)roundkeys_inv->rk);
+    for(i = 0; i < n*BLOCKBYTES; i++)
+      out[i] = b[i];
+  }
+}
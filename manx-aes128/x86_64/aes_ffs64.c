@@ -0,0 +1,590 @@
+#include <string.h>
+#include "block_cipher.h"
+
+/**
+ * Portable and constant-time AES-128 encryption in C relying on 64-bit
+ * fixslicing, for hosts without AES-NI. This is a port of the fully-fixsliced
+ * implementation processing 2 blocks in 32-bit words (see
+ * ../armv6m/aes_encrypt.c and https://eprint.iacr.org/2020/1123.pdf) to 4
+ * blocks in 64-bit words.
+ *
+ * The 512-bit internal state is made of 8 words, state[i] holding the bit i
+ * of each byte of the 4 blocks. Each 16-bit chunk of a word corresponds to a
+ * row of the AES state, 4 consecutive bits within a chunk holding a column of
+ * the 4 blocks. Compared to the 32-bit representation (8-bit rows, 2 bits per
+ * column), rotating the rows (resp. the columns) thus translates into 16-bit
+ * word rotations (resp. 4-bit rotations within each chunk).
+ *
+ * The round keys are derived from the standard expanded key by
+ * aes128_kexp_ffs64 and stored compacted in the rk member of roundkeys_t (see
+ * rkey_compact), so that a key takes no more memory than with the other
+ * implementations. The decryption relies on aes128_dec_inv_c, with the round
+ * keys derived from the key recovered by aes128_kexp_inv_ffs64.
+ */
+
+#define ROR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define ROR64(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+/**
+ * Rotate each 16-bit row by 1, 2 or 3 columns (i.e. 4, 8 or 12 bits).
+ */
+#define ROW_ROR_4(x)                                                          \
+  ((((x) >> 4) & 0x0fff0fff0fff0fffULL) | (((x) & 0x000f000f000f000fULL) << 12))
+#define ROW_ROR_8(x)                                                          \
+  ((((x) >> 8) & 0x00ff00ff00ff00ffULL) | (((x) & 0x00ff00ff00ff00ffULL) << 8))
+#define ROW_ROR_12(x)                                                         \
+  ((((x) >> 12) & 0x000f000f000f000fULL) | (((x) & 0x0fff0fff0fff0fffULL) << 4))
+
+#define SWAPMOVE(a, b, mask, n) do {                                          \
+    uint32_t t = ((b) ^ ((a) >> (n))) & (mask);                               \
+    (b) ^= t;                                                                 \
+    (a) ^= t << (n);                                                          \
+  } while (0)
+
+#define LE_LOAD_32(x)                                                         \
+  (((uint32_t)(x)[3] << 24) | ((uint32_t)(x)[2] << 16) |                      \
+   ((uint32_t)(x)[1] << 8) | (uint32_t)(x)[0])
+
+/**
+ * Spread the 16 pairs of bits of a 32-bit word to every other nibble, i.e.
+ * the bits 2k, 2k+1 are moved to the bits 4k, 4k+1.
+ */
+static inline uint64_t spread(uint32_t x)
+{
+  uint64_t y = x;
+  y = (y | (y << 16)) & 0x0000ffff0000ffffULL;
+  y = (y | (y << 8))  & 0x00ff00ff00ff00ffULL;
+  y = (y | (y << 4))  & 0x0f0f0f0f0f0f0f0fULL;
+  y = (y | (y << 2))  & 0x3333333333333333ULL;
+  return y;
+}
+
+/**
+ * Inverse of spread (the bits 4k+2, 4k+3 are ignored).
+ */
+static inline uint32_t compact(uint64_t y)
+{
+  y &= 0x3333333333333333ULL;
+  y = (y | (y >> 2))  & 0x0f0f0f0f0f0f0f0fULL;
+  y = (y | (y >> 4))  & 0x00ff00ff00ff00ffULL;
+  y = (y | (y >> 8))  & 0x0000ffff0000ffffULL;
+  y = (y | (y >> 16)) & 0x00000000ffffffffULL;
+  return (uint32_t)y;
+}
+
+/**
+ * Pack 2 blocks into the 32-bit fixsliced representation (same as packing
+ * in ../armv6m/aes_encrypt.c).
+ */
+static void packing32(uint32_t out[8], const unsigned char* in0, const unsigned char* in1)
+{
+  int i;
+  for(i = 0; i < 4; i++) {
+    out[2*i]   = LE_LOAD_32(in0 + 4*i);
+    out[2*i+1] = LE_LOAD_32(in1 + 4*i);
+  }
+  for(i = 0; i < 8; i += 2)
+    SWAPMOVE(out[i+1], out[i], 0x55555555, 1);
+  for(i = 0; i < 8; i += 4) {
+    SWAPMOVE(out[i+2], out[i], 0x33333333, 2);
+    SWAPMOVE(out[i+3], out[i+1], 0x33333333, 2);
+  }
+  for(i = 0; i < 4; i++)
+    SWAPMOVE(out[i+4], out[i], 0x0f0f0f0f, 4);
+}
+
+/**
+ * Inverse of packing32.
+ */
+static void unpacking32(unsigned char* out0, unsigned char* out1, uint32_t in[8])
+{
+  int i, j;
+  for(i = 0; i < 4; i++)
+    SWAPMOVE(in[i+4], in[i], 0x0f0f0f0f, 4);
+  for(i = 0; i < 8; i += 4) {
+    SWAPMOVE(in[i+2], in[i], 0x33333333, 2);
+    SWAPMOVE(in[i+3], in[i+1], 0x33333333, 2);
+  }
+  for(i = 0; i < 8; i += 2)
+    SWAPMOVE(in[i+1], in[i], 0x55555555, 1);
+  for(i = 0; i < 4; i++) {
+    for(j = 0; j < 4; j++) {
+      out0[4*i+j] = (in[2*i] >> (8*j)) & 0xff;
+      out1[4*i+j] = (in[2*i+1] >> (8*j)) & 0xff;
+    }
+  }
+}
+
+/**
+ * Pack 4 contiguous blocks into the 64-bit fixsliced representation: the
+ * blocks are packed by pairs in the 32-bit representation, whose columns
+ * (pairs of bits) are then interleaved.
+ */
+static void packing(uint64_t state[8], const unsigned char in[4*BLOCKBYTES])
+{
+  uint32_t s01[8], s23[8];
+  int      i;
+  packing32(s01, in, in + BLOCKBYTES);
+  packing32(s23, in + 2*BLOCKBYTES, in + 3*BLOCKBYTES);
+  for(i = 0; i < 8; i++)
+    state[i] = spread(s01[i]) | (spread(s23[i]) << 2);
+}
+
+/**
+ * Unpack the 64-bit internal state into 4 contiguous blocks.
+ */
+static void unpacking(unsigned char out[4*BLOCKBYTES], const uint64_t state[8])
+{
+  uint32_t s01[8], s23[8];
+  int      i;
+  for(i = 0; i < 8; i++) {
+    s01[i] = compact(state[i]);
+    s23[i] = compact(state[i] >> 2);
+  }
+  unpacking32(out, out + BLOCKBYTES, s01);
+  unpacking32(out + 2*BLOCKBYTES, out + 3*BLOCKBYTES, s23);
+}
+
+/**
+ * The key being the same for the 4 blocks, each nibble (i.e. a column of the
+ * 4 blocks) of a fixsliced round key word is either 0x0 or 0xf: the word is
+ * stored as a 16-bit word made of the bits 4k, so that the 8 words of a round
+ * key fit in one rk[i] (176 bytes in all, instead of 704).
+ */
+static inline uint16_t rkey_compact(uint64_t y)
+{
+  y &= 0x1111111111111111ULL;
+  y = (y | (y >> 3))  & 0x0303030303030303ULL;
+  y = (y | (y >> 6))  & 0x000f000f000f000fULL;
+  y = (y | (y >> 12)) & 0x000000ff000000ffULL;
+  y = (y | (y >> 24)) & 0x000000000000ffffULL;
+  return (uint16_t)y;
+}
+
+/**
+ * Inverse of rkey_compact, each bit k being copied to the nibble k.
+ */
+static inline uint64_t rkey_expand(uint16_t x)
+{
+  uint64_t y = x;
+  y = (y | (y << 24)) & 0x000000ff000000ffULL;
+  y = (y | (y << 12)) & 0x000f000f000f000fULL;
+  y = (y | (y << 6))  & 0x0303030303030303ULL;
+  y = (y | (y << 3))  & 0x1111111111111111ULL;
+  return (y << 4) - y;
+}
+
+/**
+ * Expand the 11 compacted round keys, once per call to the encryption.
+ */
+static void rkeys_expand(uint64_t rkeys[88], const roundkeys_t* roundkeys)
+{
+  uint16_t k[8];
+  int      i, j;
+  for(i = 0; i < 11; i++) {
+    memcpy(k, &roundkeys->rk[i], sizeof(k));
+    for(j = 0; j < 8; j++)
+      rkeys[8*i + j] = rkey_expand(k[j]);
+  }
+}
+
+/**
+ * XOR the round key (in the fixsliced representation) to the internal state.
+ */
+static inline void ark(uint64_t state[8], const uint64_t rkey[8])
+{
+  int i;
+  for(i = 0; i < 8; i++)
+    state[i] ^= rkey[i];
+}
+
+/**
+ * Bitsliced AES S-box based on Boyar, Peralta and Calik.
+ * See http://www.cs.yale.edu/homes/peralta/CircuitStuff/SLP_AES_113.txt
+ * Note that the 4 NOT (^= 0xffffffffffffffff) are moved to the key schedule.
+ */
+static inline void sbox(uint64_t state[8])
+{
+  uint64_t t0, t1, t2, t3, t4, t5,
+    t6, t7, t8, t9, t10, t11, t12,
+    t13, t14, t15, t16, t17;
+  t0       = state[3] ^ state[5];
+  t1       = state[0] ^ state[6];
+  t2       = t1 ^ t0;
+  t3       = state[4] ^ t2;
+  t4       = t3 ^ state[5];
+  t5       = t2 & t4;
+  t6       = t4 ^ state[7];
+  t7       = t3 ^ state[1];
+  t8       = state[0] ^ state[3];
+  t9       = t7 ^ t8;
+  t10      = t8 & t9;
+  t11      = state[7] ^ t9;
+  t12      = state[0] ^ state[5];
+  t13      = state[1] ^ state[2];
+  t14      = t4 ^ t13;
+  t15      = t14 ^ t9;
+  t16      = t0 & t15;
+  t17      = t16 ^ t10;
+  state[1] = t14 ^ t12;
+  state[2] = t12 & t14;
+  state[2] ^= t10;
+  state[4] = t13 ^ t9;
+  state[5] = t1 ^ state[4];
+  t3       = t1 & state[4];
+  t10      = state[0] ^ state[4];
+  t13      ^= state[7];
+  state[3] ^= t13;
+  t16      = state[3] & state[7];
+  t16      ^= t5;
+  t16      ^= state[2];
+  state[1] ^= t16;
+  state[0] ^= t13;
+  t16      = state[0] & t11;
+  t16      ^= t3;
+  state[2] ^= t16;
+  state[2] ^= t10;
+  state[6] ^= t13;
+  t10      = state[6] & t13;
+  t3       ^= t10;
+  t3       ^= t17;
+  state[5] ^= t3;
+  t3       = state[6] ^ t12;
+  t10      = t3 & t6;
+  t5       ^= t10;
+  t5       ^= t7;
+  t5       ^= t17;
+  t7       = t5 & state[5];
+  t10      = state[2] ^ t7;
+  t7       ^= state[1];
+  t5       ^= state[1];
+  t16      = t5 & t10;
+  state[1] ^= t16;
+  t17      = state[1] & state[0];
+  t11      = state[1] & t11;
+  t16      = state[5] ^ state[2];
+  t7       &= t16;
+  t7       ^= state[2];
+  t16      = t10 ^ t7;
+  state[2] &= t16;
+  t10      ^= state[2];
+  t10      &= state[1];
+  t5       ^= t10;
+  t10      = state[1] ^ t5;
+  state[4] &= t10;
+  t11      ^= state[4];
+  t1       &= t10;
+  state[6] &= t5;
+  t10      = t5 & t13;
+  state[4] ^= t10;
+  state[5] ^= t7;
+  state[2] ^= state[5];
+  state[5] = t5 ^ state[2];
+  t5       = state[5] & t14;
+  t10      = state[5] & t12;
+  t12      = t7 ^ state[2];
+  t4       &= t12;
+  t2       &= t12;
+  t3       &= state[2];
+  state[2] &= t6;
+  state[2] ^= t4;
+  t13      = state[4] ^ state[2];
+  state[3] &= t7;
+  state[1] ^= t7;
+  state[5] ^= state[1];
+  t6       = state[5] & t15;
+  state[4] ^= t6;
+  t0       &= state[5];
+  state[5] = state[1] & t9;
+  state[5] ^= state[4];
+  state[1] &= t8;
+  t6       = state[1] ^ state[5];
+  t0       ^= state[1];
+  state[1] = t3 ^ t0;
+  t15      = state[1] ^ state[3];
+  t2       ^= state[1];
+  state[0] = t2 ^ state[5];
+  state[3] = t2 ^ t13;
+  state[1] = state[3] ^ state[5];
+  t0       ^= state[6];
+  state[5] = t7 & state[7];
+  t14      = t4 ^ state[5];
+  state[6] = t1 ^ t14;
+  state[6] ^= t5;
+  state[6] ^= state[4];
+  state[2] = t17 ^ state[6];
+  state[5] = t15 ^ state[2];
+  state[2] ^= t6;
+  state[2] ^= t10;
+  t14      ^= t11;
+  t0       ^= t14;
+  state[6] ^= t0;
+  state[7] = t1 ^ t0;
+  state[4] = t14 ^ state[3];
+}
+
+/**
+ * Apply the ShiftRows transformation twice (i.e. SR^2) on the internal state,
+ * i.e. rotate the rows 1 and 3 by 2 columns.
+ */
+static inline void double_shiftrows(uint64_t state[8])
+{
+  int i;
+  for(i = 0; i < 8; i++) {
+    uint64_t t = (state[i] ^ (state[i] >> 8)) & 0x00ff000000ff0000ULL;
+    state[i] ^= t ^ (t << 8);
+  }
+}
+
+/**
+ * MixColumns in the fixsliced representation, for rounds i s.t. (i%4) == 0.
+ */
+static inline void mixcolumns_0(uint64_t state[8])
+{
+  uint64_t t0, t1, t2, t3, t4;
+  t3 = ROR64(ROW_ROR_12(state[0]), 16);
+  t0 = state[0] ^ t3;
+  t1 = ROR64(ROW_ROR_12(state[7]), 16);
+  t2 = state[7] ^ t1;
+  state[7] = ROR64(ROW_ROR_8(t2), 32) ^ t1 ^ t0;
+  t1 = ROR64(ROW_ROR_12(state[6]), 16);
+  t4 = t1 ^ state[6];
+  state[6] = t2 ^ t0 ^ t1 ^ ROR64(ROW_ROR_8(t4), 32);
+  t1 = ROR64(ROW_ROR_12(state[5]), 16);
+  t2 = t1 ^ state[5];
+  state[5] = t4 ^ t1 ^ ROR64(ROW_ROR_8(t2), 32);
+  t1 = ROR64(ROW_ROR_12(state[4]), 16);
+  t4 = t1 ^ state[4];
+  state[4] = t2 ^ t0 ^ t1 ^ ROR64(ROW_ROR_8(t4), 32);
+  t1 = ROR64(ROW_ROR_12(state[3]), 16);
+  t2 = t1 ^ state[3];
+  state[3] = t4 ^ t0 ^ t1 ^ ROR64(ROW_ROR_8(t2), 32);
+  t1 = ROR64(ROW_ROR_12(state[2]), 16);
+  t4 = t1 ^ state[2];
+  state[2] = t2 ^ t1 ^ ROR64(ROW_ROR_8(t4), 32);
+  t1 = ROR64(ROW_ROR_12(state[1]), 16);
+  t2 = t1 ^ state[1];
+  state[1] = t4 ^ t1 ^ ROR64(ROW_ROR_8(t2), 32);
+  state[0] = t2 ^ t3 ^ ROR64(ROW_ROR_8(t0), 32);
+}
+
+/**
+ * MixColumns in the fixsliced representation, for rounds i s.t. (i%4) == 1.
+ */
+static inline void mixcolumns_1(uint64_t state[8])
+{
+  uint64_t t0, t1, t2;
+  int      i;
+  t0 = state[0] ^ ROR64(ROW_ROR_8(state[0]), 16);
+  t1 = state[7] ^ ROR64(ROW_ROR_8(state[7]), 16);
+  t2 = state[6];
+  state[6] = t1 ^ t0;
+  state[7] ^= state[6] ^ ROR64(t1, 32);
+  t1 = ROR64(ROW_ROR_8(t2), 16);
+  state[6] ^= t1;
+  t1 ^= t2;
+  state[6] ^= ROR64(t1, 32);
+  // state[i] for i = 5 to 0, the bits 4 and 3 being also XORed with t0
+  for(i = 5; i >= 0; i--) {
+    t2 = state[i];
+    state[i] = (i == 4 || i == 3) ? t1 ^ t0 : t1;
+    t1 = ROR64(ROW_ROR_8(t2), 16);
+    state[i] ^= t1;
+    t1 ^= t2;
+    state[i] ^= ROR64(t1, 32);
+  }
+}
+
+/**
+ * MixColumns in the fixsliced representation, for rounds i s.t. (i%4) == 2.
+ */
+static inline void mixcolumns_2(uint64_t state[8])
+{
+  uint64_t t0, t1, t2, t3, t4;
+  t3 = ROR64(ROW_ROR_4(state[0]), 16);
+  t0 = state[0] ^ t3;
+  t1 = ROR64(ROW_ROR_4(state[7]), 16);
+  t2 = state[7] ^ t1;
+  state[7] = ROR64(ROW_ROR_8(t2), 32) ^ t1 ^ t0;
+  t1 = ROR64(ROW_ROR_4(state[6]), 16);
+  t4 = t1 ^ state[6];
+  state[6] = t2 ^ t0 ^ t1 ^ ROR64(ROW_ROR_8(t4), 32);
+  t1 = ROR64(ROW_ROR_4(state[5]), 16);
+  t2 = t1 ^ state[5];
+  state[5] = t4 ^ t1 ^ ROR64(ROW_ROR_8(t2), 32);
+  t1 = ROR64(ROW_ROR_4(state[4]), 16);
+  t4 = t1 ^ state[4];
+  state[4] = t2 ^ t0 ^ t1 ^ ROR64(ROW_ROR_8(t4), 32);
+  t1 = ROR64(ROW_ROR_4(state[3]), 16);
+  t2 = t1 ^ state[3];
+  state[3] = t4 ^ t0 ^ t1 ^ ROR64(ROW_ROR_8(t2), 32);
+  t1 = ROR64(ROW_ROR_4(state[2]), 16);
+  t4 = t1 ^ state[2];
+  state[2] = t2 ^ t1 ^ ROR64(ROW_ROR_8(t4), 32);
+  t1 = ROR64(ROW_ROR_4(state[1]), 16);
+  t2 = t1 ^ state[1];
+  state[1] = t4 ^ t1 ^ ROR64(ROW_ROR_8(t2), 32);
+  state[0] = t2 ^ t3 ^ ROR64(ROW_ROR_8(t0), 32);
+}
+
+/**
+ * MixColumns in the fixsliced representation, for rounds i s.t. (i%4) == 3.
+ */
+static inline void mixcolumns_3(uint64_t state[8])
+{
+  uint64_t t0, t1, t2;
+  t0 = state[7] ^ ROR64(state[7], 16);
+  t2 = state[0] ^ ROR64(state[0], 16);
+  state[7] = t2 ^ ROR64(state[7], 16) ^ ROR64(t0, 32);
+  t1 = state[6] ^ ROR64(state[6], 16);
+  state[6] = t0 ^ t2 ^ ROR64(state[6], 16) ^ ROR64(t1, 32);
+  t0 = state[5] ^ ROR64(state[5], 16);
+  state[5] = t1 ^ ROR64(state[5], 16) ^ ROR64(t0, 32);
+  t1 = state[4] ^ ROR64(state[4], 16);
+  state[4] = t0 ^ t2 ^ ROR64(state[4], 16) ^ ROR64(t1, 32);
+  t0 = state[3] ^ ROR64(state[3], 16);
+  state[3] = t1 ^ t2 ^ ROR64(state[3], 16) ^ ROR64(t0, 32);
+  t1 = state[2] ^ ROR64(state[2], 16);
+  state[2] = t0 ^ ROR64(state[2], 16) ^ ROR64(t1, 32);
+  t0 = state[1] ^ ROR64(state[1], 16);
+  state[1] = t1 ^ ROR64(state[1], 16) ^ ROR64(t0, 32);
+  state[0] = t0 ^ ROR64(state[0], 16) ^ ROR64(t2, 32);
+}
+
+/**
+ * Derive the fixsliced round keys from the standard expanded key, as done by
+ * aes128_keyschedule_ffs_lut in ../armv6m/aes_keyschedule_lut.c: ShiftRows^(-i)
+ * is applied to the i-th round key, which is then packed (4 times) and
+ * complemented on the bits 1, 2, 6 and 7 (the NOTs omitted in the S-box).
+ */
+void aes128_kexp_ffs64(roundkeys_t* roundkeys, const unsigned char key[KEYBYTES])
+{
+  roundkeys_t    std;
+  const uint8_t* rk = (const uint8_t*)std.rk;
+  uint64_t       rkey[8];
+  uint16_t       k[8];
+  uint32_t       w[44], t0, t1, t2;
+  unsigned char  blocks[4*BLOCKBYTES];
+  int            i, j;
+
+  aes128_kexp_c(&std, key);
+  for(i = 0; i < 44; i++)
+    w[i] = LE_LOAD_32(rk + 4*i);
+  for(i = 4; i < 40; i += 4) {
+    t0 = w[i];
+    t1 = w[i+1];
+    t2 = w[i+2];
+    switch ((i/4) % 4) {
+      case 1:                         // ShiftRows^(-1)
+        w[i]   = (w[i] & 0x000000ff)   | (w[i+3] & 0x0000ff00) | (w[i+2] & 0x00ff0000) | (w[i+1] & 0xff000000);
+        w[i+1] = (w[i+1] & 0x000000ff) | (t0 & 0x0000ff00)     | (w[i+3] & 0x00ff0000) | (w[i+2] & 0xff000000);
+        w[i+2] = (w[i+2] & 0x000000ff) | (t1 & 0x0000ff00)     | (t0 & 0x00ff0000)     | (w[i+3] & 0xff000000);
+        w[i+3] = (w[i+3] & 0x000000ff) | (t2 & 0x0000ff00)     | (t1 & 0x00ff0000)     | (t0 & 0xff000000);
+        break;
+      case 2:                         // ShiftRows^(-2)
+        SWAPMOVE(w[i+2], w[i], 0xff00ff00, 0);
+        SWAPMOVE(w[i+3], w[i+1], 0xff00ff00, 0);
+        break;
+      case 3:                         // ShiftRows^(-3)
+        w[i]   = (w[i] & 0x000000ff)   | (w[i+1] & 0x0000ff00) | (w[i+2] & 0x00ff0000) | (w[i+3] & 0xff000000);
+        w[i+1] = (w[i+1] & 0x000000ff) | (w[i+2] & 0x0000ff00) | (w[i+3] & 0x00ff0000) | (t0 & 0xff000000);
+        w[i+2] = (w[i+2] & 0x000000ff) | (w[i+3] & 0x0000ff00) | (t0 & 0x00ff0000)     | (t1 & 0xff000000);
+        w[i+3] = (w[i+3] & 0x000000ff) | (t0 & 0x0000ff00)     | (t1 & 0x00ff0000)     | (t2 & 0xff000000);
+        break;
+    }
+  }
+  for(i = 0; i < 11; i++) {
+    for(j = 0; j < 4*BLOCKBYTES; j++)
+      blocks[j] = (w[4*i + (j%BLOCKBYTES)/4] >> (8*(j%4))) & 0xff;
+    packing(rkey, blocks);
+    if (i > 0) {
+      rkey[1] ^= ~0ULL;
+      rkey[2] ^= ~0ULL;
+      rkey[6] ^= ~0ULL;
+      rkey[7] ^= ~0ULL;
+    }
+    for(j = 0; j < 8; j++)
+      k[j] = rkey_compact(rkey[j]);
+    memcpy(&roundkeys->rk[i], k, sizeof(k));
+  }
+}
+
+/**
+ * Decryption round keys of aes128_dec_inv_c, derived from the key recovered
+ * from the first (unrotated and uncomplemented) fixsliced round key.
+ */
+void aes128_kexp_inv_ffs64(roundkeys_t* roundkeys_inv, const roundkeys_t* roundkeys)
+{
+  roundkeys_t   std;
+  uint64_t      rkey[8];
+  uint16_t      k[8];
+  unsigned char blocks[4*BLOCKBYTES];
+  int           i;
+
+  memcpy(k, &roundkeys->rk[0], sizeof(k));
+  for(i = 0; i < 8; i++)
+    rkey[i] = rkey_expand(k[i]);
+  unpacking(blocks, rkey);
+  aes128_kexp_c(&std, blocks);
+  aes128_kexp_inv_c(roundkeys_inv, &std);
+}
+
+static void enc_x4(unsigned char out[4*BLOCKBYTES], const unsigned char in[4*BLOCKBYTES], const uint64_t rk[88])
+{
+  uint64_t state[8];
+  int      i;
+
+  packing(state, in);
+  ark(state, rk);
+  for(i = 0; i < 8; i += 4) {         // rounds 1-8
+    sbox(state);
+    mixcolumns_0(state);
+    ark(state, rk + 8*(i+1));
+    sbox(state);
+    mixcolumns_1(state);
+    ark(state, rk + 8*(i+2));
+    sbox(state);
+    mixcolumns_2(state);
+    ark(state, rk + 8*(i+3));
+    sbox(state);
+    mixcolumns_3(state);
+    ark(state, rk + 8*(i+4));
+  }
+  sbox(state);                        // round 9
+  mixcolumns_0(state);
+  ark(state, rk + 72);
+  sbox(state);                        // round 10
+  double_shiftrows(state);            // resynchronization
+  ark(state, rk + 80);
+  unpacking(out, state);
+}
+
+void aes128_enc_x4_ffs64(unsigned char out[4*BLOCKBYTES], const unsigned char in[4*BLOCKBYTES], const roundkeys_t* roundkeys)
+{
+  uint64_t rk[88];
+  rkeys_expand(rk, roundkeys);
+  enc_x4(out, in, rk);
+}
+
+void aes128_enc_ffs64(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys)
+{
+  aes128_enc_blocks_ffs64(out, in, 1, roundkeys);
+}
+
+void aes128_enc_blocks_ffs64(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys)
+{
+  unsigned char b[4*BLOCKBYTES] = {0};
+  uint64_t      rk[88];
+  size_t        i;
+
+  rkeys_expand(rk, roundkeys);
+  for(; nblocks >= 4; nblocks -= 4, in += 4*BLOCKBYTES, out += 4*BLOCKBYTES)
+    enc_x4(out, in, rk);
+  if (nblocks) {
+    for(i = 0; i < nblocks*BLOCKBYTES; i++)
+      b[i] = in[i];
+    enc_x4(b, b, rk);
+    for(i = 0; i < nblocks*BLOCKBYTES; i++)
+      out[i] = b[i];
+  }
+}
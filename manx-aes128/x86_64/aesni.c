@@ -1,77 +1,115 @@
-#include "block_cipher.h"
-
-/**
- * Key schedule round function.
- */
-static inline void keyschedule_roundfunc(__m128i *rkey, __m128i word)
-{
-  __m128i tmp;
-  word  = _mm_shuffle_epi32(word, 0xff);
-  tmp   = _mm_slli_si128(*rkey, 0x4);
-  *rkey = _mm_xor_si128(*rkey, tmp);
-  tmp   = _mm_slli_si128(tmp, 0x4);
-  *rkey = _mm_xor_si128(*rkey, tmp);
-  tmp   = _mm_slli_si128(tmp, 0x4);
-  *rkey = _mm_xor_si128(*rkey, tmp);
-  *rkey = _mm_xor_si128(*rkey, word);
-}
+#include "aesni.h"
 
 /**
  * Precalculate all AES-128 round keys from an input encryption key.
  */
 void aes128_kexp(roundkeys_t* roundkeys, const uint8_t key[KEYBYTES])
 {
-  __m128i rkey;
-  rkey = _mm_load_si128((__m128i*)key);
-  roundkeys->rk[0] = rkey; 
-  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x01));
-  roundkeys->rk[1] = rkey;
-  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x02));
-  roundkeys->rk[2] = rkey;
-  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x04));
-  roundkeys->rk[3] = rkey;
-  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x08));
-  roundkeys->rk[4] = rkey;
-  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x10));
-  roundkeys->rk[5] = rkey;
-  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x20));
-  roundkeys->rk[6] = rkey;
-  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x40));
-  roundkeys->rk[7] = rkey;
-  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x80));
-  roundkeys->rk[8] = rkey;
-  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x1b));
-  roundkeys->rk[9] = rkey;
-  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x36));
-  roundkeys->rk[10] = rkey;
+  aes128_kexp_inline(roundkeys, key);
 }
 
 void aes128_enc(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys)
 {
-  unsigned int i;
-  __m128i state;
-  const __m128i* rkeys = (const __m128i*)roundkeys->rk;
+  aes128_enc_inline(out, in, roundkeys);
+}
 
-  state = _mm_load_si128((__m128i*)in);
-  state = _mm_xor_si128(state, rkeys[0]);
-  for(i = 1; i < 10; i++)
-    state = _mm_aesenc_si128(state, rkeys[i]);
-  state = _mm_aesenclast_si128(state, rkeys[i]);
+/**
+ * Encrypt NB independent blocks in lockstep so that several AESENC
+ * instructions are in flight at the same time.
+ */
+#define AES128_ENC_INTERLEAVED(NB)                                            \
+void aes128_enc_x##NB(unsigned char out[NB*BLOCKBYTES],                      \
+  const unsigned char in[NB*BLOCKBYTES],                                      \
+  const roundkeys_t* roundkeys)                                               \
+{                                                                             \
+  unsigned int i, j;                                                          \
+  __m128i state[NB];                                                          \
+  const __m128i* rkeys = (const __m128i*)roundkeys->rk;                       \
+  for(j = 0; j < NB; j++)                                                     \
+    state[j] = _mm_xor_si128(                                                 \
+      _mm_loadu_si128((const __m128i*)(in + j*BLOCKBYTES)), rkeys[0]);        \
+  for(i = 1; i < 10; i++)                                                     \
+    for(j = 0; j < NB; j++)                                                   \
+      state[j] = _mm_aesenc_si128(state[j], rkeys[i]);                        \
+  for(j = 0; j < NB; j++)                                                     \
+    _mm_storeu_si128((__m128i*)(out + j*BLOCKBYTES),                          \
+      _mm_aesenclast_si128(state[j], rkeys[10]));                             \
+}
 
-  _mm_store_si128((__m128i*)out, state);
+AES128_ENC_INTERLEAVED(8)
+AES128_ENC_INTERLEAVED(4)
+AES128_ENC_INTERLEAVED(2)
+
+void aes128_enc_blocks(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys)
+{
+  for(; nblocks >= 8; nblocks -= 8, in += 8*BLOCKBYTES, out += 8*BLOCKBYTES)
+    aes128_enc_x8(out, in, roundkeys);
+  if (nblocks >= 4) {
+    aes128_enc_x4(out, in, roundkeys);
+    nblocks -= 4, in += 4*BLOCKBYTES, out += 4*BLOCKBYTES;
+  }
+  if (nblocks >= 2) {
+    aes128_enc_x2(out, in, roundkeys);
+    nblocks -= 2, in += 2*BLOCKBYTES, out += 2*BLOCKBYTES;
+  }
+  if (nblocks)
+    aes128_enc(out, in, roundkeys);
 }
 
 void aes128_dec(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys)
 {
-  unsigned int i;
-  __m128i state;
-  const __m128i* rkeys = (const __m128i*)roundkeys->rk;
+  aes128_dec_inline(out, in, roundkeys);
+}
 
-  state = _mm_load_si128((__m128i*)in);
-  state = _mm_xor_si128(state, rkeys[10]);
-  for(i = 9; i > 0; i--) 
-    state = _mm_aesdec_si128(state, _mm_aesimc_si128(rkeys[i]));
-  state = _mm_aesdeclast_si128(state, rkeys[i]);
+void aes128_kexp_inv(roundkeys_t* roundkeys_inv, const roundkeys_t* roundkeys)
+{
+  aes128_kexp_inv_inline(roundkeys_inv, roundkeys);
+}
+
+void aes128_dec_inv(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys_inv)
+{
+  aes128_dec_inv_inline(out, in, roundkeys_inv);
+}
 
-  _mm_store_si128((__m128i*)out, state);
+/**
+ * Decrypt NB independent blocks in lockstep, relying on the round keys
+ * returned by aes128_kexp_inv.
+ */
+#define AES128_DEC_INV_INTERLEAVED(NB)                                        \
+void aes128_dec_inv_x##NB(unsigned char out[NB*BLOCKBYTES],                  \
+  const unsigned char in[NB*BLOCKBYTES],                                      \
+  const roundkeys_t* roundkeys_inv)                                           \
+{                                                                             \
+  unsigned int i, j;                                                          \
+  __m128i state[NB];                                                          \
+  const __m128i* rkeys = (const __m128i*)roundkeys_inv->rk;                   \
+  for(j = 0; j < NB; j++)                                                     \
+    state[j] = _mm_xor_si128(                                                 \
+      _mm_loadu_si128((const __m128i*)(in + j*BLOCKBYTES)), rkeys[0]);        \
+  for(i = 1; i < 10; i++)                                                     \
+    for(j = 0; j < NB; j++)                                                   \
+      state[j] = _mm_aesdec_si128(state[j], rkeys[i]);                        \
+  for(j = 0; j < NB; j++)                                                     \
+    _mm_storeu_si128((__m128i*)(out + j*BLOCKBYTES),                          \
+      _mm_aesdeclast_si128(state[j], rkeys[10]));                             \
+}
+
+AES128_DEC_INV_INTERLEAVED(8)
+AES128_DEC_INV_INTERLEAVED(4)
+AES128_DEC_INV_INTERLEAVED(2)
+
+void aes128_dec_inv_blocks(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys_inv)
+{
+  for(; nblocks >= 8; nblocks -= 8, in += 8*BLOCKBYTES, out += 8*BLOCKBYTES)
+    aes128_dec_inv_x8(out, in, roundkeys_inv);
+  if (nblocks >= 4) {
+    aes128_dec_inv_x4(out, in, roundkeys_inv);
+    nblocks -= 4, in += 4*BLOCKBYTES, out += 4*BLOCKBYTES;
+  }
+  if (nblocks >= 2) {
+    aes128_dec_inv_x2(out, in, roundkeys_inv);
+    nblocks -= 2, in += 2*BLOCKBYTES, out += 2*BLOCKBYTES;
+  }
+  if (nblocks)
+    aes128_dec_inv(out, in, roundkeys_inv);
 }
@@ -0,0 +1,124 @@
+#ifndef AESNI_H_
+#define AESNI_H_
+
+#include "block_cipher.h"
+
+/**
+ * AES-NI key expansion and single-block functions, defined inline so that
+ * they can be bound at compile time to the generic Manx implementation (see
+ * block_cipher.h) as well as wrapped by aesni.c. The target attribute allows
+ * them to be inlined into functions of translation units compiled without
+ * -maes, as long as these functions carry the same attribute.
+ */
+#define AESNI_INLINE static inline __attribute__((always_inline, target("aes")))
+
+/**
+ * Key schedule round function.
+ */
+AESNI_INLINE void keyschedule_roundfunc(__m128i *rkey, __m128i word)
+{
+  __m128i tmp;
+  word  = _mm_shuffle_epi32(word, 0xff);
+  tmp   = _mm_slli_si128(*rkey, 0x4);
+  *rkey = _mm_xor_si128(*rkey, tmp);
+  tmp   = _mm_slli_si128(tmp, 0x4);
+  *rkey = _mm_xor_si128(*rkey, tmp);
+  tmp   = _mm_slli_si128(tmp, 0x4);
+  *rkey = _mm_xor_si128(*rkey, tmp);
+  *rkey = _mm_xor_si128(*rkey, word);
+}
+
+/**
+ * Precalculate all AES-128 round keys from an input encryption key.
+ */
+AESNI_INLINE void aes128_kexp_inline(roundkeys_t* roundkeys, const uint8_t key[KEYBYTES])
+{
+  __m128i rkey;
+  rkey = _mm_loadu_si128((const __m128i*)key);
+  roundkeys->rk[0] = rkey; 
+  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x01));
+  roundkeys->rk[1] = rkey;
+  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x02));
+  roundkeys->rk[2] = rkey;
+  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x04));
+  roundkeys->rk[3] = rkey;
+  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x08));
+  roundkeys->rk[4] = rkey;
+  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x10));
+  roundkeys->rk[5] = rkey;
+  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x20));
+  roundkeys->rk[6] = rkey;
+  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x40));
+  roundkeys->rk[7] = rkey;
+  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x80));
+  roundkeys->rk[8] = rkey;
+  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x1b));
+  roundkeys->rk[9] = rkey;
+  keyschedule_roundfunc(&rkey, _mm_aeskeygenassist_si128(rkey, 0x36));
+  roundkeys->rk[10] = rkey;
+}
+
+AESNI_INLINE void aes128_enc_inline(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys)
+{
+  unsigned int i;
+  __m128i state;
+  const __m128i* rkeys = (const __m128i*)roundkeys->rk;
+
+  state = _mm_loadu_si128((const __m128i*)in);
+  state = _mm_xor_si128(state, rkeys[0]);
+  for(i = 1; i < 10; i++)
+    state = _mm_aesenc_si128(state, rkeys[i]);
+  state = _mm_aesenclast_si128(state, rkeys[i]);
+
+  _mm_storeu_si128((__m128i*)out, state);
+}
+
+AESNI_INLINE void aes128_dec_inline(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys)
+{
+  unsigned int i;
+  __m128i state;
+  const __m128i* rkeys = (const __m128i*)roundkeys->rk;
+
+  state = _mm_loadu_si128((const __m128i*)in);
+  state = _mm_xor_si128(state, rkeys[10]);
+  for(i = 9; i > 0; i--) 
+    state = _mm_aesdec_si128(state, _mm_aesimc_si128(rkeys[i]));
+  state = _mm_aesdeclast_si128(state, rkeys[i]);
+
+  _mm_storeu_si128((__m128i*)out, state);
+}
+
+/**
+ * Derive the round keys of the equivalent inverse cipher from the encryption
+ * ones, so that InvMixColumns is not applied to the round keys on every block
+ * decryption: the round keys are stored in reverse order and InvMixColumns is
+ * applied to the round keys 1 to 9.
+ */
+AESNI_INLINE void aes128_kexp_inv_inline(roundkeys_t* roundkeys_inv, const roundkeys_t* roundkeys)
+{
+  unsigned int i;
+  roundkeys_inv->rk[0] = roundkeys->rk[10];
+  for(i = 1; i < 10; i++)
+    roundkeys_inv->rk[i] = _mm_aesimc_si128(roundkeys->rk[10-i]);
+  roundkeys_inv->rk[10] = roundkeys->rk[0];
+}
+
+/**
+ * Block decryption relying on the round keys returned by aes128_kexp_inv.
+ */
+AESNI_INLINE void aes128_dec_inv_inline(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys_inv)
+{
+  unsigned int i;
+  __m128i state;
+  const __m128i* rkeys = (const __m128i*)roundkeys_inv->rk;
+
+  state = _mm_loadu_si128((const __m128i*)in);
+  state = _mm_xor_si128(state, rkeys[0]);
+  for(i = 1; i < 10; i++)
+    state = _mm_aesdec_si128(state, rkeys[i]);
+  state = _mm_aesdeclast_si128(state, rkeys[i]);
+
+  _mm_storeu_si128((__m128i*)out, state);
+}
+
+#endif
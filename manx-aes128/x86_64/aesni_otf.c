@@ -0,0 +1,179 @@
+#include <tmmintrin.h>
+#include "aesni.h"
+
+/**
+ * AES-NI implementation computing the round keys on the fly, interleaved with
+ * the rounds, instead of reading them from an expanded key schedule: only the
+ * key is stored for encryption, and only the last round key for decryption,
+ * from which the round keys are computed backwards (see roundkeys_otf_t). A
+ * key then occupies 16 bytes (32 bytes once used for decryption) instead of
+ * 176, i.e. a Manx context of 48 bytes (see manx_ctx_size) within a single
+ * cache line, at the cost of a few more instructions per round.
+ */
+#define AESNI_OTF        __attribute__((target("aes,ssse3")))
+#define AESNI_OTF_INLINE static inline __attribute__((always_inline, target("aes,ssse3")))
+
+/**
+ * SubWord(RotWord()) of the word 3 of a round key xored with rcon, in all the
+ * words. AESKEYGENASSIST being slow on most cores, it is computed with
+ * AESENCLAST on the word 3 rotated and broadcast (ShiftRows being then the
+ * identity), which also runs on the AES units.
+ */
+AESNI_OTF_INLINE __m128i keyschedule_subrot(__m128i rkey, int rcon)
+{
+  const __m128i rot = _mm_set1_epi32(0x0c0f0e0d);
+  return _mm_aesenclast_si128(_mm_shuffle_epi8(rkey, rot), _mm_set1_epi32(rcon));
+}
+
+/**
+ * Next round key, as keyschedule_roundfunc.
+ */
+AESNI_OTF_INLINE __m128i keyschedule_next(__m128i rkey, int rcon)
+{
+  __m128i word = keyschedule_subrot(rkey, rcon);
+  rkey = _mm_xor_si128(rkey, _mm_slli_si128(rkey, 4));
+  rkey = _mm_xor_si128(rkey, _mm_slli_si128(rkey, 8));
+  return _mm_xor_si128(rkey, word);
+}
+
+/**
+ * Previous round key, i.e. the inverse of keyschedule_next: the words 1 to 3
+ * of the previous round key are w[i] ^ w[i-1], from which the word 0 is
+ * recovered with SubWord(RotWord()) of the word 3.
+ */
+AESNI_OTF_INLINE __m128i keyschedule_prev(__m128i rkey, int rcon)
+{
+  rkey = _mm_xor_si128(rkey, _mm_slli_si128(rkey, 4));
+  return _mm_xor_si128(rkey, _mm_srli_si128(keyschedule_subrot(rkey, rcon), 12));
+}
+
+#define RKEY_NEXT(rkey, rcon) (rkey = keyschedule_next(rkey, rcon))
+#define RKEY_PREV(rkey, rcon) (rkey = keyschedule_prev(rkey, rcon))
+
+/**
+ * Rounds of NB blocks in lockstep, each round key being computed once for all
+ * of them.
+ */
+#define OTF_ENC_ROUND(NB, rcon)                                               \
+  do {                                                                        \
+    RKEY_NEXT(rkey, rcon);                                                    \
+    for(j = 0; j < NB; j++)                                                   \
+      state[j] = _mm_aesenc_si128(state[j], rkey);                            \
+  } while (0)
+
+#define OTF_DEC_ROUND(NB, rcon)                                               \
+  do {                                                                        \
+    RKEY_PREV(rkey, rcon);                                                    \
+    imc = _mm_aesimc_si128(rkey);                                             \
+    for(j = 0; j < NB; j++)                                                   \
+      state[j] = _mm_aesdec_si128(state[j], imc);                             \
+  } while (0)
+
+/**
+ * Store the key only, the round keys being computed by the functions below.
+ */
+void aes128_kexp_otf(roundkeys_otf_t* roundkeys, const unsigned char k[KEYBYTES])
+{
+  roundkeys->rk = _mm_loadu_si128((const __m128i*)k);
+}
+
+/**
+ * Store the last round key only, from which decryption computes the round
+ * keys backwards.
+ */
+AESNI_OTF void aes128_kexp_inv_otf(roundkeys_otf_t* roundkeys_inv, const roundkeys_otf_t* roundkeys)
+{
+  __m128i rkey = roundkeys->rk;
+  RKEY_NEXT(rkey, 0x01); RKEY_NEXT(rkey, 0x02); RKEY_NEXT(rkey, 0x04);
+  RKEY_NEXT(rkey, 0x08); RKEY_NEXT(rkey, 0x10); RKEY_NEXT(rkey, 0x20);
+  RKEY_NEXT(rkey, 0x40); RKEY_NEXT(rkey, 0x80); RKEY_NEXT(rkey, 0x1b);
+  RKEY_NEXT(rkey, 0x36);
+  roundkeys_inv->rk = rkey;
+}
+
+#define AES128_ENC_OTF(NB)                                                    \
+AESNI_OTF static void aes128_enc_otf_x##NB(unsigned char* out,                \
+  const unsigned char* in, const roundkeys_otf_t* roundkeys)                  \
+{                                                                             \
+  unsigned int j;                                                             \
+  __m128i state[NB], rkey = roundkeys->rk;                                    \
+  for(j = 0; j < NB; j++)                                                     \
+    state[j] = _mm_xor_si128(                                                 \
+      _mm_loadu_si128((const __m128i*)(in + j*BLOCKBYTES)), rkey);            \
+  OTF_ENC_ROUND(NB, 0x01); OTF_ENC_ROUND(NB, 0x02); OTF_ENC_ROUND(NB, 0x04);  \
+  OTF_ENC_ROUND(NB, 0x08); OTF_ENC_ROUND(NB, 0x10); OTF_ENC_ROUND(NB, 0x20);  \
+  OTF_ENC_ROUND(NB, 0x40); OTF_ENC_ROUND(NB, 0x80); OTF_ENC_ROUND(NB, 0x1b);  \
+  RKEY_NEXT(rkey, 0x36);                                                      \
+  for(j = 0; j < NB; j++)                                                     \
+    _mm_storeu_si128((__m128i*)(out + j*BLOCKBYTES),                          \
+      _mm_aesenclast_si128(state[j], rkey));                                  \
+}
+
+/**
+ * Decryption with the round keys of the (non-equivalent) inverse cipher, the
+ * ones computed backwards being passed through InvMixColumns for the rounds
+ * 9 to 1.
+ */
+#define AES128_DEC_OTF(NB)                                                    \
+AESNI_OTF static void aes128_dec_otf_x##NB(unsigned char* out,                \
+  const unsigned char* in, const roundkeys_otf_t* roundkeys_inv)              \
+{                                                                             \
+  unsigned int j;                                                             \
+  __m128i state[NB], imc, rkey = roundkeys_inv->rk;                           \
+  for(j = 0; j < NB; j++)                                                     \
+    state[j] = _mm_xor_si128(                                                 \
+      _mm_loadu_si128((const __m128i*)(in + j*BLOCKBYTES)), rkey);            \
+  OTF_DEC_ROUND(NB, 0x36); OTF_DEC_ROUND(NB, 0x1b); OTF_DEC_ROUND(NB, 0x80);  \
+  OTF_DEC_ROUND(NB, 0x40); OTF_DEC_ROUND(NB, 0x20); OTF_DEC_ROUND(NB, 0x10);  \
+  OTF_DEC_ROUND(NB, 0x08); OTF_DEC_ROUND(NB, 0x04); OTF_DEC_ROUND(NB, 0x02);  \
+  RKEY_PREV(rkey, 0x01);                                                      \
+  for(j = 0; j < NB; j++)                                                     \
+    _mm_storeu_si128((__m128i*)(out + j*BLOCKBYTES),                          \
+      _mm_aesdeclast_si128(state[j], rkey));                                  \
+}
+
+AES128_ENC_OTF(4)
+AES128_ENC_OTF(2)
+AES128_ENC_OTF(1)
+AES128_DEC_OTF(4)
+AES128_DEC_OTF(2)
+AES128_DEC_OTF(1)
+
+void aes128_enc_otf(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_otf_t* roundkeys)
+{
+  aes128_enc_otf_x1(out, in, roundkeys);
+}
+
+void aes128_dec_otf(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_otf_t* roundkeys_inv)
+{
+  aes128_dec_otf_x1(out, in, roundkeys_inv);
+}
+
+/**
+ * Multi-block functions, computing the round keys once for 4 blocks (the
+ * latency of keyschedule_next and keyschedule_prev being hidden behind the
+ * AESENC and AESDEC of the other blocks).
+ */
+void aes128_enc_blocks_otf(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_otf_t* roundkeys)
+{
+  for(; nblocks >= 4; nblocks -= 4, in += 4*BLOCKBYTES, out += 4*BLOCKBYTES)
+    aes128_enc_otf_x4(out, in, roundkeys);
+  if (nblocks >= 2) {
+    aes128_enc_otf_x2(out, in, roundkeys);
+    nblocks -= 2, in += 2*BLOCKBYTES, out += 2*BLOCKBYTES;
+  }
+  if (nblocks)
+    aes128_enc_otf_x1(out, in, roundkeys);
+}
+
+void aes128_dec_blocks_otf(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_otf_t* roundkeys_inv)
+{
+  for(; nblocks >= 4; nblocks -= 4, in += 4*BLOCKBYTES, out += 4*BLOCKBYTES)
+    aes128_dec_otf_x4(out, in, roundkeys_inv);
+  if (nblocks >= 2) {
+    aes128_dec_otf_x2(out, in, roundkeys_inv);
+    nblocks -= 2, in += 2*BLOCKBYTES, out += 2*BLOCKBYTES;
+  }
+  if (nblocks)
+    aes128_dec_otf_x1(out, in, roundkeys_inv);
+}
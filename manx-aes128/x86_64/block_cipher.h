@@ -3,6 +3,7 @@
 
 #include <wmmintrin.h>
 #include <stdint.h>
+#include <stddef.h>
 
 #define KEYBYTES    16
 #define BLOCKBYTES  16
@@ -13,4 +14,77 @@ void aes128_kexp(roundkeys_t* roundkeys, const unsigned char k[KEYBYTES]);
 void aes128_enc(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys);
 void aes128_dec(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys);
 
+// encryption of 2, 4 or 8 independent blocks in lockstep
+void aes128_enc_x2(unsigned char out[2*BLOCKBYTES], const unsigned char in[2*BLOCKBYTES], const roundkeys_t* roundkeys);
+void aes128_enc_x4(unsigned char out[4*BLOCKBYTES], const unsigned char in[4*BLOCKBYTES], const roundkeys_t* roundkeys);
+void aes128_enc_x8(unsigned char out[8*BLOCKBYTES], const unsigned char in[8*BLOCKBYTES], const roundkeys_t* roundkeys);
+
+// encryption of nblocks independent blocks, interleaved 8, 4 or 2 at a time
+void aes128_enc_blocks(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys);
+
+// equivalent inverse cipher: decryption round keys are derived once from the encryption ones
+void aes128_kexp_inv(roundkeys_t* roundkeys_inv, const roundkeys_t* roundkeys);
+void aes128_dec_inv(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys_inv);
+void aes128_dec_inv_x2(unsigned char out[2*BLOCKBYTES], const unsigned char in[2*BLOCKBYTES], const roundkeys_t* roundkeys_inv);
+void aes128_dec_inv_x4(unsigned char out[4*BLOCKBYTES], const unsigned char in[4*BLOCKBYTES], const roundkeys_t* roundkeys_inv);
+void aes128_dec_inv_x8(unsigned char out[8*BLOCKBYTES], const unsigned char in[8*BLOCKBYTES], const roundkeys_t* roundkeys_inv);
+void aes128_dec_inv_blocks(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys_inv);
+
+// portable constant-time implementation in C, relying on the same round keys
+void aes128_kexp_c(roundkeys_t* roundkeys, const unsigned char k[KEYBYTES]);
+void aes128_kexp_inv_c(roundkeys_t* roundkeys_inv, const roundkeys_t* roundkeys);
+void aes128_enc_c(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys);
+void aes128_dec_inv_c(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys_inv);
+void aes128_enc_blocks_c(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys);
+void aes128_dec_inv_blocks_c(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys_inv);
+
+// portable constant-time encryption of 4 blocks at a time in 64-bit fixsliced
+// representation, the fixsliced round keys being stored compacted in rk (see
+// aes_ffs64.c); aes128_kexp_inv_ffs64 sets the decryption round keys of
+// aes128_dec_inv_c
+void aes128_kexp_ffs64(roundkeys_t* roundkeys, const unsigned char k[KEYBYTES]);
+void aes128_kexp_inv_ffs64(roundkeys_t* roundkeys_inv, const roundkeys_t* roundkeys);
+void aes128_enc_x4_ffs64(unsigned char out[4*BLOCKBYTES], const unsigned char in[4*BLOCKBYTES], const roundkeys_t* roundkeys);
+void aes128_enc_ffs64(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys);
+void aes128_enc_blocks_ffs64(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys);
+
+// AES-NI with the round keys computed on the fly (aesni_otf.c), from a single
+// round key: the key itself for encryption (aes128_kexp_otf), and the last
+// round key for decryption (aes128_kexp_inv_otf), from which aes128_dec_otf
+// computes the round keys backwards; dispatch.c binds them to a manx_cipher
+// whose rkeys_size is sizeof(roundkeys_otf_t)
+typedef struct {
+  __m128i rk;
+} roundkeys_otf_t;
+
+void aes128_kexp_otf(roundkeys_otf_t* roundkeys, const unsigned char k[KEYBYTES]);
+void aes128_kexp_inv_otf(roundkeys_otf_t* roundkeys_inv, const roundkeys_otf_t* roundkeys);
+void aes128_enc_otf(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_otf_t* roundkeys);
+void aes128_dec_otf(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_otf_t* roundkeys_inv);
+void aes128_enc_blocks_otf(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_otf_t* roundkeys);
+void aes128_dec_blocks_otf(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_otf_t* roundkeys_inv);
+
+// VAES kernels processing 2 (resp. 4) blocks per 256-bit (resp. 512-bit) vector:
+// they must only be called if aes128_vaes_width returns the corresponding width,
+// unlike the *_vaes functions which fall back on the AES-NI kernels.
+// aes128_vaes_width is defined in dispatch.c.
+int  aes128_vaes_width(void);
+void aes128_enc_blocks_vaes256(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys);
+void aes128_enc_blocks_vaes512(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys);
+void aes128_enc_blocks_vaes(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys);
+void aes128_dec_inv_blocks_vaes256(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys_inv);
+void aes128_dec_inv_blocks_vaes512(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys_inv);
+void aes128_dec_inv_blocks_vaes(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys_inv);
+
+// AES-NI functions bound at compile time to the manx*_static_* functions of
+// the generic Manx implementation (see MANX_STATIC_CIPHER in manx-config.h),
+// which carry the target attribute required to inline them; decryption relies
+// on the equivalent inverse cipher, as the Manx contexts do
+#include "aesni.h"
+#define MANX_STATIC_KEXPAND     aes128_kexp_inline
+#define MANX_STATIC_ENCRYPT     aes128_enc_inline
+#define MANX_STATIC_KEXPAND_INV aes128_kexp_inv_inline
+#define MANX_STATIC_DECRYPT     aes128_dec_inv_inline
+#define MANX_STATIC_ATTR        __attribute__((target("aes")))
+
 #endif
@@ -0,0 +1,143 @@
+#include "dispatch.h"
+#include "manx-cpu.h"
+
+/**
+ * The on-the-fly implementation only reads and writes the first
+ * sizeof(roundkeys_otf_t) bytes of the round keys of a Manx context (see
+ * rkeys_size in manx.h).
+ */
+static void kexp_otf(roundkeys_t* roundkeys, const unsigned char k[KEYBYTES])
+{
+  aes128_kexp_otf((roundkeys_otf_t*)roundkeys, k);
+}
+
+static void kexp_inv_otf(roundkeys_t* roundkeys_inv, const roundkeys_t* roundkeys)
+{
+  aes128_kexp_inv_otf((roundkeys_otf_t*)roundkeys_inv, (const roundkeys_otf_t*)roundkeys);
+}
+
+static void enc_otf(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys)
+{
+  aes128_enc_otf(out, in, (const roundkeys_otf_t*)roundkeys);
+}
+
+static void dec_otf(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys_inv)
+{
+  aes128_dec_otf(out, in, (const roundkeys_otf_t*)roundkeys_inv);
+}
+
+static void enc_blocks_otf(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys)
+{
+  aes128_enc_blocks_otf(out, in, nblocks, (const roundkeys_otf_t*)roundkeys);
+}
+
+static void dec_blocks_otf(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys_inv)
+{
+  aes128_dec_blocks_otf(out, in, nblocks, (const roundkeys_otf_t*)roundkeys_inv);
+}
+
+static const manx_cipher ciphers[AES128_IMPL_COUNT] = {
+  [AES128_IMPL_C] = {
+    .name           = "portable C",
+    .kexpand        = aes128_kexp_c,
+    .kexpand_inv    = aes128_kexp_inv_c,
+    .encrypt        = aes128_enc_c,
+    .decrypt        = aes128_dec_inv_c,
+    .encrypt_blocks = aes128_enc_blocks_c,
+    .decrypt_blocks = aes128_dec_inv_blocks_c,
+  },
+  [AES128_IMPL_FFS64] = {
+    .name           = "portable fixsliced",
+    .kexpand        = aes128_kexp_ffs64,
+    .kexpand_inv    = aes128_kexp_inv_ffs64,
+    .encrypt        = aes128_enc_ffs64,
+    .decrypt        = aes128_dec_inv_c,
+    .encrypt_blocks = aes128_enc_blocks_ffs64,
+    .decrypt_blocks = aes128_dec_inv_blocks_c,
+  },
+  [AES128_IMPL_AESNI] = {
+    .name           = "AES-NI",
+    .kexpand        = aes128_kexp,
+    .kexpand_inv    = aes128_kexp_inv,
+    .encrypt        = aes128_enc,
+    .decrypt        = aes128_dec_inv,
+  },
+  [AES128_IMPL_AESNI_MB] = {
+    .name           = "AES-NI multi-block",
+    .kexpand        = aes128_kexp,
+    .kexpand_inv    = aes128_kexp_inv,
+    .encrypt        = aes128_enc,
+    .decrypt        = aes128_dec_inv,
+    .encrypt_blocks = aes128_enc_blocks,
+    .decrypt_blocks = aes128_dec_inv_blocks,
+  },
+  [AES128_IMPL_VAES256] = {
+    .name           = "VAES-256",
+    .kexpand        = aes128_kexp,
+    .kexpand_inv    = aes128_kexp_inv,
+    .encrypt        = aes128_enc,
+    .decrypt        = aes128_dec_inv,
+    .encrypt_blocks = aes128_enc_blocks_vaes256,
+    .decrypt_blocks = aes128_dec_inv_blocks_vaes256,
+  },
+  [AES128_IMPL_VAES512] = {
+    .name           = "VAES-512",
+    .kexpand        = aes128_kexp,
+    .kexpand_inv    = aes128_kexp_inv,
+    .encrypt        = aes128_enc,
+    .decrypt        = aes128_dec_inv,
+    .encrypt_blocks = aes128_enc_blocks_vaes512,
+    .decrypt_blocks = aes128_dec_inv_blocks_vaes512,
+  },
+  [AES128_IMPL_AESNI_OTF] = {
+    .name           = "AES-NI on-the-fly",
+    .kexpand        = kexp_otf,
+    .kexpand_inv    = kexp_inv_otf,
+    .encrypt        = enc_otf,
+    .decrypt        = dec_otf,
+    .encrypt_blocks = enc_blocks_otf,
+    .decrypt_blocks = dec_blocks_otf,
+    .rkeys_size     = sizeof(roundkeys_otf_t),
+  },
+};
+
+/**
+ * Features required by each implementation (see manx-cpu.h).
+ */
+static const int required[AES128_IMPL_COUNT] = {
+  [AES128_IMPL_AESNI]     = MANX_CPU_AES,
+  [AES128_IMPL_AESNI_MB]  = MANX_CPU_AES,
+  [AES128_IMPL_VAES256]   = MANX_CPU_VAES256,
+  [AES128_IMPL_VAES512]   = MANX_CPU_VAES512,
+  [AES128_IMPL_AESNI_OTF] = MANX_CPU_AES,
+};
+
+int aes128_vaes_width(void)
+{
+  if (manx_cpu_supports(MANX_CPU_VAES512))
+    return 512;
+  if (manx_cpu_supports(MANX_CPU_VAES256))
+    return 256;
+  return 0;
+}
+
+int aes128_impl_supported(aes128_impl impl)
+{
+  return impl >= 0 && impl < AES128_IMPL_COUNT && manx_cpu_supports(required[impl]);
+}
+
+aes128_impl aes128_impl_best(void)
+{
+  // the on-the-fly implementation only pays off under cache pressure
+  return manx_cpu_best(required, AES128_IMPL_AESNI_OTF);
+}
+
+const manx_cipher* aes128_cipher(aes128_impl impl)
+{
+  return aes128_impl_supported(impl) ? &ciphers[impl] : NULL;
+}
+
+const manx_cipher* aes128_cipher_best(void)
+{
+  return &ciphers[aes128_impl_best()];
+}
@@ -0,0 +1,35 @@
+#ifndef DISPATCH_H_
+#define DISPATCH_H_
+
+#include "manx.h"
+
+/**
+ * AES-128 implementations available on x86_64, from the slowest to the
+ * fastest one, except for the on-the-fly one which only pays off when the
+ * expanded round keys no longer stay in cache (see README.md): it is never
+ * returned by aes128_impl_best.
+ */
+typedef enum {
+  AES128_IMPL_C,         // portable constant-time C (aes_c.c)
+  AES128_IMPL_FFS64,     // portable constant-time C, 64-bit fixsliced (aes_ffs64.c)
+  AES128_IMPL_AESNI,     // AES-NI, one block at a time (aesni.c)
+  AES128_IMPL_AESNI_MB,  // AES-NI, interleaved multi-block kernels (aesni.c)
+  AES128_IMPL_VAES256,   // VAES on 256-bit vectors (vaes.c)
+  AES128_IMPL_VAES512,   // VAES on 512-bit vectors (vaes.c)
+  AES128_IMPL_AESNI_OTF, // AES-NI, round keys computed on the fly (aesni_otf.c)
+  AES128_IMPL_COUNT
+} aes128_impl;
+
+// return 1 if the CPU (and the OS) supports the implementation, 0 otherwise
+int aes128_impl_supported(aes128_impl impl);
+
+// fastest implementation supported (but AES128_IMPL_AESNI_OTF), the CPU being probed once and for all
+aes128_impl aes128_impl_best(void);
+
+// functions of a given implementation to be passed to manx_ctx_init (NULL if not supported)
+const manx_cipher* aes128_cipher(aes128_impl impl);
+
+// functions of the fastest implementation supported
+const manx_cipher* aes128_cipher_best(void);
+
+#endif
@@ -0,0 +1 @@
+../../manx/manx-cpu.c
\ No newline at end of file
@@ -0,0 +1 @@
+../../manx/manx-keycache.c
\ No newline at end of file
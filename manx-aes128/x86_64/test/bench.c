@@ -0,0 +1,627 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <x86intrin.h>
+#include "../manx.h"
+#include "../manx-fixed.h"
+#include "../dispatch.h"
+#include "../manx-keycache.h"
+#include "manx-bench.h"
+
+/**
+ * Time the multi-block functions of a given implementation (or its
+ * single-block ones if it does not provide any).
+ */
+static void bench_blocks(const manx_ctx *ctx)
+{
+    const manx_cipher *cipher = ctx->cipher;
+    uint64_t           t_enc[RUNS], t_dec[RUNS];
+
+    for (size_t r = 0; r < RUNS; r++) {
+        uint64_t start = __rdtsc();
+        if (cipher->encrypt_blocks != NULL)
+            cipher->encrypt_blocks(out, in, NBLOCKS, &ctx->rkeys);
+        else
+            for (size_t i = 0; i < NBLOCKS; i++)
+                cipher->encrypt(out + i*BLOCKBYTES, in + i*BLOCKBYTES, &ctx->rkeys);
+        t_enc[r] = __rdtsc() - start;
+        start = __rdtsc();
+        if (cipher->decrypt_blocks != NULL)
+            cipher->decrypt_blocks(in, out, NBLOCKS, manx_ctx_rkeys_inv(ctx));
+        else
+            for (size_t i = 0; i < NBLOCKS; i++)
+                cipher->decrypt(in + i*BLOCKBYTES, out + i*BLOCKBYTES, manx_ctx_rkeys_inv(ctx));
+        t_dec[r] = __rdtsc() - start;
+    }
+    printf("%-20s %10.3f %10.3f\n", cipher->name,
+           (double)NBLOCKS/median(t_enc), (double)NBLOCKS/median(t_dec));
+}
+
+/**
+ * 32-bit fixsliced implementation of the Cortex-M0 port (../../armv6m), whose
+ * header cannot be included alongside block_cipher.h.
+ */
+void aes128_keyschedule_ffs_lut(uint32_t rkeys[88], const unsigned char key[16]);
+void aes128_encrypt_ffs(unsigned char ctext0[16], unsigned char ctext1[16],
+                        const unsigned char ptext0[16], const unsigned char ptext1[16],
+                        const uint32_t rkeys[88]);
+
+/**
+ * Compare the 64-bit fixsliced encryption (4 blocks per call) with the 32-bit
+ * one (2 blocks per call) it is derived from, both compiled for the host.
+ */
+static void bench_fixsliced(const uint8_t key[16])
+{
+    static uint32_t rkeys_ffs32[88];
+    roundkeys_t     rkeys;
+    uint64_t        t_ffs32[RUNS], t_ffs64[RUNS];
+
+    aes128_keyschedule_ffs_lut(rkeys_ffs32, key);
+    aes128_kexp_ffs64(&rkeys, key);
+    for (size_t r = 0; r < RUNS; r++) {
+        uint64_t start = __rdtsc();
+        for (size_t i = 0; i < NBLOCKS; i += 2)
+            aes128_encrypt_ffs(out + i*BLOCKBYTES, out + (i+1)*BLOCKBYTES,
+                               in + i*BLOCKBYTES, in + (i+1)*BLOCKBYTES, rkeys_ffs32);
+        t_ffs32[r] = __rdtsc() - start;
+        start = __rdtsc();
+        for (size_t i = 0; i < NBLOCKS; i += 4)
+            aes128_enc_x4_ffs64(out + i*BLOCKBYTES, in + i*BLOCKBYTES, &rkeys);
+        t_ffs64[r] = __rdtsc() - start;
+    }
+    printf("%-20s %10.4f %10.1f\n", "32-bit (2 blocks)",
+           (double)NBLOCKS/median(t_ffs32), (double)median(t_ffs32)/NBLOCKS);
+    printf("%-20s %10.4f %10.1f\n", "64-bit (4 blocks)",
+           (double)NBLOCKS/median(t_ffs64), (double)median(t_ffs64)/NBLOCKS);
+}
+
+MANX1_FIXED(m1_96_32_30, 96, 32, 30)
+MANX2_FIXED(m2_64_16_32, 64, 16, 32)
+MANX2_FIXED(m2_64_16_96, 64, 16, 96)
+
+/**
+ * Time the formatting of NMSGS messages into input blocks, either through the
+ * generic functions (byte-wise or word-level) or through the ones specialized
+ * for the parameter set.
+ */
+#define BENCH_ENCODING(call)                                                   \
+    do {                                                                       \
+        for (size_t r = 0; r < RUNS; r++) {                                    \
+            uint64_t start = __rdtsc();                                        \
+            for (size_t i = 0; i < NMSGS; i++) {                               \
+                call;                                                          \
+                sink ^= t[0] ^ t[2*BLOCKBYTES-1];                              \
+            }                                                                  \
+            t_enc[r] = __rdtsc() - start;                                      \
+        }                                                                      \
+        printf(" %10.1f", (double)median(t_enc)/NMSGS);                        \
+    } while (0)
+
+static void bench_encoding(void)
+{
+    static uint8_t   n[BLOCKBYTES], a[BLOCKBYTES], m[NMSGS][2*BLOCKBYTES];
+    uint8_t          t[2*BLOCKBYTES] = {0};
+    size_t           nblocks;
+    uint64_t         t_enc[RUNS];
+    volatile uint8_t sink = 0;
+
+    for (size_t i = 0; i < NMSGS; i++)
+        for (size_t j = 0; j < sizeof(m[i]); j++)
+            m[i][j] = (uint8_t)(i + 0x9d*j);
+    printf("%-20s", "byte-wise");
+    BENCH_ENCODING(manx1_init_blocks_bytes(t, n, 96, m[i], 30, a, 32));
+    BENCH_ENCODING(manx2_init_blocks_bytes(t, &nblocks, n, 64, m[i], 32, a, 16));
+    BENCH_ENCODING(manx2_init_blocks_bytes(t, &nblocks, n, 64, m[i], 96, a, 16));
+    printf("\n%-20s", "word-level");
+    BENCH_ENCODING(manx1_init_blocks_words(t, n, 96, m[i], 30, a, 32));
+    BENCH_ENCODING(manx2_init_blocks_words(t, &nblocks, n, 64, m[i], 32, a, 16));
+    BENCH_ENCODING(manx2_init_blocks_words(t, &nblocks, n, 64, m[i], 96, a, 16));
+    printf("\n%-20s", "fixed");
+    BENCH_ENCODING(m1_96_32_30_init_blocks(t, n, a, m[i]));
+    BENCH_ENCODING(m2_64_16_32_init_blocks(t, n, a, m[i]));
+    BENCH_ENCODING(m2_64_16_96_init_blocks(t, n, a, m[i]));
+    printf("\n");
+    (void)nblocks;
+}
+
+/**
+ * Time NMSGS single-message calls (the key being expanded on every call).
+ */
+#define BENCH_CALL(call)                                                       \
+    do {                                                                       \
+        for (size_t r = 0; r < RUNS; r++) {                                    \
+            uint64_t start = __rdtsc();                                        \
+            for (size_t i = 0; i < NMSGS; i++)                                 \
+                sink ^= (call);                                                \
+            t[r] = __rdtsc() - start;                                          \
+        }                                                                      \
+        printf(" %8.1f", (double)median(t)/NMSGS);                             \
+    } while (0)
+
+/**
+ * Compare the generic functions taking the AES-NI functions as pointers with
+ * the ones where they are bound at compile time (see MANX_STATIC_CIPHER).
+ */
+static void bench_binding(const uint8_t key[16])
+{
+    static uint8_t n[BLOCKBYTES], a[BLOCKBYTES], m[2*BLOCKBYTES], p[2*BLOCKBYTES];
+    uint8_t        c1[BLOCKBYTES], c2[2*BLOCKBYTES], c3[2*BLOCKBYTES];
+    size_t         clen1, clen2, clen3, len;
+    uint64_t       t[RUNS];
+    volatile int   sink = 0;
+
+    manx1_enc(c1, &clen1, key, n, 96, m, 30, a, 32, aes128_enc, aes128_kexp);
+    manx2_enc(c2, &clen2, key, n, 64, m, 32, a, 16, aes128_enc, aes128_kexp);
+    manx2_enc(c3, &clen3, key, n, 64, m, 96, a, 16, aes128_enc, aes128_kexp);
+    printf("%-20s", "function pointers");
+    BENCH_CALL(manx1_enc(c1, &len, key, n, 96, m, 30, a, 32, aes128_enc, aes128_kexp));
+    BENCH_CALL(manx1_dec(p, &len, key, n, 96, c1, clen1, a, 32, aes128_enc, aes128_dec, aes128_kexp));
+    BENCH_CALL(manx2_enc(c2, &len, key, n, 64, m, 32, a, 16, aes128_enc, aes128_kexp));
+    BENCH_CALL(manx2_dec(p, &len, key, n, 64, c2, clen2, a, 16, aes128_dec, aes128_kexp));
+    BENCH_CALL(manx2_enc(c3, &len, key, n, 64, m, 96, a, 16, aes128_enc, aes128_kexp));
+    BENCH_CALL(manx2_dec(p, &len, key, n, 64, c3, clen3, a, 16, aes128_dec, aes128_kexp));
+#if MANX_STATIC_BOUND
+    printf("\n%-20s", "static binding");
+    BENCH_CALL(manx1_static_enc(c1, &len, key, n, 96, m, 30, a, 32));
+    BENCH_CALL(manx1_static_dec(p, &len, key, n, 96, c1, clen1, a, 32));
+    BENCH_CALL(manx2_static_enc(c2, &len, key, n, 64, m, 32, a, 16));
+    BENCH_CALL(manx2_static_dec(p, &len, key, n, 64, c2, clen2, a, 16));
+    BENCH_CALL(manx2_static_enc(c3, &len, key, n, 64, m, 96, a, 16));
+    BENCH_CALL(manx2_static_dec(p, &len, key, n, 64, c3, clen3, a, 16));
+#endif
+    printf("%s\n", sink ? " (FAILED)" : "");
+}
+
+/**
+ * Latency of a single call in cycles: median of RUNS calls, each timed on its
+ * own with serialized RDTSC reads, the cost of an empty measurement being
+ * subtracted. prep is run before each call, outside of the measurement.
+ */
+#define BENCH_LATENCY(prep, call)                                              \
+    do {                                                                       \
+        for (size_t r = 0; r < RUNS; r++) {                                    \
+            unsigned int aux;                                                  \
+            prep;                                                              \
+            _mm_lfence();                                                      \
+            uint64_t start = __rdtsc();                                        \
+            _mm_lfence();                                                      \
+            sink ^= (call);                                                    \
+            t[r] = __rdtscp(&aux) - start;                                     \
+            _mm_lfence();                                                      \
+        }                                                                      \
+        uint64_t med = median(t);                                              \
+        printf(" %10.1f", (double)(med > overhead ? med - overhead : 0));      \
+    } while (0)
+
+/**
+ * Online latency of Manx1 encryption (96, 32, 30) with masks precomputed for
+ * the nonce and AD, against the plain functions, and offline cost of a mask
+ * when filling a ring (in cycles per mask).
+ */
+static void bench_precompute(const manx_ctx *ctx, const uint8_t key[16])
+{
+    static uint8_t     n[BLOCKBYTES], a[BLOCKBYTES], m[BLOCKBYTES];
+    static manx1_mask  masks[NMSGS];
+    uint8_t            c[BLOCKBYTES];
+    size_t             len;
+    uint64_t           t[RUNS], overhead;
+    manx1_mask         mask;
+    manx1_ring         ring;
+    const manx_cipher *cipher = ctx->cipher;
+    volatile int       sink = 0;
+
+    for (size_t r = 0; r < RUNS; r++) {
+        unsigned int aux;
+        _mm_lfence();
+        uint64_t start = __rdtsc();
+        _mm_lfence();
+        t[r] = __rdtscp(&aux) - start;
+        _mm_lfence();
+    }
+    overhead = median(t);
+
+    printf("%-20s", cipher->name);
+    BENCH_LATENCY((void)0, manx1_enc(c, &len, key, n, 96, m, 30, a, 32, cipher->encrypt, cipher->kexpand));
+    BENCH_LATENCY((void)0, manx1_ctx_enc(ctx, c, &len, n, 96, m, 30, a, 32));
+    BENCH_LATENCY(manx1_precompute(ctx, &mask, n, 96, a, 32), manx1_enc_precomputed(ctx, &mask, c, &len, m, 30));
+    manx1_ring_init(&ring, ctx, masks, NMSGS, n, 96, a, 32);
+    BENCH_LATENCY(manx1_ring_fill(&ring, 1), manx1_ring_enc(&ring, c, &len, NULL, m, 30));
+    for (size_t r = 0; r < RUNS; r++) {
+        uint64_t start = __rdtsc();
+        manx1_ring_fill(&ring, 0);
+        t[r] = __rdtsc() - start;
+        ring.head = ring.count = 0;
+    }
+    printf(" %10.1f", (double)median(t)/NMSGS);
+    manx1_ring_wipe(&ring);
+    printf("%s\n", sink ? " (FAILED)" : "");
+}
+
+/**
+ * Latency of Manx1 decryption (96, 32, 30) with a window of 16 masks (hit,
+ * miss) against manx1_ctx_dec, then on a stream of NMSGS frames with counter
+ * nonces, 1 out of 16 being lost, the window being refilled by 4 masks after
+ * each frame (outside of the measurement): hit rate and mean latency.
+ */
+static void bench_window(const manx_ctx *ctx)
+{
+    static uint8_t n[NMSGS][BLOCKBYTES], c[NMSGS][BLOCKBYTES];
+    uint8_t        a[BLOCKBYTES] = {0}, m[BLOCKBYTES] = {0}, p[BLOCKBYTES];
+    size_t         len;
+    uint64_t       t[RUNS], overhead, total = 0;
+    manx1_mask     masks[16];
+    manx1_window   win;
+    volatile int   sink = 0;
+
+    for (size_t r = 0; r < RUNS; r++) {
+        unsigned int aux;
+        _mm_lfence();
+        uint64_t start = __rdtsc();
+        _mm_lfence();
+        t[r] = __rdtscp(&aux) - start;
+        _mm_lfence();
+    }
+    overhead = median(t);
+    for (size_t i = 0; i < NMSGS; i++) {
+        n[i][10] = (uint8_t)(i >> 8), n[i][11] = (uint8_t)i;
+        manx1_ctx_enc(ctx, c[i], &len, n[i], 96, m, 30, a, 32);
+    }
+
+    printf("%-20s", ctx->cipher->name);
+    BENCH_LATENCY((void)0, manx1_ctx_dec(ctx, p, &len, n[0], 96, c[0], BLOCKBITS, a, 32));
+    manx1_window_init(&win, ctx, masks, 16, n[0], 96, a, 32);
+    manx1_window_fill(&win, 0);
+    BENCH_LATENCY((void)0, manx1_window_dec(&win, p, &len, n[0], 96, c[0], BLOCKBITS, a, 32));
+    BENCH_LATENCY((void)0, manx1_window_dec(&win, p, &len, n[100], 96, c[100], BLOCKBITS, a, 32));
+
+    manx1_window_init(&win, ctx, masks, 16, n[0], 96, a, 32);
+    manx1_window_fill(&win, 0);
+    size_t frames = 0;
+    for (size_t i = 0; i < NMSGS; i++) {
+        unsigned int aux;
+        if (i % 16 == 5)
+            continue;
+        _mm_lfence();
+        uint64_t start = __rdtsc();
+        _mm_lfence();
+        sink ^= manx1_window_dec(&win, p, &len, n[i], 96, c[i], BLOCKBITS, a, 32);
+        uint64_t stop = __rdtscp(&aux) - start;
+        _mm_lfence();
+        total += (stop > overhead) ? stop - overhead : 0;
+        frames++;
+        manx1_window_fill(&win, 4);
+    }
+    printf(" %9.1f%% %10.1f", 100.0*win.hits/frames, (double)total/frames);
+    manx1_window_wipe(&win);
+    printf("%s\n", sink ? " (FAILED)" : "");
+}
+
+/**
+ * Latency of the encryption of a message with a counter nonce through a
+ * stream, whose blocks are patched from templates, against the context
+ * functions which encode them from scratch.
+ */
+static void bench_stream(const manx_ctx *ctx)
+{
+    static uint8_t n[BLOCKBYTES], a[BLOCKBYTES], m[2*BLOCKBYTES];
+    uint8_t        c[2*BLOCKBYTES];
+    size_t         len;
+    uint64_t       t[RUNS], overhead;
+    manx1_stream   st1;
+    manx2_stream   st2;
+    volatile int   sink = 0;
+
+    for (size_t r = 0; r < RUNS; r++) {
+        unsigned int aux;
+        _mm_lfence();
+        uint64_t start = __rdtsc();
+        _mm_lfence();
+        t[r] = __rdtscp(&aux) - start;
+        _mm_lfence();
+    }
+    overhead = median(t);
+
+    printf("%-20s", ctx->cipher->name);
+    manx1_stream_init(&st1, ctx, n, 96, a, 32);
+    BENCH_LATENCY((void)0, manx1_ctx_enc(ctx, c, &len, n, 96, m, 30, a, 32));
+    BENCH_LATENCY((void)0, manx1_stream_enc(&st1, c, &len, NULL, m, 30));
+    manx2_stream_init(&st2, ctx, n, 64, a, 16);
+    BENCH_LATENCY((void)0, manx2_ctx_enc(ctx, c, &len, n, 64, m, 32, a, 16));
+    BENCH_LATENCY((void)0, manx2_stream_enc(&st2, c, &len, NULL, m, 32));
+    BENCH_LATENCY((void)0, manx2_ctx_enc(ctx, c, &len, n, 64, m, 96, a, 16));
+    BENCH_LATENCY((void)0, manx2_stream_enc(&st2, c, &len, NULL, m, 96));
+    manx1_stream_wipe(&st1);
+    manx2_stream_wipe(&st2);
+    printf("%s\n", sink ? " (FAILED)" : "");
+}
+
+/**
+ * Latency of Manx2 decryption with a cache of pre-encoded headers (holding
+ * the AD of the ciphertexts) against manx2_ctx_dec.
+ */
+static void bench_ad_cache(const manx_ctx *ctx)
+{
+    static uint8_t n[BLOCKBYTES], a[BLOCKBYTES], m[2*BLOCKBYTES];
+    uint8_t        c2[2*BLOCKBYTES], c3[2*BLOCKBYTES], p[2*BLOCKBYTES];
+    size_t         clen2, clen3, len;
+    uint64_t       t[RUNS], overhead;
+    manx2_ad_entry entries[4];
+    manx2_ad_cache cache;
+    volatile int   sink = 0;
+
+    for (size_t r = 0; r < RUNS; r++) {
+        unsigned int aux;
+        _mm_lfence();
+        uint64_t start = __rdtsc();
+        _mm_lfence();
+        t[r] = __rdtscp(&aux) - start;
+        _mm_lfence();
+    }
+    overhead = median(t);
+    manx2_ctx_enc(ctx, c2, &clen2, n, 64, m, 32, a, 16);
+    manx2_ctx_enc(ctx, c3, &clen3, n, 64, m, 96, a, 16);
+    manx2_ad_cache_init(&cache, entries, 4);
+
+    printf("%-20s", ctx->cipher->name);
+    BENCH_LATENCY((void)0, manx2_ctx_dec(ctx, p, &len, n, 64, c2, clen2, a, 16));
+    BENCH_LATENCY((void)0, manx2_ctx_dec_cached(ctx, &cache, p, &len, n, 64, c2, clen2, a, 16));
+    BENCH_LATENCY((void)0, manx2_ctx_dec(ctx, p, &len, n, 64, c3, clen3, a, 16));
+    BENCH_LATENCY((void)0, manx2_ctx_dec_cached(ctx, &cache, p, &len, n, 64, c3, clen3, a, 16));
+    printf(" %9.1f%%", 100.0*cache.hits/(cache.hits + cache.misses));
+    manx2_ad_cache_wipe(&cache);
+    printf("%s\n", sink ? " (FAILED)" : "");
+}
+
+/**
+ * Caches of expanded keys: the key of device id is the benchmark key with id
+ * in its first bytes.
+ */
+#define KC_DEVICES 4096
+#define KC_HOT     256
+#define KC_ENTRIES 256
+
+static const uint8_t *kc_master;
+
+static int kc_load(void *arg, uint64_t id, uint8_t key[KEYBYTES])
+{
+    (void)arg;
+    memcpy(key, kc_master, KEYBYTES);
+    memcpy(key, &id, sizeof(id));
+    return 0;
+}
+
+/**
+ * Latency of Manx1 decryption (96, 32, 30) for a device whose key is given,
+ * i.e. expanded on every message, against a cached one (hit, and miss with
+ * the key fetched by the loader and expanded by the cache), then average
+ * cost and hit rate over NMSGS messages from KC_DEVICES devices (9 out of 10
+ * from KC_HOT of them)
+ * within the budget of KC_ENTRIES contexts of sizeof(manx_ctx) bytes (the
+ * smaller contexts of the on-the-fly implementation fitting more of them).
+ */
+static void bench_keycache(const manx_cipher *cipher, const uint8_t key[16])
+{
+    static uint8_t      n[BLOCKBYTES], a[BLOCKBYTES], m[BLOCKBYTES], p[BLOCKBYTES];
+    static uint8_t      c[NMSGS][BLOCKBYTES];
+    static uint64_t     ids[NMSGS];
+    size_t              clen, len;
+    uint64_t            t[RUNS], overhead, seed = 1;
+    manx_keycache      *cache;
+    manx_keycache_stats st;
+    manx_ctx            ctx;
+    uint8_t             dkey[KEYBYTES];
+    volatile int        sink = 0;
+
+    for (size_t r = 0; r < RUNS; r++) {
+        unsigned int aux;
+        _mm_lfence();
+        uint64_t start = __rdtsc();
+        _mm_lfence();
+        t[r] = __rdtscp(&aux) - start;
+        _mm_lfence();
+    }
+    overhead  = median(t);
+    kc_master = key;
+    cache     = manx_keycache_create(KC_ENTRIES*(sizeof(manx_ctx) + 64), 0, cipher, kc_load, NULL);
+    if (cache == NULL) {
+        printf("%-20s (FAILED)\n", cipher->name);
+        return;
+    }
+    for (size_t i = 0; i < NMSGS; i++) {
+        seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+        ids[i] = (seed >> 33) % 10 ? (seed >> 13) % KC_HOT : (seed >> 13) % KC_DEVICES;
+        sink |= manx1_cached_enc(cache, ids[i], c[i], &clen, n, 96, m, 30, a, 32);
+    }
+    manx_keycache_stats_get(cache, &st, 1);
+
+    printf("%-20s", cipher->name);
+    BENCH_LATENCY((void)0, kc_load(NULL, ids[0], dkey) | manx_ctx_init(&ctx, dkey, cipher) |
+                  manx1_ctx_dec(&ctx, p, &len, n, 96, c[0], clen, a, 32));
+    BENCH_LATENCY((void)0, manx1_cached_dec(cache, ids[0], p, &len, n, 96, c[0], clen, a, 32));
+    BENCH_LATENCY(manx_keycache_invalidate(cache, ids[0]),
+                  manx1_cached_dec(cache, ids[0], p, &len, n, 96, c[0], clen, a, 32));
+    manx_keycache_stats_get(cache, &st, 1);
+    uint64_t start = __rdtsc();
+    for (size_t i = 0; i < NMSGS; i++)
+        sink |= manx1_cached_dec(cache, ids[i], p, &len, n, 96, c[i], clen, a, 32);
+    printf(" %10.1f", (double)(__rdtsc() - start)/NMSGS);
+    manx_keycache_stats_get(cache, &st, 0);
+    printf(" %9.1f%%", 100.0*st.hits/(st.hits + st.misses));
+    manx_ctx_wipe(&ctx);
+    manx_keycache_destroy(cache);
+    printf("%s\n", sink ? " (FAILED)" : "");
+}
+
+/**
+ * Cost of Manx1 (96, 32, 30) in cycles per message when each message relies
+ * on a key picked at random among nkeys, a new sequence of keys being drawn
+ * for each run: with a Manx context per key, its round keys being expanded
+ * (AES-NI) or computed on the fly (a single cache line per context, the
+ * contexts being packed by manx_ctx_size), or with 16-byte keys only, passed
+ * to manx1_enc and manx1_dec along with the AES-NI functions (the key being
+ * expanded for each message). The larger nkeys, the more the key material is
+ * evicted from the caches between two messages relying on the same key.
+ */
+static void bench_otf(const uint8_t key[16], size_t nkeys)
+{
+    static uint8_t n[BLOCKBYTES], a[BLOCKBYTES], m[BLOCKBYTES], p[BLOCKBYTES];
+    static size_t  ids[NMSGS];
+    uint8_t        (*keys)[16] = malloc(nkeys*16);
+    uint8_t        (*c)[BLOCKBYTES] = malloc(nkeys*BLOCKBYTES);
+    uint8_t       *ctxs = aligned_alloc(64, nkeys*sizeof(manx_ctx));
+    size_t         clen, len;
+    uint64_t       t_enc[RUNS], t_dec[RUNS], seed = 1;
+    volatile int   sink = 0;
+
+    if (keys == NULL || c == NULL || ctxs == NULL) {
+        printf("%-20s (FAILED)\n", "");
+        free(keys), free(c), free(ctxs);
+        return;
+    }
+    for (size_t k = 0; k < nkeys; k++) {
+        memcpy(keys[k], key, 16);
+        memcpy(keys[k], &k, sizeof(k));
+        manx1_enc(c[k], &clen, keys[k], n, 96, m, 30, a, 32, aes128_enc, aes128_kexp);
+    }
+    printf("%-20zu", nkeys);
+
+#define BENCH_KEYS(t, call)                                                    \
+    do {                                                                       \
+        for (size_t r = 0; r < RUNS; r++) {                                    \
+            for (size_t i = 0; i < NMSGS; i++) {                               \
+                seed   = seed*6364136223846793005ULL + 1442695040888963407ULL; \
+                ids[i] = (seed >> 33) % nkeys;                                 \
+            }                                                                  \
+            uint64_t start = __rdtsc();                                        \
+            for (size_t i = 0; i < NMSGS; i++) {                               \
+                size_t k = ids[i];                                             \
+                sink |= (call);                                                \
+            }                                                                  \
+            t[r] = __rdtsc() - start;                                          \
+        }                                                                      \
+    } while (0)
+
+    static const aes128_impl impls[] = { AES128_IMPL_AESNI, AES128_IMPL_AESNI_OTF };
+    for (size_t j = 0; j < sizeof(impls)/sizeof(impls[0]); j++) {
+        const manx_cipher *cipher = aes128_cipher(impls[j]);
+        size_t             size   = manx_ctx_size(cipher);
+#define CTX(k) ((manx_ctx *)(ctxs + (k)*size))
+        for (size_t k = 0; k < nkeys; k++) {
+            manx_ctx_init(CTX(k), keys[k], cipher);
+            manx_ctx_rkeys_inv(CTX(k));
+        }
+        BENCH_KEYS(t_enc, manx1_ctx_enc(CTX(k), p, &len, n, 96, m, 30, a, 32));
+        BENCH_KEYS(t_dec, manx1_ctx_dec(CTX(k), p, &len, n, 96, c[k], clen, a, 32));
+        printf(" %8.1f %8.1f", (double)median(t_enc)/NMSGS, (double)median(t_dec)/NMSGS);
+        for (size_t k = 0; k < nkeys; k++)
+            manx_ctx_wipe(CTX(k));
+#undef CTX
+    }
+    BENCH_KEYS(t_enc, manx1_enc(p, &len, keys[k], n, 96, m, 30, a, 32, aes128_enc, aes128_kexp));
+    BENCH_KEYS(t_dec, manx1_dec(p, &len, keys[k], n, 96, c[k], clen, a, 32,
+                                aes128_enc, aes128_dec, aes128_kexp));
+    printf(" %8.1f %8.1f", (double)median(t_enc)/NMSGS, (double)median(t_dec)/NMSGS);
+#undef BENCH_KEYS
+
+    free(keys), free(c), free(ctxs);
+    printf("%s\n", sink ? " (FAILED)" : "");
+}
+
+int main(void) {
+    uint8_t  key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    manx_ctx ctx;
+
+    printf("AES-128 implementation selected: %s\n\n", aes128_cipher_best()->name);
+
+    printf("%-20s %10s %10s\n", "blocks/cycle", "enc", "dec");
+    for (int i = 0; i < AES128_IMPL_COUNT; i++) {
+        if (!aes128_impl_supported(i))
+            continue;
+        manx_ctx_init(&ctx, key, aes128_cipher(i));
+        bench_blocks(&ctx);
+    }
+
+    printf("\n%-20s %10s %10s\n", "fixsliced enc", "blocks/cyc", "cyc/block");
+    bench_fixsliced(key);
+
+    bench_batch_header();
+    for (int i = 0; i < AES128_IMPL_COUNT; i++) {
+        if (!aes128_impl_supported(i))
+            continue;
+        manx_ctx_init(&ctx, key, aes128_cipher(i));
+        bench_batch(&ctx);
+    }
+
+    printf("\n%-20s %10s %10s %10s %10s %10s\n", "manx1 (96,32,30)", "manx1_enc",
+           "ctx_enc", "precomp.", "ring_enc", "ring_fill");
+    printf("%-20s %10s %10s %10s %10s %10s\n", "cycles (latency)", "", "", "(online)",
+           "(online)", "(per mask)");
+    for (int i = 0; i < AES128_IMPL_COUNT; i++) {
+        if (!aes128_impl_supported(i))
+            continue;
+        manx_ctx_init(&ctx, key, aes128_cipher(i));
+        bench_precompute(&ctx, key);
+    }
+
+    printf("\n%-20s %10s %10s %10s %10s %10s\n", "manx1 (96,32,30)", "ctx_dec",
+           "window", "window", "stream", "stream");
+    printf("%-20s %10s %10s %10s %10s %10s\n", "cycles (latency)", "", "(hit)", "(miss)",
+           "hit rate", "cyc/frame");
+    for (int i = 0; i < AES128_IMPL_COUNT; i++) {
+        if (!aes128_impl_supported(i))
+            continue;
+        manx_ctx_init(&ctx, key, aes128_cipher(i));
+        bench_window(&ctx);
+    }
+
+    printf("\n%-20s %21s %21s %21s\n", "cycles (latency)", "manx1 (96,32,30)",
+           "manx2 (64,16,32)", "manx2 (64,16,96)");
+    printf("%-20s %10s %10s %10s %10s %10s %10s\n", "(counter nonces)", "ctx_enc", "stream",
+           "ctx_enc", "stream", "ctx_enc", "stream");
+    for (int i = 0; i < AES128_IMPL_COUNT; i++) {
+        if (!aes128_impl_supported(i))
+            continue;
+        manx_ctx_init(&ctx, key, aes128_cipher(i));
+        bench_stream(&ctx);
+    }
+
+    printf("\n%-20s %21s %21s %10s\n", "cycles (latency)", "manx2 (64,16,32)",
+           "manx2 (64,16,96)", "");
+    printf("%-20s %10s %10s %10s %10s %10s\n", "(AD cache)", "ctx_dec", "cached",
+           "ctx_dec", "cached", "hit rate");
+    for (int i = 0; i < AES128_IMPL_COUNT; i++) {
+        if (!aes128_impl_supported(i))
+            continue;
+        manx_ctx_init(&ctx, key, aes128_cipher(i));
+        bench_ad_cache(&ctx);
+    }
+
+    printf("\n%-20s %10s %10s %10s %10s %10s\n", "manx1 (96,32,30)", "key +", "cached",
+           "cached", "devices", "devices");
+    printf("%-20s %10s %10s %10s %10s %10s\n", "cycles (key cache)", "ctx_dec", "(hit)",
+           "(miss)", "cyc/msg", "hit rate");
+    for (int i = 0; i < AES128_IMPL_COUNT; i++)
+        if (aes128_impl_supported(i))
+            bench_keycache(aes128_cipher(i), key);
+
+    if (aes128_impl_supported(AES128_IMPL_AESNI)) {
+        printf("\n%-20s %17s %17s %17s\n", "manx1 (96,32,30)", "ctx (expanded)",
+               "ctx (on-the-fly)", "key (expanded)");
+        printf("%-20s %8s %8s %8s %8s %8s %8s\n", "keys (cycles/msg)", "enc", "dec",
+               "enc", "dec", "enc", "dec");
+        static const size_t nkeys[] = { 64, 4096, 16384, 131072 };
+        for (size_t i = 0; i < sizeof(nkeys)/sizeof(nkeys[0]); i++)
+            bench_otf(key, nkeys[i]);
+    }
+
+    printf("\n%-20s %10s %10s %10s\n", "encoding cycles/msg", "manx1", "manx2", "manx2");
+    printf("%-20s %10s %10s %10s\n", "", "(96,32,30)", "(64,16,32)", "(64,16,96)");
+    bench_encoding();
+
+    printf("\n%-20s %17s %17s %17s\n", "cycles/message", "manx1 (96,32,30)",
+           "manx2 (64,16,32)", "manx2 (64,16,96)");
+    printf("%-20s %8s %8s %8s %8s %8s %8s\n", "(with key expansion)", "enc", "dec", "enc", "dec", "enc", "dec");
+    bench_binding(key);
+
+    return 0;
+}
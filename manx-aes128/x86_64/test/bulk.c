@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../manx.h"
+#include "../manx-bulk.h"
+#include "../dispatch.h"
+
+/**
+ * Scaling of the bulk functions from 1 to N threads (N being given as first
+ * argument, the number of online processors by default): NMSGS records are
+ * encrypted then decrypted with Manx1 (96, 32, 30) and Manx2 (64, 16, 96),
+ * the best of RUNS runs being reported in millions of messages per second,
+ * along with the speedup with respect to one thread. The outputs are checked
+ * against the ones of the single-threaded run.
+ */
+#define RUNS  5
+#define NMSGS (1 << 20)
+
+typedef struct {
+    manx_bulk_mode mode;
+    const char    *name;
+    size_t         nlen, alen, mlen;
+} params_t;
+
+static const params_t params[] = {
+    { MANX_BULK_MANX1, "manx1 (96,32,30)", 96, 32, 30 },
+    { MANX_BULK_MANX2, "manx2 (64,16,96)", 64, 16, 96 },
+};
+
+static uint8_t  nonces[NMSGS][12], ad[BLOCKBYTES];
+static uint8_t  m[NMSGS][BLOCKBYTES], c[NMSGS][2*BLOCKBYTES], p[NMSGS][BLOCKBYTES];
+static uint8_t  ref[NMSGS][2*BLOCKBYTES];
+static size_t   clen[NMSGS];
+static manx_msg msgs[NMSGS];
+
+static double now(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec*1e-9;
+}
+
+/**
+ * Best time of RUNS bulk operations over the whole array.
+ */
+static double bench_op(manx_pool *pool, const manx_ctx *ctx, const params_t *par,
+            int dec, size_t *failed)
+{
+    double best = 1e9;
+
+    for (int r = 0; r < RUNS; r++) {
+        for (size_t i = 0; i < NMSGS; i++) {
+            msgs[i] = (manx_msg){ .n = nonces[i], .nlen = par->nlen, .a = ad, .alen = par->alen,
+                .in = dec ? c[i] : m[i], .inlen = dec ? clen[i] : par->mlen,
+                .out = dec ? p[i] : c[i] };
+        }
+        double start = now();
+        *failed = dec ? manx_bulk_dec(pool, ctx, par->mode, msgs, NMSGS)
+                      : manx_bulk_enc(pool, ctx, par->mode, msgs, NMSGS);
+        double t = now() - start;
+        best = (t < best) ? t : best;
+    }
+    if (!dec)
+        for (size_t i = 0; i < NMSGS; i++)
+            clen[i] = msgs[i].outlen;
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    uint8_t  key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    size_t   maxthreads = (argc > 1) ? strtoul(argv[1], NULL, 10) : 0;
+    manx_ctx ctx;
+
+    if (maxthreads == 0) {
+        manx_pool *pool = manx_pool_create(0);
+        maxthreads = manx_pool_size(pool);
+        manx_pool_destroy(pool);
+    }
+    manx_ctx_init(&ctx, key, aes128_cipher_best());
+    printf("AES-128 implementation selected: %s\n", ctx.cipher->name);
+    printf("%zu messages per run, chunks of %d messages\n\n", (size_t)NMSGS, MANX_BULK_CHUNK);
+    for (size_t i = 0; i < NMSGS; i++) {
+        memcpy(nonces[i], &i, sizeof(i));
+        for (size_t j = 0; j < BLOCKBYTES; j++)
+            m[i][j] = (uint8_t)(i + 0x9d*j);
+    }
+
+    for (size_t k = 0; k < sizeof(params)/sizeof(params[0]); k++) {
+        const params_t *par = &params[k];
+        double          base_enc = 0, base_dec = 0;
+
+        printf("%-20s %8s %10s %8s %10s %8s\n", par->name, "threads", "enc Mmsg/s",
+               "speedup", "dec Mmsg/s", "speedup");
+        for (size_t nt = 1; nt <= maxthreads; nt++) {
+            manx_pool *pool = manx_pool_create(nt);
+            size_t     fenc, fdec;
+            int        ok = 1;
+
+            if (pool == NULL) {
+                fprintf(stderr, "manx_pool_create(%zu) failed\n", nt);
+                return 1;
+            }
+            double t_enc = bench_op(pool, &ctx, par, 0, &fenc);
+            if (nt == 1)
+                memcpy(ref, c, sizeof(c));
+            else
+                ok = memcmp(ref, c, sizeof(c)) == 0;
+            double t_dec = bench_op(pool, &ctx, par, 1, &fdec);
+            if (nt == 1)
+                base_enc = t_enc, base_dec = t_dec;
+            printf("%-20s %8zu %10.2f %8.2f %10.2f %8.2f%s\n", "", nt,
+                   NMSGS/t_enc*1e-6, base_enc/t_enc, NMSGS/t_dec*1e-6, base_dec/t_dec,
+                   (ok && fenc == 0 && fdec == 0) ? "" : " (FAILED)");
+            manx_pool_destroy(pool);
+        }
+        printf("\n");
+    }
+    manx_ctx_wipe(&ctx);
+    return 0;
+}
@@ -0,0 +1,874 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../manx.h"
+#include "../manx-fixed.h"
+#include "../dispatch.h"
+#include "../manx-bulk.h"
+#include "../manx-keycache.h"
+#include "manx-check.h"
+
+static void check_inv(const manx_ctx *ctx)
+{
+    uint8_t block[BLOCKBYTES], ref[BLOCKBYTES], out[BLOCKBYTES];
+
+    fill(block, sizeof(block), 0x42);
+    aes128_dec(ref, block, &ctx->rkeys);
+    aes128_dec_inv(out, block, manx_ctx_rkeys_inv(ctx));
+    check(memcmp(ref, out, sizeof(out)) == 0, "aes128_dec_inv matches aes128_dec");
+    check(manx_ctx_rkeys_inv(ctx) == &ctx->rkeys_inv, "decryption round keys derived once");
+}
+
+/**
+ * The standard round keys of all implementations should match the ones
+ * computed in C (the fixsliced ones, stored instead of the standard ones for
+ * encryption, are covered by the block checks).
+ */
+static void check_rkeys(const manx_ctx *ctx, const uint8_t key[16])
+{
+    roundkeys_t rkeys, rkeys_inv;
+
+    aes128_kexp_c(&rkeys, key);
+    aes128_kexp_inv_c(&rkeys_inv, &rkeys);
+    if (ctx->cipher->kexpand != aes128_kexp_ffs64)
+        check(memcmp(rkeys.rk, ctx->rkeys.rk, sizeof(rkeys.rk)) == 0, "round keys match aes128_kexp_c");
+    check(memcmp(rkeys_inv.rk, manx_ctx_rkeys_inv(ctx)->rk, sizeof(rkeys.rk)) == 0,
+          "decryption round keys match aes128_kexp_inv_c");
+}
+
+/**
+ * The on-the-fly implementation only stores the key and the last round key in
+ * a 48-byte context, its functions being checked against the AES-NI ones with
+ * the expanded keys.
+ */
+static void check_otf(const manx_ctx *ctx, const uint8_t key[16])
+{
+    const manx_cipher *cipher = ctx->cipher;
+    roundkeys_t        rkeys, rkeys_inv;
+    roundkeys_otf_t    otf, otf_inv;
+    uint8_t            in[37*BLOCKBYTES], ref[37*BLOCKBYTES], out[37*BLOCKBYTES];
+    int                ok = 1;
+
+    aes128_kexp_c(&rkeys, key);
+    aes128_kexp_inv(&rkeys_inv, &rkeys);
+    check(manx_ctx_size(cipher) == 48, "manx_ctx_size of the on-the-fly implementation");
+    check(memcmp(&ctx->rkeys, key, 16) == 0, "key stored as is");
+    check((const uint8_t *)manx_ctx_rkeys_inv(ctx) == (const uint8_t *)&ctx->rkeys + 16,
+          "last round key stored right after the key");
+    check(memcmp(manx_ctx_rkeys_inv(ctx), &rkeys.rk[10], 16) == 0,
+          "last round key stored for decryption");
+    aes128_kexp_otf(&otf, key);
+    aes128_kexp_inv_otf(&otf_inv, &otf);
+    fill(in, sizeof(in), 0x42);
+    for (size_t nblocks = 0; nblocks <= 37; nblocks++) {
+        for (size_t i = 0; i < nblocks; i++)
+            aes128_enc(ref + i*BLOCKBYTES, in + i*BLOCKBYTES, &rkeys);
+        cipher->encrypt_blocks(out, in, nblocks, &ctx->rkeys);
+        ok &= memcmp(ref, out, nblocks*BLOCKBYTES) == 0;
+        for (size_t i = 0; i < nblocks; i++)
+            cipher->encrypt(out + i*BLOCKBYTES, in + i*BLOCKBYTES, &ctx->rkeys);
+        ok &= memcmp(ref, out, nblocks*BLOCKBYTES) == 0;
+        aes128_enc_blocks_otf(out, in, nblocks, &otf);
+        ok &= memcmp(ref, out, nblocks*BLOCKBYTES) == 0;
+        for (size_t i = 0; i < nblocks; i++)
+            aes128_dec_inv(ref + i*BLOCKBYTES, in + i*BLOCKBYTES, &rkeys_inv);
+        cipher->decrypt_blocks(out, in, nblocks, manx_ctx_rkeys_inv(ctx));
+        ok &= memcmp(ref, out, nblocks*BLOCKBYTES) == 0;
+        for (size_t i = 0; i < nblocks; i++)
+            cipher->decrypt(out + i*BLOCKBYTES, in + i*BLOCKBYTES, manx_ctx_rkeys_inv(ctx));
+        ok &= memcmp(ref, out, nblocks*BLOCKBYTES) == 0;
+        for (size_t i = 0; i < nblocks; i++)
+            aes128_dec_otf(out + i*BLOCKBYTES, in + i*BLOCKBYTES, &otf_inv);
+        ok &= memcmp(ref, out, nblocks*BLOCKBYTES) == 0;
+    }
+    check(ok, "on-the-fly functions match aes128_enc and aes128_dec_inv");
+
+    // contexts packed by manx_ctx_size, the decryption round keys being derived
+    // while the neighbouring contexts are in use
+    size_t   size = manx_ctx_size(cipher);
+    uint8_t *ctxs = aligned_alloc(_Alignof(manx_ctx), 4*size);
+    uint8_t  n[BLOCKBYTES], a[BLOCKBYTES], m[2*BLOCKBYTES], c[2*BLOCKBYTES], c_ref[2*BLOCKBYTES];
+    size_t   clen, clen_ref, plen;
+    if (ctxs == NULL) {
+        check(0, "contexts packed by manx_ctx_size");
+        return;
+    }
+    ok = 1;
+    fill(n, sizeof(n), 1);
+    fill(a, sizeof(a), 2);
+    fill(m, sizeof(m), 3);
+    for (size_t k = 0; k < 4; k++)
+        ok &= manx_ctx_init((manx_ctx *)(ctxs + k*size), key, cipher) == 0;
+    for (size_t k = 0; k < 4; k++) {
+        const manx_ctx *packed = (const manx_ctx *)(ctxs + k*size);
+        ok &= manx1_ctx_enc(packed, c, &clen, n, 96, m, 30, a, 32) == 0;
+        ok &= manx1_ctx_enc(ctx, c_ref, &clen_ref, n, 96, m, 30, a, 32) == 0;
+        ok &= (clen == clen_ref) && memcmp(c, c_ref, clen/8) == 0;
+        ok &= manx1_ctx_dec(packed, out, &plen, n, 96, c, clen, a, 32) == 0 && bits_equal(out, m, 30);
+        ok &= manx2_ctx_enc(packed, c, &clen, n, 64, m, 96, a, 16) == 0;
+        ok &= manx2_ctx_enc(ctx, c_ref, &clen_ref, n, 64, m, 96, a, 16) == 0;
+        ok &= (clen == clen_ref) && memcmp(c, c_ref, clen/8) == 0;
+        ok &= manx2_ctx_dec(packed, out, &plen, n, 64, c, clen, a, 16) == 0 && bits_equal(out, m, 96);
+    }
+    for (size_t k = 0; k < 4; k++)
+        manx_ctx_wipe((manx_ctx *)(ctxs + k*size));
+    for (size_t i = 0; i < 4*size; i++)
+        ok &= ctxs[i] == 0;
+    free(ctxs);
+    check(ok, "contexts packed by manx_ctx_size");
+}
+
+/**
+ * Round keys of each implementation (see check_rkeys and check_otf).
+ */
+static void check_impl(const check_suite *suite, const manx_ctx *ctx, const uint8_t key[16])
+{
+    (void)suite;
+    if (ctx->cipher == aes128_cipher(AES128_IMPL_AESNI_OTF))
+        check_otf(ctx, key);
+    else
+        check_rkeys(ctx, key);
+}
+
+/**
+ * Known-answer ciphertexts for the toy example in main.c.
+ */
+static const check_suite suite = {
+    .kexpand            = aes128_kexp,
+    .encrypt            = aes128_enc,
+    .decrypt            = aes128_dec,
+    .kat_manx1_96_30_64 = "60bc7d2ed795cd6a29666588a66aad75",
+    .kat_manx1_128_63_0 = "f98151c4dca6e92eb49cfd199b091e33",
+    .kat_manx2_64_96_0  = "dd5ce9cf9de8c3a2a0f83cc447a636a434340e90c28a4f9c03c55e6a66b0bbb0",
+    .sweep_manx1        = 0x23f0324f0f134db6ULL,
+    .sweep_manx2        = 0x9025178bce9c9a64ULL,
+    .check_impl         = check_impl,
+};
+
+static void check_blocks(const manx_ctx *ctx)
+{
+    check(check_blocks_with(&suite, ctx, &ctx->rkeys, aes128_enc_blocks_vaes, aes128_dec_inv_blocks_vaes),
+          "aes128_enc_blocks_vaes and aes128_dec_inv_blocks_vaes match aes128_enc and aes128_dec");
+}
+
+/**
+ * Increment a nonce of nlen bits bit by bit, as a reference for the rings.
+ */
+static void nonce_inc_ref(uint8_t n[], size_t nlen)
+{
+    for (size_t i = nlen; i-- > 0; ) {
+        n[i/8] ^= 0x80 >> (i%8);
+        if (n[i/8] & (0x80 >> (i%8)))
+            break;
+    }
+}
+
+/**
+ * Precomputed masks and rings of masks against manx1_ctx_enc.
+ */
+static void check_precompute(const manx_ctx *ctx)
+{
+    uint8_t    n[BLOCKBYTES], a[BLOCKBYTES], m[BLOCKBYTES], ref[BLOCKBYTES], c[BLOCKBYTES];
+    uint8_t    nr[BLOCKBYTES], p[BLOCKBYTES];
+    size_t     reflen, clen, plen;
+    manx1_mask mask, masks[5];
+    manx1_ring ring;
+    int        ok = 1, ok_ring = 1;
+
+    for (size_t nlen = 0; nlen <= BLOCKBITS; nlen += 3) {
+        for (size_t alen = 0; alen <= MANX1_ALPHAMAX; alen += 5) {
+            fill(n, sizeof(n), nlen);
+            fill(a, sizeof(a), alen + 7);
+            int ret = manx1_precompute(ctx, &mask, n, nlen, a, alen);
+            for (size_t mlen = 0; mlen < BLOCKBITS; mlen += 7) {
+                fill(m, sizeof(m), mlen + 13);
+                int ref_ret = manx1_ctx_enc(ctx, ref, &reflen, n, nlen, m, mlen, a, alen);
+                if (ret) {
+                    ok &= (ref_ret != 0);
+                    continue;
+                }
+                int pre_ret = manx1_enc_precomputed(ctx, &mask, c, &clen, m, mlen);
+                ok &= (pre_ret == ref_ret) && (clen == reflen);
+                ok &= ref_ret || bits_equal(c, ref, clen);
+                if (ref_ret)
+                    continue;
+                // decryption of the genuine ciphertext, then of a forged one
+                for (int forged = 0; forged < 2; forged++) {
+                    size_t plen_ref;
+                    uint8_t p_ref[BLOCKBYTES];
+                    c[mlen % BLOCKBYTES] ^= forged;
+                    int dec_ref = manx1_ctx_dec(ctx, p_ref, &plen_ref, n, nlen, c, clen, a, alen);
+                    int dec_pre = manx1_dec_precomputed(ctx, &mask, p, &plen, c, clen);
+                    ok &= (dec_pre == dec_ref) && (plen == plen_ref) && ((dec_ref != 0) == forged);
+                    ok &= dec_ref || bits_equal(p, p_ref, plen);
+                }
+            }
+        }
+    }
+    check(ok, "manx1_enc_precomputed and manx1_dec_precomputed match manx1_ctx_enc and manx1_ctx_dec");
+
+    // counter nonces (wrapping around for the 7-bit one), with masks computed
+    // in advance, one at a time and on the fly when the ring is empty
+    static const size_t nlens[] = { 7, 61, 96 };
+    for (size_t k = 0; k < sizeof(nlens)/sizeof(nlens[0]); k++) {
+        size_t nlen = nlens[k];
+
+        memset(n, 0xff, sizeof(n));
+        n[(nlen - 1)/8] -= 3 << (7 - (nlen - 1)%8);
+        if (nlen % 8)
+            n[(nlen - 1)/8] &= 0xff << (8 - nlen%8);
+        fill(a, sizeof(a), 0x5a);
+        ok_ring &= manx1_ring_init(&ring, ctx, masks, 5, n, nlen, a, 24) == 0;
+        ok_ring &= manx1_ring_fill(&ring, 3) == 3;
+        for (size_t i = 0; i < 16; i++) {
+            size_t mlen = (5*i + nlen) % 31;
+            fill(m, sizeof(m), i);
+            if (i % 8 == 1) {
+                size_t ready = ring.count;
+                ok_ring &= manx1_ring_fill(&ring, 0) == 5 - ready;
+            }
+            ok_ring &= manx1_ring_enc(&ring, c, &clen, nr, m, mlen) == 0;
+            ok_ring &= bits_equal(nr, n, nlen);
+            ok_ring &= manx1_ctx_dec(ctx, p, &plen, n, nlen, c, clen, a, 24) == 0;
+            ok_ring &= plen == mlen && bits_equal(p, m, mlen);
+            nonce_inc_ref(n, nlen);
+        }
+        // the mask is kept if the message is too long
+        ok_ring &= manx1_ring_enc(&ring, c, &clen, nr, m, BLOCKBITS) != 0;
+        ok_ring &= manx1_ring_enc(&ring, c, &clen, nr, m, 0) == 0 && bits_equal(nr, n, nlen);
+        manx1_ring_wipe(&ring);
+    }
+    check(ok_ring, "manx1 rings of masks match manx1_ctx_dec with counter nonces");
+}
+
+/**
+ * Windows of masks on a stream of counter nonces (wrapping around for the
+ * 8-bit one) with lost, late, duplicated and forged frames, a jump of the
+ * counter and a frame with another AD, against manx1_ctx_enc/manx1_ctx_dec.
+ */
+#define WIN_FRAMES 300
+#define WIN_JUMP   100
+
+static void check_window(const manx_ctx *ctx)
+{
+    static const size_t nlens[] = { 8, 61, 96 };
+    static uint8_t      n[WIN_FRAMES][BLOCKBYTES], m[WIN_FRAMES][BLOCKBYTES];
+    static uint8_t      c[WIN_FRAMES][BLOCKBYTES];
+    uint8_t             a[BLOCKBYTES], a2[BLOCKBYTES], p[BLOCKBYTES], f[BLOCKBYTES];
+    size_t              mlen[WIN_FRAMES], clen, plen;
+    manx1_mask          masks[8];
+    manx1_window        win;
+    int                 ok = 1, ok_hits = 1;
+
+    fill(a, sizeof(a), 0x5a);
+    fill(a2, sizeof(a2), 0xa5);
+    for (size_t k = 0; k < sizeof(nlens)/sizeof(nlens[0]); k++) {
+        size_t nlen = nlens[k];
+
+        memset(n[0], 0xff, BLOCKBYTES);
+        n[0][(nlen - 1)/8] -= 5 << (7 - (nlen - 1)%8);
+        if (nlen % 8)
+            n[0][(nlen - 1)/8] &= 0xff << (8 - nlen%8);
+        for (size_t i = 0; i < WIN_FRAMES; i++) {
+            if (i)
+                memcpy(n[i], n[i-1], BLOCKBYTES), nonce_inc_ref(n[i], nlen);
+            mlen[i] = (3*i) % 29;
+            fill(m[i], BLOCKBYTES, i);
+            manx1_ctx_enc(ctx, c[i], &clen, n[i], nlen, m[i], mlen[i], a, 24);
+        }
+
+        ok &= manx1_window_init(&win, ctx, masks, 8, n[0], nlen, a, 24) == 0;
+        ok &= manx1_window_fill(&win, 0) == 8;
+        for (size_t i = 0; i < WIN_FRAMES; i++) {
+            if (i % 7 == 3 || (i > WIN_JUMP && i < WIN_JUMP + 60))
+                continue;  // lost
+            if (i % 13 == 0) {
+                memcpy(f, c[i], BLOCKBYTES);
+                f[i % BLOCKBYTES] ^= 0x10;
+                ok &= manx1_window_dec(&win, p, &plen, n[i], nlen, f, BLOCKBITS, a, 24) != 0;
+            }
+            uint64_t hits = win.hits;
+            ok &= manx1_window_dec(&win, p, &plen, n[i], nlen, c[i], BLOCKBITS, a, 24) == 0;
+            ok &= plen == mlen[i] && bits_equal(p, m[i], plen);
+            // in the window unless the counter jumped
+            ok_hits &= (win.hits == hits + 1) == (i != WIN_JUMP + 60);
+            if (i % 11 == 0 && i >= 2) {  // late frame
+                ok &= manx1_window_dec(&win, p, &plen, n[i-2], nlen, c[i-2], BLOCKBITS, a, 24) == 0;
+                ok &= plen == mlen[i-2] && bits_equal(p, m[i-2], plen);
+            }
+            if (i % 17 == 0) {  // frame with another AD
+                uint64_t misses = win.misses;
+                uint8_t  c2[BLOCKBYTES];
+                manx1_ctx_enc(ctx, c2, &clen, n[i], nlen, m[i], mlen[i], a2, 24);
+                ok &= manx1_window_dec(&win, p, &plen, n[i], nlen, c2, clen, a2, 24) == 0;
+                ok &= plen == mlen[i] && bits_equal(p, m[i], plen);
+                ok_hits &= win.misses == misses + 1;
+            }
+            manx1_window_fill(&win, 2);
+        }
+        manx1_window_wipe(&win);
+    }
+    check(ok, "manx1 windows of masks match manx1_ctx_dec");
+    check(ok_hits, "manx1 windows of masks: hits and misses");
+}
+
+/**
+ * Manx1/Manx2 encryption streams against manx1_ctx_enc/manx2_ctx_enc, with
+ * counter nonces wrapping around and all the message lengths.
+ */
+static void check_stream(const manx_ctx *ctx)
+{
+    uint8_t      n[BLOCKBYTES], a[BLOCKBYTES], m[BLOCKBYTES];
+    uint8_t      nr[BLOCKBYTES], ref[2*BLOCKBYTES], c[2*BLOCKBYTES];
+    size_t       reflen, clen;
+    manx1_stream st1;
+    manx2_stream st2;
+    int          ok1 = 1, ok2 = 1;
+
+    static const size_t nlens1[] = { 1, 7, 61, 96, 128 };
+    for (size_t k = 0; k < sizeof(nlens1)/sizeof(nlens1[0]); k++) {
+        for (size_t alen = 0; alen <= MANX1_ALPHAMAX; alen += 16) {
+            size_t nlen = nlens1[k];
+
+            memset(n, 0xff, sizeof(n));
+            n[(nlen - 1)/8] -= 1 << (7 - (nlen - 1)%8);
+            fill(a, sizeof(a), alen + 3);
+            ok1 &= manx1_stream_init(&st1, ctx, n, nlen, a, alen) == 0;
+            for (size_t mlen = 0; mlen <= BLOCKBITS; mlen++) {
+                fill(m, sizeof(m), mlen);
+                int ref_ret = manx1_ctx_enc(ctx, ref, &reflen, n, nlen, m, mlen, a, alen);
+                int ret     = manx1_stream_enc(&st1, c, &clen, nr, m, mlen);
+                ok1 &= (ret == ref_ret) && (clen == reflen);
+                if (ret)
+                    continue;  // the nonce is kept
+                ok1 &= bits_equal(nr, n, nlen) && bits_equal(c, ref, clen);
+                nonce_inc_ref(n, nlen);
+            }
+            manx1_stream_wipe(&st1);
+        }
+    }
+    ok1 &= manx1_stream_init(&st1, ctx, n, 0, a, 0) != 0;
+    ok1 &= manx1_stream_init(&st1, ctx, n, BLOCKBITS + 1, a, 0) != 0;
+    ok1 &= manx1_stream_init(&st1, ctx, n, 96, a, MANX1_ALPHAMAX + 1) != 0;
+    check(ok1, "manx1 streams match manx1_ctx_enc with counter nonces");
+
+    static const size_t nlens2[] = { MANX_TAU, 70, 96, BLOCKBITS - MANX2_ALPHASTAR - 2 };
+    for (size_t k = 0; k < sizeof(nlens2)/sizeof(nlens2[0]); k++) {
+        for (size_t alen = 0; alen <= MANX2_ALPHAMAX; alen += 8) {
+            size_t nlen = nlens2[k];
+
+            memset(n, 0xff, sizeof(n));
+            n[(nlen - 1)/8] -= 1 << (7 - (nlen - 1)%8);
+            fill(a, sizeof(a), alen + 5);
+            ok2 &= manx2_stream_init(&st2, ctx, n, nlen, a, alen) == 0;
+            for (size_t mlen = 0; mlen <= BLOCKBITS; mlen++) {
+                fill(m, sizeof(m), mlen);
+                int ref_ret = manx2_ctx_enc(ctx, ref, &reflen, n, nlen, m, mlen, a, alen);
+                int ret     = manx2_stream_enc(&st2, c, &clen, nr, m, mlen);
+                ok2 &= (ret == ref_ret) && (clen == reflen);
+                if (ret)
+                    continue;  // the nonce is kept
+                ok2 &= bits_equal(nr, n, nlen) && bits_equal(c, ref, clen);
+                nonce_inc_ref(n, nlen);
+            }
+            manx2_stream_wipe(&st2);
+        }
+    }
+    ok2 &= manx2_stream_init(&st2, ctx, n, MANX_TAU - 1, a, 0) != 0;
+    ok2 &= manx2_stream_init(&st2, ctx, n, BLOCKBITS - MANX2_ALPHASTAR - 1, a, 0) != 0;
+    ok2 &= manx2_stream_init(&st2, ctx, n, 96, a, MANX2_ALPHAMAX + 1) != 0;
+    check(ok2, "manx2 streams match manx2_ctx_enc with counter nonces");
+}
+
+/**
+ * Caches of pre-encoded headers against manx2_ctx_dec, with 3 ADs sharing a
+ * cache of 2 entries, forged ciphertexts and ADs of several lengths.
+ */
+static void check_ad_cache(const manx_ctx *ctx)
+{
+    uint8_t        n[BLOCKBYTES], a[3][BLOCKBYTES], m[2*BLOCKBYTES];
+    uint8_t        c[2*BLOCKBYTES], p[2*BLOCKBYTES], p_ref[2*BLOCKBYTES];
+    size_t         clen, plen, plen_ref;
+    manx2_ad_entry entries[2];
+    manx2_ad_cache cache;
+    int            ok = 1, ok_hits = 1;
+
+    static const size_t nlens[] = { MANX_TAU, 77, BLOCKBITS - MANX2_ALPHASTAR - 2 };
+    for (size_t k = 0; k < sizeof(nlens)/sizeof(nlens[0]); k++) {
+        size_t nlen = nlens[k];
+
+        ok &= manx2_ad_cache_init(&cache, entries, 2) == 0;
+        for (size_t j = 0; j < 3; j++)
+            fill(a[j], sizeof(a[j]), 0x40 + j);
+        for (size_t i = 0; i < 600; i++) {
+            // AD 0 then 1 for a while, then 2 evicting 0, then 0 evicting 1
+            size_t   j      = (i < 200) ? i % 2 : (i < 400) ? 2 : 0;
+            size_t   alen   = (j == 1) ? MANX2_ALPHAMAX : 5*j + 3;
+            size_t   mlen   = (7*i) % (2*BLOCKBITS - 2*nlen - MANX2_ALPHASTAR - 4);
+            int      forged = (i % 5 == 4);
+            uint64_t hits   = cache.hits;
+
+            fill(n, sizeof(n), i);
+            fill(m, sizeof(m), i + 1);
+            ok &= manx2_ctx_enc(ctx, c, &clen, n, nlen, m, mlen, a[j], alen) == 0;
+            c[i % (clen/8)] ^= forged;
+            int ref = manx2_ctx_dec(ctx, p_ref, &plen_ref, n, nlen, c, clen, a[j], alen);
+            int ret = manx2_ctx_dec_cached(ctx, &cache, p, &plen, n, nlen, c, clen, a[j], alen);
+            ok &= (ret == ref) && (plen == plen_ref) && ((ref != 0) == forged);
+            ok &= ret || bits_equal(p, p_ref, plen);
+            // misses: first use of AD 0 and 1 (unless forged), of AD 2, then of AD 0 again
+            int miss = (i == 0 || i == 1 || i == 200 || i == 400);
+            ok_hits &= (cache.hits == hits + !miss);
+        }
+        ok_hits &= cache.hits + cache.misses == 600 && cache.misses == 4;
+        // the AD of a forged ciphertext is not cached
+        c[0] ^= 0x80;
+        ok &= manx2_ctx_dec_cached(ctx, &cache, p, &plen, n, nlen, c, clen, a[1], 11) != 0;
+        ok &= manx2_ctx_dec_cached(ctx, &cache, p, &plen, n, nlen, c, clen, a[1], 11) != 0;
+        ok_hits &= cache.misses == 6;
+        // the header is not cached for invalid lengths
+        ok &= manx2_ctx_dec_cached(ctx, &cache, p, &plen, n, nlen, c, clen, a[0], MANX2_ALPHAMAX + 1) == 1;
+        manx2_ad_cache_wipe(&cache);
+    }
+    ok &= manx2_ad_cache_init(&cache, entries, 0) != 0;
+    check(ok, "manx2_ctx_dec_cached matches manx2_ctx_dec");
+    check(ok_hits, "manx2 caches of headers: hits and misses");
+}
+
+/**
+ * Bulk functions on a pool of threads, through the batch checks (a whole
+ * array of BATCH_MSGS messages per call, i.e. several chunks per thread).
+ */
+static manx_pool *bulk_pool;
+
+static size_t bulk1_enc(const manx_ctx *ctx, manx_msg msgs[], size_t count)
+{
+    return manx_bulk_enc(bulk_pool, ctx, MANX_BULK_MANX1, msgs, count);
+}
+
+static size_t bulk1_dec(const manx_ctx *ctx, manx_msg msgs[], size_t count)
+{
+    return manx_bulk_dec(bulk_pool, ctx, MANX_BULK_MANX1, msgs, count);
+}
+
+static size_t bulk2_enc(const manx_ctx *ctx, manx_msg msgs[], size_t count)
+{
+    return manx_bulk_enc(bulk_pool, ctx, MANX_BULK_MANX2, msgs, count);
+}
+
+static size_t bulk2_dec(const manx_ctx *ctx, manx_msg msgs[], size_t count)
+{
+    return manx_bulk_dec(bulk_pool, ctx, MANX_BULK_MANX2, msgs, count);
+}
+
+static void check_bulk(const manx_ctx *ctx)
+{
+    int ok1 = 1, ok2 = 1;
+
+    bulk_pool = manx_pool_create(4);
+    check(bulk_pool != NULL && manx_pool_size(bulk_pool) == 4, "manx_pool_create");
+    if (bulk_pool == NULL)
+        return;
+    for (size_t nlen = 0; nlen <= BLOCKBITS; nlen += 17)
+        ok1 &= check_batch_nlen(ctx, nlen, BATCH_MSGS, bulk1_enc, manx1_ctx_enc,
+                                bulk1_dec, manx1_ctx_dec, MANX1_ALPHAMAX, BLOCKBITS);
+    for (size_t nlen = 0; nlen <= BLOCKBITS - MANX2_ALPHASTAR - 2; nlen += 17)
+        ok2 &= check_batch_nlen(ctx, nlen, BATCH_MSGS, bulk2_enc, manx2_ctx_enc,
+                                bulk2_dec, manx2_ctx_dec, MANX2_ALPHAMAX, 2*BLOCKBITS);
+    check(ok1, "manx1 bulk functions match single-message ones");
+    check(ok2, "manx2 bulk functions match single-message ones");
+    manx_pool_destroy(bulk_pool);
+}
+
+/**
+ * Caches of expanded keys, the key of device id being filled from id and the
+ * device KC_UNKNOWN being unknown to the loader.
+ */
+#define KC_UNKNOWN 0xdeadULL
+#define KC_THREADS 4
+
+static uint64_t kc_loads;
+
+static void kc_key(uint8_t key[16], uint64_t id)
+{
+    fill(key, 16, (uint8_t)(id ^ (id >> 8)));
+    memcpy(key, &id, sizeof(id));
+}
+
+static int kc_load(void *arg, uint64_t id, uint8_t key[KEYBYTES])
+{
+    (void)arg;
+    if (id == KC_UNKNOWN)
+        return 1;
+    __atomic_fetch_add(&kc_loads, 1, __ATOMIC_RELAXED);
+    kc_key(key, id);
+    return 0;
+}
+
+/**
+ * Manx1 round trips through a cache against the ones through a context
+ * initialized with the key of the device.
+ */
+static int kc_round_trip(manx_keycache *cache, const manx_cipher *cipher, uint64_t id, size_t i)
+{
+    uint8_t  key[16], n[BLOCKBYTES], a[BLOCKBYTES], m[BLOCKBYTES];
+    uint8_t  c[2*BLOCKBYTES], c_ref[2*BLOCKBYTES], p[2*BLOCKBYTES];
+    size_t   clen, clen_ref, plen;
+    size_t   mlen = i % 60;
+    manx_ctx ctx;
+    int      ok;
+
+    kc_key(key, id);
+    manx_ctx_init(&ctx, key, cipher);
+    fill(n, sizeof(n), i);
+    fill(a, sizeof(a), i + 1);
+    fill(m, sizeof(m), i + 2);
+    ok  = manx1_cached_enc(cache, id, c, &clen, n, 96, m, mlen, a, 24) == 0;
+    ok &= manx1_ctx_enc(&ctx, c_ref, &clen_ref, n, 96, m, mlen, a, 24) == 0;
+    ok &= (clen == clen_ref) && memcmp(c, c_ref, clen/8) == 0;
+    ok &= manx1_cached_dec(cache, id, p, &plen, n, 96, c, clen, a, 24) == 0;
+    ok &= (plen == mlen) && bits_equal(p, m, mlen);
+    c[0] ^= 0x01;
+    ok &= manx1_cached_dec(cache, id, p, &plen, n, 96, c, clen, a, 24) != 0;
+    manx_ctx_wipe(&ctx);
+    return ok;
+}
+
+typedef struct {
+    manx_keycache     *cache;
+    const manx_cipher *cipher;
+    size_t             seed;
+    int                ok;
+} kc_worker;
+
+static void *kc_thread(void *arg)
+{
+    kc_worker *w = arg;
+
+    for (size_t i = 0; i < 500; i++)
+        w->ok &= kc_round_trip(w->cache, w->cipher, (w->seed + 7*i) % 37, i);
+    return NULL;
+}
+
+static void check_keycache(const manx_ctx *ctx)
+{
+    const manx_cipher  *cipher = ctx->cipher;
+    uint8_t             key[16], n[BLOCKBYTES], a[BLOCKBYTES], m[2*BLOCKBYTES];
+    uint8_t             c[2*BLOCKBYTES], c_ref[2*BLOCKBYTES], p[2*BLOCKBYTES];
+    size_t              clen, clen_ref, plen;
+    manx_keycache      *cache;
+    manx_keycache_stats st;
+    manx_ctx            dctx;
+    const manx_ctx     *pinned[5];
+    int                 ok = 1, ok_stats = 1, ok_pins = 1, ok_mt = 1;
+
+    // budget of 4 entries for a single shard
+    check(manx_keycache_create(sizeof(manx_ctx), 1, cipher, kc_load, NULL) == NULL,
+          "manx_keycache_create with a budget too small");
+    cache = manx_keycache_create(4*(sizeof(manx_ctx) + 64), 1, cipher, kc_load, NULL);
+    check(cache != NULL, "manx_keycache_create");
+    if (cache == NULL)
+        return;
+    manx_keycache_stats_get(cache, &st, 0);
+    ok_stats &= st.capacity == 4 && st.entries == 0;
+
+    // working set within the capacity: a miss per device only
+    kc_loads = 0;
+    for (size_t i = 0; i < 400; i++)
+        ok &= kc_round_trip(cache, cipher, i % 4 + 1, i);
+    manx_keycache_stats_get(cache, &st, 1);
+    ok_stats &= st.misses == 4 && st.hits == 3*400 - 4 && st.evictions == 0 && st.entries == 4;
+    ok_stats &= kc_loads == 4;
+    // a fifth device evicts one of them, an invalidated device frees its entry
+    ok &= kc_round_trip(cache, cipher, 5, 0);
+    ok_stats &= manx_keycache_invalidate(cache, 5) == 1 && manx_keycache_invalidate(cache, 5) == 0;
+    manx_keycache_stats_get(cache, &st, 1);
+    ok_stats &= st.misses == 1 && st.evictions == 1 && st.entries == 3;
+    ok &= kc_round_trip(cache, cipher, 5, 1);
+    manx_keycache_stats_get(cache, &st, 1);
+    ok_stats &= st.misses == 1 && st.evictions == 0 && st.entries == 4 && kc_loads == 6;
+
+    // Manx2, and devices unknown to the loader
+    kc_key(key, 3);
+    manx_ctx_init(&dctx, key, cipher);
+    fill(n, sizeof(n), 1);
+    fill(a, sizeof(a), 2);
+    fill(m, sizeof(m), 3);
+    ok &= manx2_cached_enc(cache, 3, c, &clen, n, 64, m, 96, a, 16) == 0;
+    ok &= manx2_ctx_enc(&dctx, c_ref, &clen_ref, n, 64, m, 96, a, 16) == 0;
+    ok &= (clen == clen_ref) && memcmp(c, c_ref, clen/8) == 0;
+    ok &= manx2_cached_dec(cache, 3, p, &plen, n, 64, c, clen, a, 16) == 0;
+    ok &= (plen == 96) && bits_equal(p, m, 96);
+    ok &= manx2_cached_dec(cache, 4, p, &plen, n, 64, c, clen, a, 16) != 0;
+    ok &= manx1_cached_enc(cache, KC_UNKNOWN, c, &clen, n, 96, m, 30, a, 24) == -2 && clen == 0;
+    ok &= manx2_cached_dec(cache, KC_UNKNOWN, p, &plen, n, 64, c_ref, clen_ref, a, 16) == -2 && plen == 0;
+    check(ok, "manx1/manx2 cached functions match the context ones");
+    check(ok_stats, "caches of expanded keys: hits, misses and evictions");
+
+    // several devices of the same shard acquired at once, and pinned in use:
+    // no eviction while all of them are, no wipe when invalidated
+    for (size_t i = 0; i < 4; i++)
+        ok_pins &= (pinned[i] = manx_keycache_acquire(cache, i + 1)) != NULL;
+    if (!ok_pins) {
+        check(0, "cached contexts acquired at once");
+        manx_ctx_wipe(&dctx);
+        manx_keycache_destroy(cache);
+        return;
+    }
+    ok_pins &= manx_keycache_acquire(cache, 6) == NULL;
+    ok_pins &= manx1_cached_enc(cache, 6, c, &clen, n, 96, m, 30, a, 24) == -2;
+    ok_pins &= manx_keycache_acquire(cache, 3) == pinned[2];
+    manx_keycache_release(cache, pinned[2]);
+    ok_pins &= manx_keycache_invalidate(cache, 3) == 1;
+    kc_loads = 0;
+    ok_pins &= (pinned[4] = manx_keycache_acquire(cache, 3)) == NULL;
+    ok_pins &= kc_loads == 1;
+    ok_pins &= manx2_ctx_enc(pinned[2], c, &clen, n, 64, m, 96, a, 16) == 0;
+    ok_pins &= (clen == clen_ref) && memcmp(c, c_ref, clen/8) == 0;
+    manx_keycache_release(cache, pinned[2]);
+    ok_pins &= (pinned[4] = manx_keycache_acquire(cache, 3)) != NULL && kc_loads == 2;
+    if (pinned[4] != NULL) {
+        ok_pins &= manx2_ctx_dec(pinned[4], p, &plen, n, 64, c, clen, a, 16) == 0;
+        manx_keycache_release(cache, pinned[4]);
+    }
+    for (size_t i = 0; i < 4; i++)
+        if (i != 2)
+            manx_keycache_release(cache, pinned[i]);
+    ok_pins &= manx1_cached_enc(cache, 6, c, &clen, n, 96, m, 30, a, 24) == 0;
+    manx_keycache_stats_get(cache, &st, 1);
+    ok_pins &= st.entries == 4;
+    manx_ctx_wipe(&dctx);
+    manx_keycache_destroy(cache);
+    // entries of the size of the contexts of the cipher
+    cache = manx_keycache_create(4*(sizeof(manx_ctx) + 64), 1,
+                                 aes128_cipher(AES128_IMPL_AESNI_OTF), kc_load, NULL);
+    if (cache != NULL) {
+        manx_keycache_stats_get(cache, &st, 0);
+        ok_pins &= st.capacity >= 5*4;
+        ok_pins &= manx2_cached_dec(cache, 3, p, &plen, n, 64, c_ref, clen_ref, a, 16) == 0;
+        ok_pins &= (plen == 96) && bits_equal(p, m, 96);
+        manx_keycache_destroy(cache);
+    }
+    check(ok_pins, "cached contexts acquired at once, pinned while in use");
+
+    // threads sharing a cache smaller than the number of devices
+    cache = manx_keycache_create(16*(sizeof(manx_ctx) + 64), 4, cipher, kc_load, NULL);
+    if (cache == NULL) {
+        check(0, "manx_keycache_create with 4 shards");
+        return;
+    }
+    pthread_t threads[KC_THREADS];
+    kc_worker workers[KC_THREADS];
+    kc_loads = 0;
+    for (size_t i = 0; i < KC_THREADS; i++) {
+        workers[i] = (kc_worker){ .cache = cache, .cipher = cipher, .seed = 11*i, .ok = 1 };
+        ok_mt &= pthread_create(&threads[i], NULL, kc_thread, &workers[i]) == 0;
+    }
+    for (size_t i = 0; i < KC_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        ok_mt &= workers[i].ok;
+    }
+    manx_keycache_stats_get(cache, &st, 0);
+    ok_mt &= st.hits + st.misses == 3*500*KC_THREADS && st.misses == kc_loads;
+    // concurrent misses of a device may load it several times but insert it once
+    ok_mt &= st.entries <= st.capacity && st.inserts - st.evictions == st.entries;
+    manx_keycache_destroy(cache);
+    check(ok_mt, "caches of expanded keys shared by threads");
+}
+
+/**
+ * Check that the byte-wise and word-level formatters produce the same blocks
+ * (and the same error codes) for every (ν, α, ℓ).
+ */
+static void check_formatting(void)
+{
+    uint8_t n[BLOCKBYTES], a[BLOCKBYTES], m[2*BLOCKBYTES];
+    uint8_t t_bytes[2*BLOCKBYTES], t_words[2*BLOCKBYTES];
+    size_t  nb_bytes, nb_words;
+    int     ok1 = 1, ok2 = 1;
+
+    for (size_t nlen = 0; nlen <= BLOCKBITS; nlen++) {
+        for (size_t alen = 0; alen <= MANX1_ALPHAMAX + 1; alen++) {
+            for (size_t mlen = 0; mlen < BLOCKBITS; mlen++) {
+                fill(n, sizeof(n), nlen);
+                fill(a, sizeof(a), alen + 7);
+                fill(m, sizeof(m), mlen + 13);
+                int ret = manx1_init_blocks_bytes(t_bytes, n, nlen, m, mlen, a, alen);
+                ok1 &= ret == manx1_init_blocks_words(t_words, n, nlen, m, mlen, a, alen);
+                ok1 &= ret || memcmp(t_bytes, t_words, sizeof(t_words)) == 0;
+            }
+        }
+    }
+    for (size_t nlen = 0; nlen <= BLOCKBITS - MANX2_ALPHASTAR - 2; nlen++) {
+        for (size_t alen = 0; alen <= MANX2_ALPHAMAX + 1; alen++) {
+            for (size_t mlen = 0; mlen < 2*BLOCKBITS; mlen++) {
+                fill(n, sizeof(n), nlen);
+                fill(a, sizeof(a), alen + 7);
+                fill(m, sizeof(m), mlen + 13);
+                int ret = manx2_init_blocks_bytes(t_bytes, &nb_bytes, n, nlen, m, mlen, a, alen);
+                ok2 &= ret == manx2_init_blocks_words(t_words, &nb_words, n, nlen, m, mlen, a, alen);
+                ok2 &= ret || (nb_bytes == nb_words &&
+                               memcmp(t_bytes, t_words, nb_words*BLOCKBYTES) == 0);
+            }
+        }
+    }
+    check(ok1, "manx1_init_blocks_words matches manx1_init_blocks_bytes");
+    check(ok2, "manx2_init_blocks_words matches manx2_init_blocks_bytes");
+}
+
+/**
+ * Parameter sets (ν, α, ℓ) for which specialized encoders are checked against
+ * the generic ones: bit-unaligned lengths, Manx2 tiny messages (including
+ * ℓ = r) and short messages.
+ */
+MANX1_FIXED(m1_96_30_63, 96, 30, 63)
+MANX1_FIXED(m1_128_63_0, 128, 63, 0)
+MANX1_FIXED(m1_77_13_41, 77, 13, 41)
+MANX1_FIXED(m1_64_64_1, 64, 64, 1)
+MANX1_FIXED(m1_128_64_9, 128, 64, 9)
+MANX2_FIXED(m2_64_16_32, 64, 16, 32)
+MANX2_FIXED(m2_64_16_37, 64, 16, 37)
+MANX2_FIXED(m2_64_16_96, 64, 16, 96)
+MANX2_FIXED(m2_71_5_50, 71, 5, 50)
+MANX2_FIXED(m2_99_3_2, 99, 3, 2)
+MANX2_FIXED(m2_101_24_24, 101, 24, 24)
+
+#define CHECK_FIXED(manx, name, NU, ALPHA, ELL)                                \
+    do {                                                                       \
+        size_t nblocks = 2;                                                    \
+        fill(n, sizeof(n), NU);                                                \
+        fill(a, sizeof(a), ALPHA + 7);                                         \
+        fill(m, sizeof(m), ELL + 13);                                          \
+        memset(t, 0xff, sizeof(t));                                            \
+        memset(t_fixed, 0xff, sizeof(t_fixed));                                \
+        int ret = manx##_init_blocks(t, FIXED_NBLOCKS_##manx                   \
+                                     n, NU, m, ELL, a, ALPHA);                 \
+        name##_init_blocks(t_fixed, n, a, m);                                  \
+        check(ret == 0 && memcmp(t, t_fixed, nblocks*BLOCKBYTES) == 0,         \
+              #name "_init_blocks matches " #manx "_init_blocks");             \
+        manx##_ctx_enc(ctx, c, &clen, n, NU, m, ELL, a, ALPHA);                \
+        name##_enc(ctx, c_fixed, n, a, m);                                     \
+        check(clen == FIXED_CLEN_##manx && memcmp(c, c_fixed, clen/8) == 0,    \
+              #name "_enc matches " #manx "_ctx_enc");                         \
+    } while (0)
+#define FIXED_NBLOCKS_manx1
+#define FIXED_NBLOCKS_manx2 &nblocks,
+#define FIXED_CLEN_manx1    BLOCKBITS
+#define FIXED_CLEN_manx2    (nblocks*BLOCKBITS)
+
+static void check_fixed(const manx_ctx *ctx)
+{
+    uint8_t n[BLOCKBYTES], a[BLOCKBYTES], m[2*BLOCKBYTES];
+    uint8_t t[2*BLOCKBYTES], t_fixed[2*BLOCKBYTES];
+    uint8_t c[2*BLOCKBYTES], c_fixed[2*BLOCKBYTES];
+    size_t  clen;
+
+    CHECK_FIXED(manx1, m1_96_30_63, 96, 30, 63);
+    CHECK_FIXED(manx1, m1_128_63_0, 128, 63, 0);
+    CHECK_FIXED(manx1, m1_77_13_41, 77, 13, 41);
+    CHECK_FIXED(manx1, m1_64_64_1, 64, 64, 1);
+    CHECK_FIXED(manx1, m1_128_64_9, 128, 64, 9);
+    CHECK_FIXED(manx2, m2_64_16_32, 64, 16, 32);
+    CHECK_FIXED(manx2, m2_64_16_37, 64, 16, 37);
+    CHECK_FIXED(manx2, m2_64_16_96, 64, 16, 96);
+    CHECK_FIXED(manx2, m2_71_5_50, 71, 5, 50);
+    CHECK_FIXED(manx2, m2_99_3_2, 99, 3, 2);
+    CHECK_FIXED(manx2, m2_101_24_24, 101, 24, 24);
+}
+
+/**
+ * Clear the last bit set in a byte array, i.e. the padding bit of a block.
+ */
+static void clear_pad(uint8_t *buf, size_t len)
+{
+    while (len-- && !buf[len]);
+    buf[len] &= buf[len] - 1;
+}
+
+/**
+ * Check that decryption writes the (l + 7) / 8 plaintext bytes only, with
+ * zeros after the l plaintext bits, and that it rejects blocks whose one-zero
+ * padding is missing.
+ */
+static void check_depad(const manx_ctx *ctx)
+{
+    static const struct { int manx2; size_t nlen, alen, mlen; } cases[] = {
+        { 0, 96, 32, 0 }, { 0, 128, 64, 0 }, { 1, 64, 16, 0 }, { 1, 64, 16, 38 },
+    };
+    uint8_t n[BLOCKBYTES], a[BLOCKBYTES], m[2*BLOCKBYTES] = {0};
+    uint8_t t[2*BLOCKBYTES], c[2*BLOCKBYTES], p[2*BLOCKBYTES];
+    size_t  clen, plen, nblocks;
+    int     ok = 1;
+
+    fill(n, sizeof(n), 0x11);
+    fill(a, sizeof(a), 0x22);
+    for (size_t mlen = 0; mlen < 99; mlen++) {
+        fill(m, sizeof(m), mlen);
+        manx2_ctx_enc(ctx, c, &clen, n, 64, m, mlen, a, 16);
+        memset(p, 0xa5, sizeof(p));
+        ok &= manx2_ctx_dec(ctx, p, &plen, n, 64, c, clen, a, 16) == 0;
+        ok &= bits_equal(p, m, mlen) && (mlen % 8 == 0 || (p[mlen/8] & (0xff >> mlen%8)) == 0);
+        for (size_t i = (mlen + 7) / 8; i < sizeof(p); i++)
+            ok &= p[i] == 0xa5;
+    }
+    check(ok, "decryption writes the plaintext bytes only");
+
+    // encrypt blocks whose padding bit has been cleared
+    memset(m, 0, sizeof(m));
+    for (size_t k = 0; k < sizeof(cases)/sizeof(cases[0]); k++) {
+        if (!cases[k].manx2) {
+            manx1_init_blocks(t, n, cases[k].nlen, m, cases[k].mlen, a, cases[k].alen);
+            clear_pad(t + BLOCKBYTES, BLOCKBYTES);
+            ctx->cipher->encrypt(t, t, &ctx->rkeys);
+            doubling(t);
+            xor_block(t + BLOCKBYTES, t + BLOCKBYTES, t);
+            ctx->cipher->encrypt(c, t + BLOCKBYTES, &ctx->rkeys);
+            xor_block(c, c, t);
+            ok &= manx1_ctx_dec(ctx, p, &plen, n, cases[k].nlen, c, BLOCKBITS, a, cases[k].alen) == 3;
+        } else {
+            manx2_init_blocks(t, &nblocks, n, cases[k].nlen, m, cases[k].mlen, a, cases[k].alen);
+            clear_pad(t, nblocks*BLOCKBYTES);
+            for (size_t i = 0; i < nblocks; i++)
+                ctx->cipher->encrypt(c + i*BLOCKBYTES, t + i*BLOCKBYTES, &ctx->rkeys);
+            ok &= manx2_ctx_dec(ctx, p, &plen, n, cases[k].nlen, c, nblocks*BLOCKBITS,
+                                a, cases[k].alen) == (nblocks == 1 ? 2 : 4);
+        }
+    }
+    check(ok, "decryption rejects blocks without padding");
+}
+
+int main(void) {
+    uint8_t            key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    manx_ctx           ctx;
+    const manx_cipher *ciphers[AES128_IMPL_COUNT];
+
+    printf("AES-128 implementation selected: %s\n", aes128_cipher_best()->name);
+    check(manx_ctx_init(&ctx, key, aes128_cipher_best()) == 0, "manx_ctx_init");
+    check_kat(&suite, &ctx, key);
+    check_inv(&ctx);
+    check_blocks(&ctx);
+    check_formatting();
+    check_fixed(&ctx);
+    check_depad(&ctx);
+    check_precompute(&ctx);
+    check_window(&ctx);
+    check_stream(&ctx);
+    check_ad_cache(&ctx);
+    check_bulk(&ctx);
+    check_keycache(&ctx);
+
+    for (int i = 0; i < AES128_IMPL_COUNT; i++)
+        ciphers[i] = aes128_cipher(i);
+    fill(key, sizeof(key), 0x2b);
+    check_ciphers(&suite, ciphers, AES128_IMPL_COUNT, key);
+
+    manx_ctx_wipe(&ctx);
+    uint8_t acc = 0x00;
+    for (size_t i = 0; i < sizeof(ctx); i++)
+        acc |= ((uint8_t *)&ctx)[i];
+    check(acc == 0x00, "manx_ctx_wipe");
+
+    printf("%s\n", failures ? "checks FAILED" : "all checks passed");
+    return failures != 0;
+}
@@ -0,0 +1 @@
+../../../manx/test/manx-check.h
\ No newline at end of file
@@ -0,0 +1,291 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <x86intrin.h>
+#include "../manx.h"
+#include "../manx-common.h"
+#include "../dispatch.h"
+
+/**
+ * Micro-benchmarks breaking the cost of Manx1 and Manx2 down into their
+ * components, for each parameter set (ν, α, l) given on the command line as
+ * triples (the ones of suite.c -p by default):
+ * - the components timed in isolation: block formatting (manx*_init_blocks),
+ *   block cipher calls of each AES-128 implementation, doubling, xor_block,
+ *   and the steps of the verification (depad_10, sec_memcmp_bits, lshift and
+ *   store of the plaintext),
+ * - the same phases timed in place within manx1_enc, manx1_dec, manx2_enc
+ *   and manx2_dec (with key expansion, then with a Manx context), this
+ *   program being linked against the Manx objects compiled with
+ *   MANX_PHASE_TIMERS (see manx-config.h).
+ *
+ * Isolated components run ITERS times in a row, the median of RUNS runs being
+ * reported in cycles per call. The in-place breakdown is averaged over NMSGS
+ * messages and compared to the total cost measured around the calls, the
+ * difference being the overhead of the timers and of the code between them.
+ */
+#define RUNS  101
+#define ITERS 256
+#define NMSGS 4096
+
+static const size_t paper_sets[][3] = {
+    { 64, 0, 120 }, { 96, 0, 56 }, { 64, 16, 44 },
+    { 96, 32, 30 }, { 64, 16, 32 }, { 64, 16, 96 },
+};
+
+static const uint8_t key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+
+static inline uint64_t tsc_start(void)
+{
+    _mm_lfence();
+    uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+}
+
+static inline uint64_t tsc_stop(void)
+{
+    unsigned int aux;
+    uint64_t     t = __rdtscp(&aux);
+    _mm_lfence();
+    return t;
+}
+
+static int cmp_u64(const void *x, const void *y)
+{
+    uint64_t a = *(const uint64_t *)x, b = *(const uint64_t *)y;
+    return (a > b) - (a < b);
+}
+
+static uint64_t median(uint64_t t[RUNS])
+{
+    qsort(t, RUNS, sizeof(t[0]), cmp_u64);
+    return t[RUNS/2];
+}
+
+/**
+ * Median cost in cycles of ITERS consecutive executions of a statement, the
+ * compiler barrier keeping it from being hoisted or merged across iterations.
+ */
+#define TIME_OP(res, op) do {                                                 \
+        uint64_t t_[RUNS];                                                    \
+        for (size_t r_ = 0; r_ < RUNS; r_++) {                                \
+            uint64_t t0_ = tsc_start();                                       \
+            for (size_t i_ = 0; i_ < ITERS; i_++) {                           \
+                op;                                                           \
+                __asm__ volatile("" : : : "memory");                          \
+            }                                                                 \
+            t_[r_] = tsc_stop() - t0_;                                        \
+        }                                                                     \
+        (res) = (double)median(t_) / ITERS;                                   \
+    } while (0)
+
+static uint8_t nonce[BLOCKBYTES], ad[BLOCKBYTES], msg[BLOCKBYTES];
+static volatile uint64_t sink;
+
+/**
+ * Cost of a single-block encryption and decryption, for each implementation.
+ */
+static void micro_cipher(void)
+{
+    uint8_t blk[BLOCKBYTES] = {0};
+    double  enc, dec;
+
+    printf("%-20s %10s %10s\n", "cycles/block", "encrypt", "decrypt");
+    for (int impl = 0; impl < AES128_IMPL_COUNT; impl++) {
+        const manx_cipher *cipher = aes128_cipher(impl);
+        manx_ctx           ctx;
+
+        if (cipher == NULL)
+            continue;
+        manx_ctx_init(&ctx, key, cipher);
+        TIME_OP(enc, cipher->encrypt(blk, blk, &ctx.rkeys));
+        TIME_OP(dec, cipher->decrypt(blk, blk, manx_ctx_rkeys_inv(&ctx)));
+        printf("%-20s %10.1f %10.1f\n", cipher->name, enc, dec);
+        manx_ctx_wipe(&ctx);
+    }
+}
+
+/**
+ * Cost of the Manx1 components in isolation for a given parameter set.
+ */
+static void micro_manx1(size_t nlen, size_t alen, size_t mlen)
+{
+    size_t   s     = MAX(BLOCKBITS - nlen + MANX_TAU, MANX1_ALPHAMAX);
+    size_t   v2len = s - (BLOCKBITS - nlen);
+    uint8_t  v[2*BLOCKBYTES], c[BLOCKBYTES] = {0};
+    uint64_t w[2];
+    size_t   padlen;
+    double   t_fmt, t_dbl, t_xor, t_pad, t_cmp, t_out;
+
+    printf("manx1 (%3zu,%2zu,%3zu)", nlen, alen, mlen);
+    if (manx1_init_blocks(v, nonce, nlen, msg, mlen, ad, alen)) {
+        printf(" %10s\n", "-");
+        return;
+    }
+    TIME_OP(t_fmt, sink += manx1_init_blocks(v, nonce, nlen, msg, mlen, ad, alen));
+    TIME_OP(t_dbl, doubling(v));
+    TIME_OP(t_xor, xor_block(v + BLOCKBYTES, v + BLOCKBYTES, v));
+    load_block64(w, v + BLOCKBYTES);
+    TIME_OP(t_pad, sink += depad_10(w, &padlen) + padlen);
+    TIME_OP(t_cmp, sink += sec_memcmp_bits(v, v + BLOCKBYTES, v2len));
+    TIME_OP(t_out, (shl128(w, v2len), store_bits128(c, w, mlen)));
+    printf(" %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+           t_fmt, t_dbl, t_xor, t_pad, t_cmp, t_out);
+}
+
+/**
+ * Cost of the Manx2 components in isolation for a given parameter set.
+ */
+static void micro_manx2(size_t nlen, size_t alen, size_t mlen)
+{
+    size_t   mpos = nlen + 2 + MANX2_ALPHASTAR;
+    uint8_t  t[2*BLOCKBYTES], p[BLOCKBYTES] = {0};
+    uint64_t w[2];
+    size_t   nblocks, padlen;
+    double   t_fmt, t_pad, t_cmp, t_out;
+
+    printf("manx2 (%3zu,%2zu,%3zu)", nlen, alen, mlen);
+    if (manx2_init_blocks(t, &nblocks, nonce, nlen, msg, mlen, ad, alen)) {
+        printf(" %10s\n", "-");
+        return;
+    }
+    TIME_OP(t_fmt, sink += manx2_init_blocks(t, &nblocks, nonce, nlen, msg, mlen, ad, alen));
+    load_block64(w, t);
+    TIME_OP(t_pad, sink += depad_10(w, &padlen) + padlen);
+    TIME_OP(t_cmp, sink += sec_memcmp_bits(t, t + BLOCKBYTES, mpos));
+    TIME_OP(t_out, (shl128(w, mpos), store_bits128(p, w, mlen)));
+    printf(" %10.1f %10s %10s %10.1f %10.1f %10.1f\n",
+           t_fmt, "", "", t_pad, t_cmp, t_out);
+}
+
+#if MANX_PHASE_TIMERS
+/**
+ * Manx call timed in place: with key expansion (ctx == NULL, AES-NI functions
+ * as in bench.c) or a context.
+ */
+typedef enum { OP_MANX1_ENC, OP_MANX1_DEC, OP_MANX2_ENC, OP_MANX2_DEC, OP_COUNT } op_t;
+
+static const char *op_names[OP_COUNT] = { "manx1_enc", "manx1_dec", "manx2_enc", "manx2_dec" };
+
+static int run_op(op_t op, const manx_ctx *ctx, size_t nlen, size_t alen, size_t mlen,
+                  uint8_t c[2*BLOCKBYTES], size_t clen)
+{
+    uint8_t out[2*BLOCKBYTES];
+    size_t  outlen;
+
+    switch (op) {
+    case OP_MANX1_ENC:
+        return ctx ? manx1_ctx_enc(ctx, out, &outlen, nonce, nlen, msg, mlen, ad, alen)
+                   : manx1_enc(out, &outlen, key, nonce, nlen, msg, mlen, ad, alen,
+                               aes128_enc, aes128_kexp);
+    case OP_MANX1_DEC:
+        return ctx ? manx1_ctx_dec(ctx, out, &outlen, nonce, nlen, c, clen, ad, alen)
+                   : manx1_dec(out, &outlen, key, nonce, nlen, c, clen, ad, alen,
+                               aes128_enc, aes128_dec, aes128_kexp);
+    case OP_MANX2_ENC:
+        return ctx ? manx2_ctx_enc(ctx, out, &outlen, nonce, nlen, msg, mlen, ad, alen)
+                   : manx2_enc(out, &outlen, key, nonce, nlen, msg, mlen, ad, alen,
+                               aes128_enc, aes128_kexp);
+    default:
+        return ctx ? manx2_ctx_dec(ctx, out, &outlen, nonce, nlen, c, clen, ad, alen)
+                   : manx2_dec(out, &outlen, key, nonce, nlen, c, clen, ad, alen,
+                               aes128_dec, aes128_kexp);
+    }
+}
+
+/**
+ * Phases of a Manx call as timed in place, in cycles per message.
+ */
+static void phases(op_t op, const manx_ctx *ctx, size_t nlen, size_t alen, size_t mlen)
+{
+    uint8_t          c[2*BLOCKBYTES];
+    size_t           clen;
+    manx_phase_stats st;
+    uint64_t         start, total;
+    int              ret = 0;
+
+    if (ctx == NULL && !aes128_impl_supported(AES128_IMPL_AESNI))
+        return;
+    if (op <= OP_MANX1_DEC)
+        ret = manx1_enc(c, &clen, key, nonce, nlen, msg, mlen, ad, alen, aes128_enc_c, aes128_kexp_c);
+    else
+        ret = manx2_enc(c, &clen, key, nonce, nlen, msg, mlen, ad, alen, aes128_enc_c, aes128_kexp_c);
+    printf("%-9s %-4s (%3zu,%2zu,%3zu)", op_names[op], ctx ? "ctx" : "kexp", nlen, alen, mlen);
+    if (ret) {
+        printf(" %8s\n", "-");
+        return;
+    }
+
+    manx_phase_get(NULL, 1);
+    start = tsc_start();
+    for (size_t i = 0; i < NMSGS; i++)
+        ret |= run_op(op, ctx, nlen, alen, mlen, c, clen);
+    total = tsc_stop() - start;
+    manx_phase_get(&st, 1);
+
+    uint64_t sum = 0;
+    for (int ph = 0; ph < MANX_PHASE_COUNT; ph++) {
+        printf(" %8.1f", (double)st.cycles[ph] / NMSGS);
+        sum += st.cycles[ph];
+    }
+    printf(" %8.1f %8.1f%s\n", (double)sum / NMSGS, (double)total / NMSGS,
+           (ret || st.calls != NMSGS) ? " (FAILED)" : "");
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+    size_t (*sets)[3] = (size_t (*)[3])paper_sets;
+    size_t nsets      = sizeof(paper_sets) / sizeof(paper_sets[0]);
+
+    if (argc > 1) {
+        if ((argc - 1) % 3) {
+            fprintf(stderr, "usage: %s [nu alpha l]...\n", argv[0]);
+            return 1;
+        }
+        nsets = (argc - 1) / 3;
+        sets  = malloc(nsets * sizeof(sets[0]));
+        for (size_t i = 0; i < 3*nsets; i++)
+            sets[i/3][i%3] = strtoul(argv[i+1], NULL, 0);
+    }
+    for (size_t i = 0; i < BLOCKBYTES; i++)
+        nonce[i] = i, ad[i] = 0x10 + i, msg[i] = 0x20 + i;
+
+    micro_cipher();
+
+    printf("\n%-21s %10s %10s %10s %10s %10s %10s\n", "cycles/call",
+           "format", "doubling", "xor_block", "depad_10", "memcmp", "lshift");
+    for (size_t i = 0; i < nsets; i++)
+        micro_manx1(sets[i][0], sets[i][1], sets[i][2]);
+    for (size_t i = 0; i < nsets; i++)
+        micro_manx2(sets[i][0], sets[i][1], sets[i][2]);
+
+#if MANX_PHASE_TIMERS
+    manx_ctx ctx;
+
+    manx_ctx_init(&ctx, key, aes128_cipher_best());
+    manx_ctx_rkeys_inv(&ctx);
+    // each mark reads the clock once and updates a counter, its cost being
+    // included in the phase it closes
+    double t_mark;
+    TIME_OP(t_mark, sink += MANX_PHASE_CLOCK());
+    printf("\nphases in place (kexp: AES-NI, ctx: %s), cycles/message\n", ctx.cipher->name);
+    printf("(about %.1f cycles of timer overhead per phase mark)\n", t_mark);
+    printf("%-25s %8s %8s %8s %8s %8s %8s %8s %8s\n", "", "kexpand", "format",
+           "cipher", "doubling", "xor", "verify", "sum", "total");
+    for (int op = 0; op < OP_COUNT; op++) {
+        for (size_t i = 0; i < nsets; i++)
+            phases(op, NULL, sets[i][0], sets[i][1], sets[i][2]);
+        for (size_t i = 0; i < nsets; i++)
+            phases(op, &ctx, sets[i][0], sets[i][1], sets[i][2]);
+    }
+    manx_ctx_wipe(&ctx);
+#else
+    printf("\n(phases in place not timed: build with -DMANX_PHASE_TIMERS=1)\n");
+#endif
+
+    if (sets != (size_t (*)[3])paper_sets)
+        free(sets);
+    return 0;
+}
@@ -0,0 +1,537 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <x86intrin.h>
+#ifdef __linux__
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#include "../manx.h"
+#include "../dispatch.h"
+#ifdef MANX_SUITE_OPENSSL
+#include <openssl/evp.h>
+#endif
+
+/**
+ * Benchmark suite sweeping over the parameter sets (ν, α, l) accepted by
+ * Manx1 and Manx2 for each AES-128 implementation supported, with the key
+ * expanded once and for all (Manx context) or on every message. Each message
+ * is timed on its own with serialized RDTSC reads, and one row is reported
+ * per (mode, implementation, key expansion, operation, ν, α, l) as CSV or
+ * JSON on the standard output:
+ * - the length of the ciphertext in bits,
+ * - the median and 99th percentile of the cost in cycles per message,
+ * - the number of messages per second derived from the median cost.
+ *
+ * RDTSC counts reference cycles at the nominal frequency of the processor,
+ * which is also the one used to derive the number of messages per second.
+ *
+ * With -c, the hardware counters of the instructions, cycles, branch misses
+ * and L1D read misses are also collected through perf_event_open (Linux) over
+ * another pass of the same messages, without the RDTSC reads, and reported as
+ * instructions per message, IPC and misses per 1000 messages. The counters
+ * not available (no PMU exposed to a virtual machine, perf_event_paranoid, or
+ * another OS) are reported as empty (CSV) or null (JSON) values.
+ *
+ * When compiled with MANX_SUITE_OPENSSL (make suite OPENSSL=1), AES-128-GCM
+ * from OpenSSL is timed as well (mode "gcm", 96-bit IV and 128-bit tag) for
+ * the byte lengths of AD and message covering the Manx ones.
+ */
+#define RUNS 101
+
+static const char *usage =
+    "usage: %s [-f csv|json] [-r runs] [-s step] [-m manx1|manx2|gcm] [-b name] [-p] [-c]\n"
+    "  -f  output format (default: csv)\n"
+    "  -r  number of timed messages per row (default: %d)\n"
+    "  -s  step between the values of each of ν, α and l (default: 1, i.e. every\n"
+    "      legal combination)\n"
+    "  -m  only sweep over a given mode\n"
+    "  -b  only time a given implementation (name as reported, e.g. \"AES-NI\")\n"
+    "  -p  only time the parameter sets of the README tables and of bench.c\n"
+    "  -c  also collect hardware counters (instructions, cycles, branch and L1D\n"
+    "      misses) with perf_event_open\n";
+
+/**
+ * Parameter sets of the ../../armv7m and ../../avr8 README tables, followed
+ * by the ones of bench.c (-p).
+ */
+static const size_t paper_sets[][3] = {
+    { 64, 0, 120 }, { 96, 0, 56 }, { 64, 16, 44 },
+    { 96, 32, 30 }, { 64, 16, 32 }, { 64, 16, 96 },
+};
+
+enum { MODE_MANX1, MODE_MANX2, MODE_GCM, MODE_COUNT };
+
+enum { PMU_INSTRUCTIONS, PMU_CYCLES, PMU_BRANCH_MISSES, PMU_L1D_MISSES, PMU_COUNT };
+
+static const char *pmu_names[PMU_COUNT] = {
+    "instructions", "cycles", "branch-misses", "L1-dcache-load-misses"
+};
+
+static const char *mode_names[MODE_COUNT] = { "manx1", "manx2", "gcm" };
+
+/**
+ * Options and state shared by all the rows.
+ */
+static struct {
+    int         json;
+    size_t      runs, step;
+    int         mode;      // -1 for all modes
+    const char *backend;   // NULL for all implementations
+    int         paper;
+    int         counters;
+    int         pmu[PMU_COUNT];  // perf event file descriptors (-1 if not available)
+    double      tsc_hz;
+    uint64_t    overhead;  // cost of an empty measurement
+    size_t      rows;
+} opt = { .runs = RUNS, .step = 1, .mode = -1 };
+
+static const uint8_t key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+
+/**
+ * Serialized RDTSC reads: LFENCE prevents the timed code from starting before
+ * the first read, and RDTSCP from being read before the timed code completes.
+ */
+static inline uint64_t tsc_start(void)
+{
+    _mm_lfence();
+    uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+}
+
+static inline uint64_t tsc_stop(void)
+{
+    unsigned int aux;
+    uint64_t     t = __rdtscp(&aux);
+    _mm_lfence();
+    return t;
+}
+
+/**
+ * Open the hardware counters of the calling thread (user space only), each on
+ * its own so that the ones not supported do not prevent the others from being
+ * collected. Return the number of counters available.
+ */
+static int pmu_open(void)
+{
+    int count = 0;
+
+    for (int i = 0; i < PMU_COUNT; i++) {
+        opt.pmu[i] = -1;
+#ifdef __linux__
+        struct perf_event_attr attr;
+
+        memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        switch (i) {
+            case PMU_INSTRUCTIONS:  attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+            case PMU_CYCLES:        attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+            case PMU_BRANCH_MISSES: attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+            default:
+                attr.type   = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        }
+        opt.pmu[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (opt.pmu[i] < 0)
+            fprintf(stderr, "counter %s not available (perf_event_open: %s)\n",
+                    pmu_names[i], strerror(errno));
+        else
+            count++;
+#endif
+    }
+    return count;
+}
+
+static void pmu_start(void)
+{
+#ifdef __linux__
+    for (int i = 0; i < PMU_COUNT; i++) {
+        if (opt.pmu[i] >= 0) {
+            ioctl(opt.pmu[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(opt.pmu[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+/**
+ * Stop the counters and get their values (scaled if they were multiplexed),
+ * negative for the ones not available.
+ */
+static void pmu_stop(double v[PMU_COUNT])
+{
+    for (int i = 0; i < PMU_COUNT; i++) {
+        v[i] = -1;
+#ifdef __linux__
+        uint64_t r[3];  // value, time enabled, time running
+
+        if (opt.pmu[i] < 0)
+            continue;
+        ioctl(opt.pmu[i], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(opt.pmu[i], r, sizeof(r)) == sizeof(r) && r[2])
+            v[i] = (double)r[0] * r[1] / r[2];
+#endif
+    }
+}
+
+static void pmu_close(void)
+{
+    for (int i = 0; i < PMU_COUNT; i++)
+        if (opt.pmu[i] >= 0)
+            close(opt.pmu[i]);
+}
+
+static int cmp_u64(const void *x, const void *y)
+{
+    uint64_t a = *(const uint64_t *)x, b = *(const uint64_t *)y;
+    return (a > b) - (a < b);
+}
+
+/**
+ * Sort the samples and return the given percentile (nearest rank).
+ */
+static uint64_t percentile(uint64_t t[], size_t len, size_t pct)
+{
+    size_t rank = (len*pct + 99) / 100;
+    qsort(t, len, sizeof(t[0]), cmp_u64);
+    return t[rank ? rank - 1 : 0];
+}
+
+/**
+ * Frequency of the TSC, measured against CLOCK_MONOTONIC over 100 ms.
+ */
+static double tsc_frequency(void)
+{
+    struct timespec t0, t1;
+    uint64_t        c0, c1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    c0 = tsc_start();
+    do
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+    while ((t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec) < 1e8);
+    c1 = tsc_stop();
+    return (c1 - c0) / ((t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec)*1e-9);
+}
+
+/**
+ * Allocate the timings of the opt.runs messages of a row, exiting on failure.
+ */
+static uint64_t *alloc_runs(void)
+{
+    uint64_t *t = malloc(opt.runs*sizeof(uint64_t));
+
+    if (!t) {
+        fprintf(stderr, "cannot allocate the timings of %zu runs\n", opt.runs);
+        exit(1);
+    }
+    return t;
+}
+
+static uint64_t tsc_overhead(void)
+{
+    uint64_t *t = alloc_runs();
+    uint64_t  o;
+
+    for (size_t r = 0; r < opt.runs; r++) {
+        uint64_t start = tsc_start();
+        t[r] = tsc_stop() - start;
+    }
+    o = percentile(t, opt.runs, 50);
+    free(t);
+    return o;
+}
+
+/**
+ * Inputs and outputs of the message being timed, for a given implementation
+ * (cipher being NULL for AES-128-GCM).
+ */
+typedef struct {
+    const manx_cipher *cipher;
+    manx_ctx           ctx;
+    int                mode;
+    size_t             nlen, alen, mlen, clen, plen;
+    uint8_t            n[BLOCKBYTES], a[BLOCKBYTES], m[2*BLOCKBYTES];
+    uint8_t            c[2*BLOCKBYTES + 16], p[2*BLOCKBYTES];
+#ifdef MANX_SUITE_OPENSSL
+    EVP_CIPHER_CTX    *gcm;
+#endif
+} bench_t;
+
+static void fill(uint8_t *buf, size_t len, uint8_t seed)
+{
+    for (size_t i = 0; i < len; i++)
+        buf[i] = (uint8_t)(seed + 0x9d*i + (i >> 1));
+}
+
+#ifdef MANX_SUITE_OPENSSL
+/**
+ * AES-128-GCM on the AD and message rounded up to bytes, the key schedule
+ * (and the hash key) being computed again if kexp is set.
+ */
+static int gcm_enc(bench_t *b, int kexp)
+{
+    int len, alen = (b->alen + 7)/8, mlen = (b->mlen + 7)/8;
+
+    if (!EVP_EncryptInit_ex(b->gcm, NULL, NULL, kexp ? key : NULL, b->n))
+        return 1;
+    if (alen && !EVP_EncryptUpdate(b->gcm, NULL, &len, b->a, alen))
+        return 1;
+    if (!EVP_EncryptUpdate(b->gcm, b->c, &len, b->m, mlen))
+        return 1;
+    if (!EVP_EncryptFinal_ex(b->gcm, b->c + len, &len))
+        return 1;
+    if (!EVP_CIPHER_CTX_ctrl(b->gcm, EVP_CTRL_GCM_GET_TAG, 16, b->c + mlen))
+        return 1;
+    b->clen = 8*(mlen + 16);
+    return 0;
+}
+
+static int gcm_dec(bench_t *b, int kexp)
+{
+    int len, alen = (b->alen + 7)/8, clen = b->clen/8 - 16;
+
+    if (!EVP_DecryptInit_ex(b->gcm, NULL, NULL, kexp ? key : NULL, b->n))
+        return 1;
+    if (alen && !EVP_DecryptUpdate(b->gcm, NULL, &len, b->a, alen))
+        return 1;
+    if (!EVP_DecryptUpdate(b->gcm, b->p, &len, b->c, clen))
+        return 1;
+    if (!EVP_CIPHER_CTX_ctrl(b->gcm, EVP_CTRL_GCM_SET_TAG, 16, b->c + clen))
+        return 1;
+    return EVP_DecryptFinal_ex(b->gcm, b->p + len, &len) <= 0;
+}
+#endif
+
+/**
+ * Process the message once (dec being set for decryption), the key being
+ * expanded through a fresh Manx context if kexp is set, so that decryption
+ * also derives the decryption round keys of the implementations requiring
+ * them.
+ */
+static int run_once(bench_t *b, int dec, int kexp)
+{
+    const manx_ctx *ctx = &b->ctx;
+    manx_ctx        tmp;
+
+#ifdef MANX_SUITE_OPENSSL
+    if (b->mode == MODE_GCM)
+        return dec ? gcm_dec(b, kexp) : gcm_enc(b, kexp);
+#endif
+    if (kexp) {
+        manx_ctx_init(&tmp, key, b->cipher);
+        ctx = &tmp;
+    }
+    if (b->mode == MODE_MANX1)
+        return dec ? manx1_ctx_dec(ctx, b->p, &b->plen, b->n, b->nlen, b->c, b->clen, b->a, b->alen)
+                   : manx1_ctx_enc(ctx, b->c, &b->clen, b->n, b->nlen, b->m, b->mlen, b->a, b->alen);
+    return dec ? manx2_ctx_dec(ctx, b->p, &b->plen, b->n, b->nlen, b->c, b->clen, b->a, b->alen)
+               : manx2_ctx_enc(ctx, b->c, &b->clen, b->n, b->nlen, b->m, b->mlen, b->a, b->alen);
+}
+
+/**
+ * Print a derived counter value (a negative one being unavailable).
+ */
+static void print_pmu(const char *key, double v, int decimals)
+{
+    if (opt.json)
+        printf(v < 0 ? ", \"%s\": null" : ", \"%s\": %.*f", key, decimals, v);
+    else if (v < 0)
+        printf(",");
+    else
+        printf(",%.*f", decimals, v);
+}
+
+/**
+ * Print a row, pmu giving the counter values over opt.runs messages if -c
+ * is set.
+ */
+static void print_row(const bench_t *b, const char *name, int kexp, int dec,
+            uint64_t median, uint64_t p99, const double pmu[PMU_COUNT])
+{
+    double msgs = median ? opt.tsc_hz/median : 0;
+    double runs = opt.runs;
+
+    if (opt.json)
+        printf("%s    {\"mode\": \"%s\", \"backend\": \"%s\", \"kexp\": %d, \"op\": \"%s\", "
+               "\"nu\": %zu, \"alpha\": %zu, \"len\": %zu, \"clen\": %zu, "
+               "\"median_cycles\": %llu, \"p99_cycles\": %llu, \"msgs_per_sec\": %.0f",
+               opt.rows ? ",\n" : "", mode_names[b->mode], name, kexp, dec ? "dec" : "enc",
+               b->nlen, b->alen, b->mlen, b->clen,
+               (unsigned long long)median, (unsigned long long)p99, msgs);
+    else
+        printf("%s,%s,%d,%s,%zu,%zu,%zu,%zu,%llu,%llu,%.0f",
+               mode_names[b->mode], name, kexp, dec ? "dec" : "enc",
+               b->nlen, b->alen, b->mlen, b->clen,
+               (unsigned long long)median, (unsigned long long)p99, msgs);
+    if (opt.counters) {
+        int ipc = pmu[PMU_INSTRUCTIONS] >= 0 && pmu[PMU_CYCLES] > 0;
+
+        print_pmu("instructions", pmu[PMU_INSTRUCTIONS] < 0 ? -1 : pmu[PMU_INSTRUCTIONS]/runs, 1);
+        print_pmu("ipc", ipc ? pmu[PMU_INSTRUCTIONS]/pmu[PMU_CYCLES] : -1, 2);
+        print_pmu("branch_misses_per_1k", pmu[PMU_BRANCH_MISSES] < 0 ? -1 : 1000*pmu[PMU_BRANCH_MISSES]/runs, 1);
+        print_pmu("l1d_misses_per_1k", pmu[PMU_L1D_MISSES] < 0 ? -1 : 1000*pmu[PMU_L1D_MISSES]/runs, 1);
+    }
+    printf(opt.json ? "}" : "\n");
+    opt.rows++;
+}
+
+/**
+ * Time a parameter set (if legal) with and without key expansion, for both
+ * encryption and decryption.
+ */
+static void bench_params(bench_t *b, const char *name, size_t nlen, size_t alen, size_t mlen)
+{
+    uint64_t *t = alloc_runs();
+
+    b->nlen = nlen, b->alen = alen, b->mlen = mlen;
+    fill(b->n, sizeof(b->n), nlen);
+    fill(b->a, sizeof(b->a), alen + 7);
+    fill(b->m, sizeof(b->m), mlen + 13);
+    if (run_once(b, 0, 0))
+        goto end;  // parameter set not supported
+    if (run_once(b, 1, 0)) {
+        fprintf(stderr, "%s %s (%zu, %zu, %zu): decryption failed\n",
+                mode_names[b->mode], name, nlen, alen, mlen);
+        exit(1);
+    }
+    for (int kexp = 0; kexp < 2; kexp++) {
+        for (int dec = 0; dec < 2; dec++) {
+            run_once(b, dec, kexp);  // warm-up
+            for (size_t r = 0; r < opt.runs; r++) {
+                uint64_t start = tsc_start();
+                run_once(b, dec, kexp);
+                uint64_t stop = tsc_stop() - start;
+                t[r] = stop > opt.overhead ? stop - opt.overhead : 0;
+            }
+            double pmu[PMU_COUNT];
+            if (opt.counters) {
+                pmu_start();
+                for (size_t r = 0; r < opt.runs; r++)
+                    run_once(b, dec, kexp);
+                pmu_stop(pmu);
+            }
+            uint64_t p99 = percentile(t, opt.runs, 99);
+            print_row(b, name, kexp, dec, percentile(t, opt.runs, 50), p99, pmu);
+        }
+    }
+end:
+    free(t);
+}
+
+/**
+ * Sweep over the parameter sets of a mode, bounded as in check.c (the
+ * functions rejecting the illegal ones).
+ */
+static void bench_mode(bench_t *b, const char *name)
+{
+    size_t nmin = 0, nmax = BLOCKBITS, amax = MANX1_ALPHAMAX, lmax = BLOCKBITS;
+
+    if (opt.paper) {
+        for (size_t i = 0; i < sizeof(paper_sets)/sizeof(paper_sets[0]); i++)
+            bench_params(b, name, paper_sets[i][0], paper_sets[i][1], paper_sets[i][2]);
+        return;
+    }
+    if (b->mode == MODE_MANX2)
+        nmin = MANX_TAU, nmax = BLOCKBITS - MANX2_ALPHASTAR - 2, amax = MANX2_ALPHAMAX, lmax = 2*BLOCKBITS;
+    if (b->mode == MODE_GCM)  // byte lengths only, with the standard 96-bit IV
+        nmin = nmax = 96, lmax = 2*BLOCKBITS;
+    for (size_t nlen = nmin; nlen <= nmax; nlen += opt.step)
+        for (size_t alen = 0; alen <= amax; alen += (b->mode == MODE_GCM) ? 8*opt.step : opt.step)
+            for (size_t mlen = 0; mlen < lmax; mlen += (b->mode == MODE_GCM) ? 8*opt.step : opt.step)
+                bench_params(b, name, nlen, alen, mlen);
+}
+
+int main(int argc, char *argv[])
+{
+    static bench_t b;
+    int            c;
+
+    while ((c = getopt(argc, argv, "f:r:s:m:b:pc")) != -1) {
+        switch (c) {
+            case 'f': opt.json = strcmp(optarg, "json") == 0; break;
+            case 'r': opt.runs = strtoul(optarg, NULL, 10); break;
+            case 's': opt.step = strtoul(optarg, NULL, 10); break;
+            case 'b': opt.backend = optarg; break;
+            case 'p': opt.paper = 1; break;
+            case 'c': opt.counters = 1; break;
+            case 'm':
+                for (opt.mode = MODE_COUNT - 1; opt.mode >= 0; opt.mode--)
+                    if (strcmp(optarg, mode_names[opt.mode]) == 0)
+                        break;
+                if (opt.mode >= 0)
+                    break;
+                // fall through
+            default:
+                fprintf(stderr, usage, argv[0], RUNS);
+                return 1;
+        }
+    }
+    if (opt.runs == 0 || opt.step == 0) {
+        fprintf(stderr, usage, argv[0], RUNS);
+        return 1;
+    }
+#ifndef MANX_SUITE_OPENSSL
+    if (opt.mode == MODE_GCM) {
+        fprintf(stderr, "mode gcm not available: build with make suite OPENSSL=1\n");
+        fprintf(stderr, usage, argv[0], RUNS);
+        return 1;
+    }
+#endif
+
+    if (opt.counters && pmu_open() == 0)
+        fprintf(stderr, "no hardware counter available: reporting cycles only\n");
+    opt.tsc_hz   = tsc_frequency();
+    opt.overhead = tsc_overhead();
+    fprintf(stderr, "AES-128 implementation selected: %s\n", aes128_cipher_best()->name);
+    fprintf(stderr, "TSC frequency: %.0f MHz, measurement overhead: %llu cycles\n",
+            opt.tsc_hz/1e6, (unsigned long long)opt.overhead);
+
+    if (opt.json)
+        printf("{\n  \"tsc_hz\": %.0f,\n  \"runs\": %zu,\n  \"results\": [\n", opt.tsc_hz, opt.runs);
+    else
+        printf("mode,backend,kexp,op,nu,alpha,len,clen,median_cycles,p99_cycles,msgs_per_sec%s\n",
+               opt.counters ? ",instructions,ipc,branch_misses_per_1k,l1d_misses_per_1k" : "");
+
+    for (b.mode = MODE_MANX1; b.mode <= MODE_MANX2; b.mode++) {
+        if (opt.mode >= 0 && opt.mode != b.mode)
+            continue;
+        for (int i = 0; i < AES128_IMPL_COUNT; i++) {
+            if (!aes128_impl_supported(i))
+                continue;
+            b.cipher = aes128_cipher(i);
+            if (opt.backend && strcmp(opt.backend, b.cipher->name))
+                continue;
+            manx_ctx_init(&b.ctx, key, b.cipher);
+            bench_mode(&b, b.cipher->name);
+            manx_ctx_wipe(&b.ctx);
+        }
+    }
+#ifdef MANX_SUITE_OPENSSL
+    b.mode = MODE_GCM;
+    if ((opt.mode < 0 || opt.mode == MODE_GCM) && (!opt.backend || !strcmp(opt.backend, "OpenSSL"))) {
+        b.cipher = NULL;
+        b.gcm    = EVP_CIPHER_CTX_new();
+        EVP_EncryptInit_ex(b.gcm, EVP_aes_128_gcm(), NULL, key, NULL);
+        bench_mode(&b, "OpenSSL");
+        EVP_CIPHER_CTX_free(b.gcm);
+    }
+#endif
+
+    if (opt.json)
+        printf("\n  ]\n}\n");
+    if (opt.counters)
+        pmu_close();
+    return 0;
+}
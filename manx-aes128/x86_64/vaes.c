@@ -0,0 +1,126 @@
+#include <immintrin.h>
+#include "block_cipher.h"
+
+/**
+ * Targets of the VAES kernels (see manx-cpu.h and aes128_vaes_width).
+ */
+#define VAES256 __attribute__((target("vaes,avx2")))
+#define VAES512 __attribute__((target("vaes,avx512f")))
+
+/**
+ * Process NV vectors of 2 blocks each in lockstep, using the 256-bit round
+ * keys rk (OP is either enc or dec).
+ */
+#define VAES256_ROUNDS(OP, NV)                                                \
+  do {                                                                        \
+    __m256i state[NV];                                                        \
+    for(j = 0; j < NV; j++)                                                   \
+      state[j] = _mm256_xor_si256(                                            \
+        _mm256_loadu_si256((const __m256i*)(in + 2*j*BLOCKBYTES)), rk[0]);    \
+    for(i = 1; i < 10; i++)                                                   \
+      for(j = 0; j < NV; j++)                                                 \
+        state[j] = _mm256_aes##OP##_epi128(state[j], rk[i]);                  \
+    for(j = 0; j < NV; j++)                                                   \
+      _mm256_storeu_si256((__m256i*)(out + 2*j*BLOCKBYTES),                   \
+        _mm256_aes##OP##last_epi128(state[j], rk[10]));                       \
+    in += 2*NV*BLOCKBYTES, out += 2*NV*BLOCKBYTES, nblocks -= 2*NV;           \
+  } while (0)
+
+/**
+ * Process NV vectors of 4 blocks each in lockstep, using the 512-bit round
+ * keys rk (OP is either enc or dec).
+ */
+#define VAES512_ROUNDS(OP, NV)                                                \
+  do {                                                                        \
+    __m512i state[NV];                                                        \
+    for(j = 0; j < NV; j++)                                                   \
+      state[j] = _mm512_xor_si512(                                            \
+        _mm512_loadu_si512((const void*)(in + 4*j*BLOCKBYTES)), rk[0]);       \
+    for(i = 1; i < 10; i++)                                                   \
+      for(j = 0; j < NV; j++)                                                 \
+        state[j] = _mm512_aes##OP##_epi128(state[j], rk[i]);                  \
+    for(j = 0; j < NV; j++)                                                   \
+      _mm512_storeu_si512((void*)(out + 4*j*BLOCKBYTES),                      \
+        _mm512_aes##OP##last_epi128(state[j], rk[10]));                       \
+    in += 4*NV*BLOCKBYTES, out += 4*NV*BLOCKBYTES, nblocks -= 4*NV;           \
+  } while (0)
+
+VAES256 void aes128_enc_blocks_vaes256(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys)
+{
+  unsigned int i, j;
+  __m256i rk[11];
+
+  for(i = 0; i < 11; i++)
+    rk[i] = _mm256_broadcastsi128_si256(roundkeys->rk[i]);
+  while (nblocks >= 8)
+    VAES256_ROUNDS(enc, 4);
+  while (nblocks >= 2)
+    VAES256_ROUNDS(enc, 1);
+  if (nblocks)
+    aes128_enc(out, in, roundkeys);
+}
+
+VAES256 void aes128_dec_inv_blocks_vaes256(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys_inv)
+{
+  unsigned int i, j;
+  __m256i rk[11];
+
+  for(i = 0; i < 11; i++)
+    rk[i] = _mm256_broadcastsi128_si256(roundkeys_inv->rk[i]);
+  while (nblocks >= 8)
+    VAES256_ROUNDS(dec, 4);
+  while (nblocks >= 2)
+    VAES256_ROUNDS(dec, 1);
+  if (nblocks)
+    aes128_dec_inv(out, in, roundkeys_inv);
+}
+
+VAES512 void aes128_enc_blocks_vaes512(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys)
+{
+  unsigned int i, j;
+  __m512i rk[11];
+
+  for(i = 0; i < 11; i++)
+    rk[i] = _mm512_broadcast_i32x4(roundkeys->rk[i]);
+  while (nblocks >= 16)
+    VAES512_ROUNDS(enc, 4);
+  while (nblocks >= 4)
+    VAES512_ROUNDS(enc, 1);
+  aes128_enc_blocks(out, in, nblocks, roundkeys);
+}
+
+VAES512 void aes128_dec_inv_blocks_vaes512(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys_inv)
+{
+  unsigned int i, j;
+  __m512i rk[11];
+
+  for(i = 0; i < 11; i++)
+    rk[i] = _mm512_broadcast_i32x4(roundkeys_inv->rk[i]);
+  while (nblocks >= 16)
+    VAES512_ROUNDS(dec, 4);
+  while (nblocks >= 4)
+    VAES512_ROUNDS(dec, 1);
+  aes128_dec_inv_blocks(out, in, nblocks, roundkeys_inv);
+}
+
+/**
+ * Multi-block functions relying on the widest VAES kernels supported by the
+ * CPU, falling back on the AES-NI ones otherwise.
+ */
+void aes128_enc_blocks_vaes(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys)
+{
+  switch (aes128_vaes_width()) {
+    case 512: aes128_enc_blocks_vaes512(out, in, nblocks, roundkeys); break;
+    case 256: aes128_enc_blocks_vaes256(out, in, nblocks, roundkeys); break;
+    default:  aes128_enc_blocks(out, in, nblocks, roundkeys);
+  }
+}
+
+void aes128_dec_inv_blocks_vaes(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys_inv)
+{
+  switch (aes128_vaes_width()) {
+    case 512: aes128_dec_inv_blocks_vaes512(out, in, nblocks, roundkeys_inv); break;
+    case 256: aes128_dec_inv_blocks_vaes256(out, in, nblocks, roundkeys_inv); break;
+    default:  aes128_dec_inv_blocks(out, in, nblocks, roundkeys_inv);
+  }
+}
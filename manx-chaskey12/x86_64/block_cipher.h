@@ -0,0 +1,38 @@
+#ifndef CHASKEYEM12_H_
+#define CHASKEYEM12_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define KEYBYTES    16
+#define BLOCKBYTES  16
+
+// Chaskey-EM-12 does not require any key expansion (Even-Mansour scheme): the
+// "round keys" boil down to the key loaded as 4 little-endian 32-bit words,
+// used for both encryption and decryption
+typedef struct { uint32_t k[4]; } roundkeys_t;
+
+// portable implementation in C
+void chaskey12_kexp(roundkeys_t* roundkeys, const unsigned char k[KEYBYTES]);
+void chaskey12_enc(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys);
+void chaskey12_dec(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys);
+void chaskey12_enc_blocks(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys);
+void chaskey12_dec_blocks(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys);
+
+// AVX2 kernels processing 8 independent blocks in 32-bit lanes: they must only
+// be called if chaskey12_impl_supported(CHASKEY12_IMPL_AVX2) returns 1 (see
+// dispatch.h), the *_blocks_avx2 functions relying on the portable ones for
+// the last nblocks % 8 blocks
+void chaskey12_enc_x8_avx2(unsigned char out[8*BLOCKBYTES], const unsigned char in[8*BLOCKBYTES], const roundkeys_t* roundkeys);
+void chaskey12_dec_x8_avx2(unsigned char out[8*BLOCKBYTES], const unsigned char in[8*BLOCKBYTES], const roundkeys_t* roundkeys);
+void chaskey12_enc_blocks_avx2(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys);
+void chaskey12_dec_blocks_avx2(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys);
+
+// portable functions bound at compile time to the manx*_static_* functions of
+// the generic Manx implementation (see MANX_STATIC_CIPHER in manx-config.h)
+#include "chaskey12.h"
+#define MANX_STATIC_KEXPAND chaskey12_kexp_inline
+#define MANX_STATIC_ENCRYPT chaskey12_enc_inline
+#define MANX_STATIC_DECRYPT chaskey12_dec_inline
+
+#endif  // CHASKEYEM12_H_
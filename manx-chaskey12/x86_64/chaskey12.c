@@ -0,0 +1,39 @@
+#include "chaskey12.h"
+
+/**
+ * Load the key as 4 little-endian 32-bit words (no key expansion).
+ */
+void chaskey12_kexp(roundkeys_t* roundkeys, const unsigned char key[KEYBYTES])
+{
+  chaskey12_kexp_inline(roundkeys, key);
+}
+
+void chaskey12_enc(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys)
+{
+  chaskey12_enc_inline(out, in, roundkeys);
+}
+
+void chaskey12_dec(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys)
+{
+  chaskey12_dec_inline(out, in, roundkeys);
+}
+
+/**
+ * Encrypt (resp. decrypt) nblocks independent blocks one at a time, the
+ * processor being free to overlap consecutive calls. The single-block
+ * functions are not inlined on purpose: the loops would otherwise be
+ * auto-vectorized with SSE2 code that is only faster than the scalar one for
+ * 16 blocks or more, and slower for 8 to 15 blocks (see chaskey12_avx2.c for
+ * the vectorized kernels).
+ */
+void chaskey12_enc_blocks(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys)
+{
+  for (size_t i = 0; i < nblocks; i++)
+    chaskey12_enc(out + i*BLOCKBYTES, in + i*BLOCKBYTES, roundkeys);
+}
+
+void chaskey12_dec_blocks(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys)
+{
+  for (size_t i = 0; i < nblocks; i++)
+    chaskey12_dec(out + i*BLOCKBYTES, in + i*BLOCKBYTES, roundkeys);
+}
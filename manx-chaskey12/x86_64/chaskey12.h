@@ -0,0 +1,93 @@
+#ifndef CHASKEY12_H_
+#define CHASKEY12_H_
+
+#include "block_cipher.h"
+
+/**
+ * Portable Chaskey-EM-12 key loading and single-block functions, defined
+ * inline so that they can be bound at compile time to the generic Manx
+ * implementation (see block_cipher.h) as well as wrapped by chaskey12.c.
+ *
+ * The block cipher is the Even-Mansour construction E_K(P) = K ^ π(K ^ P)
+ * over the 12-round Chaskey permutation π, whose state is made of 4 32-bit
+ * words loaded from the block in little-endian order. Decryption relies on the
+ * inverse permutation and on the same key.
+ */
+#define CHASKEY12_INLINE static inline __attribute__((always_inline))
+
+#define ROL32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+#define ROR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+CHASKEY12_INLINE uint32_t chaskey12_load32(const unsigned char *a)
+{
+  return ((uint32_t)a[3] << 24) | ((uint32_t)a[2] << 16) | ((uint32_t)a[1] << 8) | (uint32_t)a[0];
+}
+
+CHASKEY12_INLINE void chaskey12_store32(unsigned char *a, uint32_t x)
+{
+  a[0] = x;
+  a[1] = x >> 8;
+  a[2] = x >> 16;
+  a[3] = x >> 24;
+}
+
+/**
+ * Chaskey round and its inverse.
+ */
+#define CHASKEY_ROUND(v0, v1, v2, v3)                                         \
+  do {                                                                        \
+    v0 += v1; v1 = ROL32(v1, 5) ^ v0; v0 = ROL32(v0, 16);                     \
+    v2 += v3; v3 = ROL32(v3, 8) ^ v2;                                         \
+    v0 += v3; v3 = ROL32(v3, 13) ^ v0;                                        \
+    v2 += v1; v1 = ROL32(v1, 7) ^ v2; v2 = ROL32(v2, 16);                     \
+  } while (0)
+
+#define CHASKEY_INV_ROUND(v0, v1, v2, v3)                                     \
+  do {                                                                        \
+    v2 = ROR32(v2, 16); v1 = ROR32(v1 ^ v2, 7); v2 -= v1;                     \
+    v3 = ROR32(v3 ^ v0, 13); v0 -= v3;                                        \
+    v3 = ROR32(v3 ^ v2, 8); v2 -= v3;                                         \
+    v0 = ROR32(v0, 16); v1 = ROR32(v1 ^ v0, 5); v0 -= v1;                     \
+  } while (0)
+
+CHASKEY12_INLINE void chaskey12_kexp_inline(roundkeys_t* roundkeys, const unsigned char key[KEYBYTES])
+{
+  for (int i = 0; i < 4; i++)
+    roundkeys->k[i] = chaskey12_load32(key + 4*i);
+}
+
+CHASKEY12_INLINE void chaskey12_enc_inline(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys)
+{
+  const uint32_t *k = roundkeys->k;
+  uint32_t v0 = chaskey12_load32(in)      ^ k[0];
+  uint32_t v1 = chaskey12_load32(in + 4)  ^ k[1];
+  uint32_t v2 = chaskey12_load32(in + 8)  ^ k[2];
+  uint32_t v3 = chaskey12_load32(in + 12) ^ k[3];
+
+  for (int i = 0; i < 12; i++)
+    CHASKEY_ROUND(v0, v1, v2, v3);
+
+  chaskey12_store32(out,      v0 ^ k[0]);
+  chaskey12_store32(out + 4,  v1 ^ k[1]);
+  chaskey12_store32(out + 8,  v2 ^ k[2]);
+  chaskey12_store32(out + 12, v3 ^ k[3]);
+}
+
+CHASKEY12_INLINE void chaskey12_dec_inline(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys)
+{
+  const uint32_t *k = roundkeys->k;
+  uint32_t v0 = chaskey12_load32(in)      ^ k[0];
+  uint32_t v1 = chaskey12_load32(in + 4)  ^ k[1];
+  uint32_t v2 = chaskey12_load32(in + 8)  ^ k[2];
+  uint32_t v3 = chaskey12_load32(in + 12) ^ k[3];
+
+  for (int i = 0; i < 12; i++)
+    CHASKEY_INV_ROUND(v0, v1, v2, v3);
+
+  chaskey12_store32(out,      v0 ^ k[0]);
+  chaskey12_store32(out + 4,  v1 ^ k[1]);
+  chaskey12_store32(out + 8,  v2 ^ k[2]);
+  chaskey12_store32(out + 12, v3 ^ k[3]);
+}
+
+#endif
@@ -0,0 +1,175 @@
+#include <immintrin.h>
+#include <string.h>
+#include "block_cipher.h"
+
+/**
+ * AVX2 kernels, compiled for their own target (see manx-cpu.h).
+ *
+ * 8 independent blocks are processed in lockstep, v[i] holding the i-th
+ * 32-bit word of each block (block j in lane j), so that the additions,
+ * rotations and XORs of the Chaskey round map directly to 32-bit lane
+ * operations. The 16-bit (resp. 8-bit) rotations are byte shuffles, the
+ * other ones being made of 2 shifts and an OR.
+ */
+#define AVX2 __attribute__((target("avx2")))
+
+#define ROL(x, n) _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - (n)))
+#define ROR(x, n) ROL(x, 32 - (n))
+#define ROT8(x)   _mm256_shuffle_epi8(x, rot8)
+#define ROL16(x)  _mm256_shuffle_epi8(x, rol16)
+#define ADD(x, y) _mm256_add_epi32(x, y)
+#define SUB(x, y) _mm256_sub_epi32(x, y)
+#define XOR(x, y) _mm256_xor_si256(x, y)
+
+/**
+ * Byte shuffles rotating each 32-bit lane by 8 bits to the left (encryption)
+ * or to the right (decryption), and by 16 bits.
+ */
+#define ENC_ROT8                                                              \
+  _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,      \
+                   3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14)
+#define DEC_ROT8                                                              \
+  _mm256_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12,      \
+                   1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12)
+#define ROT_MASKS(OP)                                                         \
+  const __m256i rot8  = OP##_ROT8;                                            \
+  const __m256i rol16 = _mm256_setr_epi8(                                     \
+    2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,                     \
+    2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13)
+
+/**
+ * Transpose the 4x4 matrices of 32-bit words held in each 128-bit half of
+ * x0..x3. It turns the blocks j and j+4 held in x_j into the words v0..v3 of
+ * the 8 blocks, and conversely.
+ */
+#define TRANSPOSE(x0, x1, x2, x3)                                             \
+  do {                                                                        \
+    __m256i t0 = _mm256_unpacklo_epi32(x0, x1);                               \
+    __m256i t1 = _mm256_unpackhi_epi32(x0, x1);                               \
+    __m256i t2 = _mm256_unpacklo_epi32(x2, x3);                               \
+    __m256i t3 = _mm256_unpackhi_epi32(x2, x3);                               \
+    x0 = _mm256_unpacklo_epi64(t0, t2);                                       \
+    x1 = _mm256_unpackhi_epi64(t0, t2);                                       \
+    x2 = _mm256_unpacklo_epi64(t1, t3);                                       \
+    x3 = _mm256_unpackhi_epi64(t1, t3);                                       \
+  } while (0)
+
+AVX2 static inline __m256i load2(const unsigned char* in, size_t j)
+{
+  __m128i lo = _mm_loadu_si128((const __m128i*)(in + j*BLOCKBYTES));
+  __m128i hi = _mm_loadu_si128((const __m128i*)(in + (j+4)*BLOCKBYTES));
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+AVX2 static inline void store2(unsigned char* out, size_t j, __m256i x)
+{
+  _mm_storeu_si128((__m128i*)(out + j*BLOCKBYTES), _mm256_castsi256_si128(x));
+  _mm_storeu_si128((__m128i*)(out + (j+4)*BLOCKBYTES), _mm256_extracti128_si256(x, 1));
+}
+
+/**
+ * Process NV groups of 8 blocks in lockstep (OP is either ENC or DEC), the
+ * key words being broadcast in k[0..3].
+ */
+#define CHASKEY12_AVX2(OP, NV)                                                \
+  do {                                                                        \
+    __m256i v[NV][4];                                                         \
+    for (j = 0; j < NV; j++) {                                                \
+      for (i = 0; i < 4; i++)                                                 \
+        v[j][i] = load2(in + 8*j*BLOCKBYTES, i);                              \
+      TRANSPOSE(v[j][0], v[j][1], v[j][2], v[j][3]);                          \
+      for (i = 0; i < 4; i++)                                                 \
+        v[j][i] = XOR(v[j][i], k[i]);                                         \
+    }                                                                         \
+    for (r = 0; r < 12; r++)                                                  \
+      for (j = 0; j < NV; j++)                                                \
+        OP##_ROUND(v[j][0], v[j][1], v[j][2], v[j][3]);                       \
+    for (j = 0; j < NV; j++) {                                                \
+      for (i = 0; i < 4; i++)                                                 \
+        v[j][i] = XOR(v[j][i], k[i]);                                         \
+      TRANSPOSE(v[j][0], v[j][1], v[j][2], v[j][3]);                          \
+      for (i = 0; i < 4; i++)                                                 \
+        store2(out + 8*j*BLOCKBYTES, i, v[j][i]);                             \
+    }                                                                         \
+    in += 8*NV*BLOCKBYTES, out += 8*NV*BLOCKBYTES, nblocks -= 8*NV;           \
+  } while (0)
+
+#define ENC_ROUND(v0, v1, v2, v3)                                             \
+  do {                                                                        \
+    v0 = ADD(v0, v1); v1 = XOR(ROL(v1, 5), v0); v0 = ROL16(v0);               \
+    v2 = ADD(v2, v3); v3 = XOR(ROT8(v3), v2);                                 \
+    v0 = ADD(v0, v3); v3 = XOR(ROL(v3, 13), v0);                              \
+    v2 = ADD(v2, v1); v1 = XOR(ROL(v1, 7), v2); v2 = ROL16(v2);               \
+  } while (0)
+
+#define DEC_ROUND(v0, v1, v2, v3)                                             \
+  do {                                                                        \
+    v2 = ROL16(v2); v1 = ROR(XOR(v1, v2), 7); v2 = SUB(v2, v1);               \
+    v3 = ROR(XOR(v3, v0), 13); v0 = SUB(v0, v3);                              \
+    v3 = ROT8(XOR(v3, v2)); v2 = SUB(v2, v3);                                 \
+    v0 = ROL16(v0); v1 = ROR(XOR(v1, v0), 5); v0 = SUB(v0, v1);               \
+  } while (0)
+
+#define KEY_BROADCAST                                                         \
+  __m256i k[4];                                                               \
+  for (i = 0; i < 4; i++)                                                     \
+    k[i] = _mm256_set1_epi32(roundkeys->k[i])
+
+AVX2 void chaskey12_enc_x8_avx2(unsigned char out[8*BLOCKBYTES], const unsigned char in[8*BLOCKBYTES], const roundkeys_t* roundkeys)
+{
+  unsigned int i, j, r;
+  size_t nblocks = 8;
+  ROT_MASKS(ENC);
+  KEY_BROADCAST;
+
+  CHASKEY12_AVX2(ENC, 1);
+}
+
+AVX2 void chaskey12_dec_x8_avx2(unsigned char out[8*BLOCKBYTES], const unsigned char in[8*BLOCKBYTES], const roundkeys_t* roundkeys)
+{
+  unsigned int i, j, r;
+  size_t nblocks = 8;
+  ROT_MASKS(DEC);
+  KEY_BROADCAST;
+
+  CHASKEY12_AVX2(DEC, 1);
+}
+
+/**
+ * Process groups of 16 then 8 blocks, two independent groups hiding the
+ * latency of the round dependency chain. The last nblocks % 8 blocks are
+ * processed by a padded 8-block kernel if they are numerous enough to
+ * amortize it, and by the portable functions otherwise.
+ */
+#define CHASKEY12_AVX2_TAIL 3
+
+#define CHASKEY12_AVX2_BLOCKS(OP, op)                                         \
+  do {                                                                        \
+    unsigned int i, j, r;                                                     \
+    ROT_MASKS(OP);                                                            \
+    KEY_BROADCAST;                                                            \
+    while (nblocks >= 16)                                                     \
+      CHASKEY12_AVX2(OP, 2);                                                  \
+    if (nblocks >= 8)                                                         \
+      CHASKEY12_AVX2(OP, 1);                                                  \
+    if (nblocks >= CHASKEY12_AVX2_TAIL) {                                     \
+      unsigned char buf[8*BLOCKBYTES] = {0};                                  \
+      size_t n = nblocks;                                                     \
+      unsigned char* dst = out;                                               \
+      memcpy(buf, in, n*BLOCKBYTES);                                          \
+      in = buf, out = buf;                                                    \
+      CHASKEY12_AVX2(OP, 1);                                                  \
+      memcpy(dst, buf, n*BLOCKBYTES);                                         \
+    } else                                                                    \
+      chaskey12_##op##_blocks(out, in, nblocks, roundkeys);                   \
+  } while (0)
+
+AVX2 void chaskey12_enc_blocks_avx2(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys)
+{
+  CHASKEY12_AVX2_BLOCKS(ENC, enc);
+}
+
+AVX2 void chaskey12_dec_blocks_avx2(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys)
+{
+  CHASKEY12_AVX2_BLOCKS(DEC, dec);
+}
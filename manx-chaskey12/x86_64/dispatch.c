@@ -0,0 +1,48 @@
+#include "dispatch.h"
+#include "manx-cpu.h"
+
+static const manx_cipher ciphers[CHASKEY12_IMPL_COUNT] = {
+  [CHASKEY12_IMPL_C] = {
+    .name           = "portable C",
+    .kexpand        = chaskey12_kexp,
+    .encrypt        = chaskey12_enc,
+    .decrypt        = chaskey12_dec,
+    .encrypt_blocks = chaskey12_enc_blocks,
+    .decrypt_blocks = chaskey12_dec_blocks,
+  },
+  [CHASKEY12_IMPL_AVX2] = {
+    .name           = "AVX2",
+    .kexpand        = chaskey12_kexp,
+    .encrypt        = chaskey12_enc,
+    .decrypt        = chaskey12_dec,
+    .encrypt_blocks = chaskey12_enc_blocks_avx2,
+    .decrypt_blocks = chaskey12_dec_blocks_avx2,
+  },
+};
+
+/**
+ * Features required by each implementation (see manx-cpu.h).
+ */
+static const int required[CHASKEY12_IMPL_COUNT] = {
+  [CHASKEY12_IMPL_AVX2] = MANX_CPU_AVX2,
+};
+
+int chaskey12_impl_supported(chaskey12_impl impl)
+{
+  return impl >= 0 && impl < CHASKEY12_IMPL_COUNT && manx_cpu_supports(required[impl]);
+}
+
+chaskey12_impl chaskey12_impl_best(void)
+{
+  return manx_cpu_best(required, CHASKEY12_IMPL_COUNT);
+}
+
+const manx_cipher* chaskey12_cipher(chaskey12_impl impl)
+{
+  return chaskey12_impl_supported(impl) ? &ciphers[impl] : NULL;
+}
+
+const manx_cipher* chaskey12_cipher_best(void)
+{
+  return &ciphers[chaskey12_impl_best()];
+}
@@ -0,0 +1,28 @@
+#ifndef DISPATCH_H_
+#define DISPATCH_H_
+
+#include "manx.h"
+
+/**
+ * Chaskey-12 implementations available on x86_64, from the slowest to the
+ * fastest one.
+ */
+typedef enum {
+  CHASKEY12_IMPL_C,     // portable C, one block at a time (chaskey12.c)
+  CHASKEY12_IMPL_AVX2,  // AVX2, 8 blocks in 32-bit lanes (chaskey12_avx2.c)
+  CHASKEY12_IMPL_COUNT
+} chaskey12_impl;
+
+// return 1 if the CPU (and the OS) supports the implementation, 0 otherwise
+int chaskey12_impl_supported(chaskey12_impl impl);
+
+// fastest implementation supported, the CPU being probed once and for all
+chaskey12_impl chaskey12_impl_best(void);
+
+// functions of a given implementation to be passed to manx_ctx_init (NULL if not supported)
+const manx_cipher* chaskey12_cipher(chaskey12_impl impl);
+
+// functions of the fastest implementation supported
+const manx_cipher* chaskey12_cipher_best(void);
+
+#endif
@@ -0,0 +1 @@
+../../manx/manx-bulk.c
\ No newline at end of file
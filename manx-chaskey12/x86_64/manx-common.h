@@ -0,0 +1 @@
+../../manx/manx-common.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../manx/manx-cpu.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../manx/manx-keycache.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../manx/manx.h
\ No newline at end of file
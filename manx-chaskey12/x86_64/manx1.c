@@ -0,0 +1 @@
+../../manx/manx1.c
\ No newline at end of file
@@ -0,0 +1 @@
+../../manx/manx2.c
\ No newline at end of file
@@ -0,0 +1,17 @@
+#define MANX_BENCH_AESNI
+#include "../dispatch.h"
+#include "manx-bench.h"
+
+static const size_t frames[] = { 1, 2, 4, 8, 16, NBLOCKS };
+
+int main(void) {
+    uint8_t            key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    const manx_cipher *ciphers[CHASKEY12_IMPL_COUNT];
+
+    printf("Chaskey-12 implementation selected: %s\n\n", chaskey12_cipher_best()->name);
+    for (int i = 0; i < CHASKEY12_IMPL_COUNT; i++)
+        ciphers[i] = chaskey12_cipher(i);
+    bench_ciphers(ciphers, CHASKEY12_IMPL_COUNT, key, frames, sizeof(frames)/sizeof(frames[0]));
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include "../dispatch.h"
+#include "manx-check.h"
+
+/**
+ * Straightforward transcription of ../../armv7m/chaskey12.S (right rotations
+ * only), as a reference for the portable and AVX2 implementations.
+ */
+#define ROR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void chaskey12_ref(uint8_t ctext[16], const uint8_t ptext[16], const uint8_t key[16])
+{
+    uint32_t r[4], k[4];
+
+    memcpy(r, ptext, 16);
+    memcpy(k, key, 16);
+    for (int i = 0; i < 4; i++)
+        r[i] ^= k[i];
+    for (int i = 0; i < 12; i++) {
+        r[0] += r[1];
+        r[1]  = r[0] ^ ROR(r[1], 32-5);
+        r[2] += r[3];
+        r[3]  = r[2] ^ ROR(r[3], 32-8);
+        r[0]  = r[3] + ROR(r[0], 16);
+        r[3]  = r[0] ^ ROR(r[3], 32-13);
+        r[2] += r[1];
+        r[1]  = r[2] ^ ROR(r[1], 32-7);
+        r[2]  = ROR(r[2], 16);
+    }
+    for (int i = 0; i < 4; i++)
+        r[i] ^= k[i];
+    memcpy(ctext, r, 16);
+}
+
+/**
+ * Portable block cipher against the reference one, decryption round trips
+ * and the functions bound at compile time.
+ */
+static void check_cipher(const uint8_t key[16])
+{
+    uint8_t     in[BLOCKBYTES], ref[BLOCKBYTES], out[BLOCKBYTES], inv[BLOCKBYTES];
+    roundkeys_t rkeys;
+    int         ok_enc = 1, ok_dec = 1, ok_static = 1;
+
+    chaskey12_kexp(&rkeys, key);
+    for (size_t i = 0; i < 1000; i++) {
+        fill(in, sizeof(in), i);
+        in[i % BLOCKBYTES] ^= i >> 4;
+        chaskey12_ref(ref, in, key);
+        chaskey12_enc(out, in, &rkeys);
+        ok_enc &= memcmp(ref, out, sizeof(out)) == 0;
+        chaskey12_dec(inv, out, &rkeys);
+        ok_dec &= memcmp(in, inv, sizeof(in)) == 0;
+#if MANX_STATIC_BOUND
+        MANX_STATIC_ENCRYPT(out, in, &rkeys);
+        ok_static &= memcmp(ref, out, sizeof(out)) == 0;
+        MANX_STATIC_DECRYPT(inv, out, &rkeys);
+        ok_static &= memcmp(in, inv, sizeof(in)) == 0;
+#endif
+    }
+    check(ok_enc, "chaskey12_enc matches chaskey12.S");
+    check(ok_dec, "chaskey12_dec inverts chaskey12_enc");
+    check(ok_static, "inline functions match chaskey12_enc and chaskey12_dec");
+}
+
+static void check_x8(const uint8_t key[16])
+{
+    uint8_t     in[8*BLOCKBYTES], ref[8*BLOCKBYTES], out[8*BLOCKBYTES];
+    roundkeys_t rkeys;
+
+    if (!chaskey12_impl_supported(CHASKEY12_IMPL_AVX2))
+        return;
+    chaskey12_kexp(&rkeys, key);
+    fill(in, sizeof(in), 0x42);
+    chaskey12_enc_blocks(ref, in, 8, &rkeys);
+    chaskey12_enc_x8_avx2(out, in, &rkeys);
+    check(memcmp(ref, out, sizeof(out)) == 0, "chaskey12_enc_x8_avx2 matches chaskey12_enc");
+    chaskey12_dec_blocks(ref, in, 8, &rkeys);
+    chaskey12_dec_x8_avx2(out, in, &rkeys);
+    check(memcmp(ref, out, sizeof(out)) == 0, "chaskey12_dec_x8_avx2 matches chaskey12_dec");
+}
+
+/**
+ * Known-answer ciphertexts for the same inputs as the AES-128 ones in
+ * ../../../manx-aes128/x86_64/test/check.c (the block cipher itself being
+ * checked against a transcription of chaskey12.S, see chaskey12_ref).
+ */
+static const check_suite suite = {
+    .kexpand            = chaskey12_kexp,
+    .encrypt            = chaskey12_enc,
+    .decrypt            = chaskey12_dec,
+    .kat_manx1_96_30_64 = "8d8d59ade8de69aa07b7d17ba0a86d26",
+    .kat_manx1_128_63_0 = "c2d4ea8983a8c24b36efa740d398c8b8",
+    .kat_manx2_64_96_0  = "bf56d9477bf067a4b3324d200521b2ea6e9f4af67ebfa282fda9d2e5981a76e1",
+    .sweep_manx1        = 0x367710a7b938115fULL,
+    .sweep_manx2        = 0xba8bc8d9799d05e4ULL,
+    .check_impl         = check_kat,
+};
+
+int main(void) {
+    uint8_t            key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    const manx_cipher *ciphers[CHASKEY12_IMPL_COUNT];
+
+    printf("Chaskey-12 implementation selected: %s\n", chaskey12_cipher_best()->name);
+    check_cipher(key);
+    check_x8(key);
+
+    for (int i = 0; i < CHASKEY12_IMPL_COUNT; i++)
+        ciphers[i] = chaskey12_cipher(i);
+    check_ciphers(&suite, ciphers, CHASKEY12_IMPL_COUNT, key);
+
+    printf("%s\n", failures ? "checks FAILED" : "all checks passed");
+    return failures != 0;
+}
@@ -0,0 +1 @@
+../../../manx/test/manx-bench-aesni.c
\ No newline at end of file
@@ -0,0 +1 @@
+../../../manx/test/manx-bench.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../manx/manx-fixed.h
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef GIFT128_H_
+#define GIFT128_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define KEYBYTES    16
+#define BLOCKBYTES  16
+
+// GIFTb-128 (i.e. GIFT-128 on inputs already in bitsliced representation, as
+// in ../armv7m/gift128.S) round keys in fixsliced representation, computed by
+// giftb128_kexp and used for both encryption and decryption
+typedef struct { uint32_t rk[80]; } roundkeys_t;
+
+// portable fixsliced implementation in C
+void giftb128_kexp(roundkeys_t* roundkeys, const unsigned char k[KEYBYTES]);
+void giftb128_enc(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys);
+void giftb128_dec(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys);
+void giftb128_enc_blocks(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys);
+void giftb128_dec_blocks(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys);
+
+// AVX2 kernels processing 8 independent blocks in 32-bit lanes, up to 32 of
+// them per iteration in the *_blocks_avx2 functions which rely on the portable
+// ones for the last blocks: they must only be called if
+// giftb128_impl_supported(GIFTB128_IMPL_AVX2) returns 1 (see dispatch.h)
+void giftb128_enc_x8_avx2(unsigned char out[8*BLOCKBYTES], const unsigned char in[8*BLOCKBYTES], const roundkeys_t* roundkeys);
+void giftb128_dec_x8_avx2(unsigned char out[8*BLOCKBYTES], const unsigned char in[8*BLOCKBYTES], const roundkeys_t* roundkeys);
+void giftb128_enc_blocks_avx2(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys);
+void giftb128_dec_blocks_avx2(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys);
+
+// portable functions bound at compile time to the manx*_static_* functions of
+// the generic Manx implementation (see MANX_STATIC_CIPHER in manx-config.h),
+// not inlined as the quintuple rounds would only bloat the mode code
+#define MANX_STATIC_KEXPAND giftb128_kexp
+#define MANX_STATIC_ENCRYPT giftb128_enc
+#define MANX_STATIC_DECRYPT giftb128_dec
+
+#endif  // GIFT128_H_
@@ -0,0 +1,48 @@
+#include "dispatch.h"
+#include "manx-cpu.h"
+
+static const manx_cipher ciphers[GIFTB128_IMPL_COUNT] = {
+  [GIFTB128_IMPL_C] = {
+    .name           = "portable fixsliced C",
+    .kexpand        = giftb128_kexp,
+    .encrypt        = giftb128_enc,
+    .decrypt        = giftb128_dec,
+    .encrypt_blocks = giftb128_enc_blocks,
+    .decrypt_blocks = giftb128_dec_blocks,
+  },
+  [GIFTB128_IMPL_AVX2] = {
+    .name           = "AVX2",
+    .kexpand        = giftb128_kexp,
+    .encrypt        = giftb128_enc,
+    .decrypt        = giftb128_dec,
+    .encrypt_blocks = giftb128_enc_blocks_avx2,
+    .decrypt_blocks = giftb128_dec_blocks_avx2,
+  },
+};
+
+/**
+ * Features required by each implementation (see manx-cpu.h).
+ */
+static const int required[GIFTB128_IMPL_COUNT] = {
+  [GIFTB128_IMPL_AVX2] = MANX_CPU_AVX2,
+};
+
+int giftb128_impl_supported(giftb128_impl impl)
+{
+  return impl >= 0 && impl < GIFTB128_IMPL_COUNT && manx_cpu_supports(required[impl]);
+}
+
+giftb128_impl giftb128_impl_best(void)
+{
+  return manx_cpu_best(required, GIFTB128_IMPL_COUNT);
+}
+
+const manx_cipher* giftb128_cipher(giftb128_impl impl)
+{
+  return giftb128_impl_supported(impl) ? &ciphers[impl] : NULL;
+}
+
+const manx_cipher* giftb128_cipher_best(void)
+{
+  return &ciphers[giftb128_impl_best()];
+}
@@ -0,0 +1,28 @@
+#ifndef DISPATCH_H_
+#define DISPATCH_H_
+
+#include "manx.h"
+
+/**
+ * GIFTb-128 implementations available on x86_64, from the slowest to the
+ * fastest one.
+ */
+typedef enum {
+  GIFTB128_IMPL_C,     // portable fixsliced C, one block at a time (gift128.c)
+  GIFTB128_IMPL_AVX2,  // AVX2, 8 blocks in 32-bit lanes (gift128_avx2.c)
+  GIFTB128_IMPL_COUNT
+} giftb128_impl;
+
+// return 1 if the CPU (and the OS) supports the implementation, 0 otherwise
+int giftb128_impl_supported(giftb128_impl impl);
+
+// fastest implementation supported, the CPU being probed once and for all
+giftb128_impl giftb128_impl_best(void);
+
+// functions of a given implementation to be passed to manx_ctx_init (NULL if not supported)
+const manx_cipher* giftb128_cipher(giftb128_impl impl);
+
+// functions of the fastest implementation supported
+const manx_cipher* giftb128_cipher_best(void);
+
+#endif
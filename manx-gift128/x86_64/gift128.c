@@ -0,0 +1,268 @@
+#include "block_cipher.h"
+
+/**
+ * Portable and constant-time GIFTb-128 in C relying on fixslicing, ported
+ * from the ARMv7-M implementation (see ../armv7m/gift128.S and
+ * https://eprint.iacr.org/2020/412.pdf). As in Manx-GIFT128 on ARM and AVR,
+ * the block is loaded as 4 big-endian 32-bit words which are directly
+ * considered in bitsliced representation (GIFTb-128, as in GIFT-COFB), so
+ * that there is no packing/unpacking.
+ *
+ * The 40 rounds are computed as 8 quintuple rounds, each round of a quintuple
+ * round relying on a different representation of the state so that the bit
+ * permutation boils down to a few rotations and SWAPMOVEs. The round keys are
+ * computed in their classical representation before being rearranged
+ * accordingly, rounds 4 mod 5 keeping the classical one.
+ */
+
+#define ROR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+#define NIBBLE_ROR_1(x) ((((x) >> 1) & 0x77777777) | (((x) & 0x11111111) << 3))
+#define NIBBLE_ROR_2(x) ((((x) >> 2) & 0x33333333) | (((x) & 0x33333333) << 2))
+#define NIBBLE_ROR_3(x) ((((x) >> 3) & 0x11111111) | (((x) & 0x77777777) << 1))
+#define HALF_ROR_4(x)   ((((x) >> 4) & 0x0fff0fff) | (((x) & 0x000f000f) << 12))
+#define HALF_ROR_8(x)   ((((x) >> 8) & 0x00ff00ff) | (((x) & 0x00ff00ff) << 8))
+#define HALF_ROR_12(x)  ((((x) >> 12) & 0x000f000f) | (((x) & 0x0fff0fff) << 4))
+#define BYTE_ROR_2(x)   ((((x) >> 2) & 0x3f3f3f3f) | (((x) & 0x03030303) << 6))
+#define BYTE_ROR_4(x)   ((((x) >> 4) & 0x0f0f0f0f) | (((x) & 0x0f0f0f0f) << 4))
+#define BYTE_ROR_6(x)   ((((x) >> 6) & 0x03030303) | (((x) & 0x3f3f3f3f) << 2))
+
+#define SWAPMOVE(x, mask, n) do {                                             \
+    uint32_t t = ((x) ^ ((x) >> (n))) & (mask);                               \
+    (x) ^= t ^ (t << (n));                                                    \
+  } while (0)
+
+/**
+ * Round constants in fixsliced representation (5 per quintuple round).
+ */
+static const uint32_t rconst[40] = {
+  0x10000008, 0x80018000, 0x54000002, 0x01010181,
+  0x8000001f, 0x10888880, 0x6001e000, 0x51500002,
+  0x03030180, 0x8000002f, 0x10088880, 0x60016000,
+  0x41500002, 0x03030080, 0x80000027, 0x10008880,
+  0x4001e000, 0x11500002, 0x03020180, 0x8000002b,
+  0x10080880, 0x60014000, 0x01400002, 0x02020080,
+  0x80000021, 0x10000080, 0x0001c000, 0x51000002,
+  0x03010180, 0x8000002e, 0x10088800, 0x60012000,
+  0x40500002, 0x01030080, 0x80000006, 0x10008808,
+  0xc001a000, 0x14500002, 0x01020181, 0x8000001a
+};
+
+static inline uint32_t load_be32(const unsigned char* a)
+{
+  return ((uint32_t)a[0] << 24) | ((uint32_t)a[1] << 16) | ((uint32_t)a[2] << 8) | (uint32_t)a[3];
+}
+
+static inline void store_be32(unsigned char* a, uint32_t x)
+{
+  a[0] = x >> 24;
+  a[1] = x >> 16;
+  a[2] = x >> 8;
+  a[3] = x;
+}
+
+/**
+ * Key update in classical representation (two 16-bit rotations on V).
+ */
+static inline uint32_t key_update(uint32_t v)
+{
+  return ((v >> 12) & 0x0000000f) | ((v & 0x00000fff) << 4) |
+         ((v >> 2) & 0x3fff0000) | ((v & 0x00030000) << 14);
+}
+
+/**
+ * Rearrange a round key word from classical to fixsliced representation, for
+ * the round i of a quintuple round (i < 4).
+ */
+static inline uint32_t rearrange_rkey(uint32_t x, int i)
+{
+  static const struct { uint32_t m0, m1, m2; int n0, n1; } p[4] = {
+    { 0x00550055, 0x00003333, 0x000f000f,  9, 18 },
+    { 0x11111111, 0x03030303, 0x000f000f,  3,  6 },
+    { 0x0000aaaa, 0x00003333, 0x0000f0f0, 15, 18 },
+    { 0x0a0a0a0a, 0x00cc00cc, 0x0000f0f0,  3,  6 },
+  };
+  SWAPMOVE(x, p[i].m0, p[i].n0);
+  SWAPMOVE(x, p[i].m1, p[i].n1);
+  SWAPMOVE(x, p[i].m2, 12);
+  SWAPMOVE(x, 0x000000ff, 24);
+  return x;
+}
+
+/**
+ * Precompute the 80 round key words: the entire round key material is first
+ * computed in classical representation before being rearranged.
+ */
+void giftb128_kexp(roundkeys_t* roundkeys, const unsigned char key[KEYBYTES])
+{
+  uint32_t* rk = roundkeys->rk;
+  uint32_t  w[84];
+  int       i;
+
+  w[0] = load_be32(key + 12);
+  w[1] = load_be32(key + 4);
+  w[2] = load_be32(key + 8);
+  w[3] = load_be32(key);
+  for (i = 0; i < 80; i += 2) {
+    w[i+4] = w[i+1];
+    w[i+5] = key_update(w[i]);
+  }
+  for (i = 0; i < 80; i++)
+    rk[i] = (i % 10 < 8) ? rearrange_rkey(w[i], (i % 10) / 2) : w[i];
+}
+
+/**
+ * GIFT S-box on the 4 slices (the NOT operation included).
+ */
+#define SBOX(s0, s1, s2, s3) do {                                             \
+    s1 ^= s0 & s2;                                                            \
+    s0 ^= s1 & s3;                                                            \
+    s2 ^= s0 | s1;                                                            \
+    s3 ^= s2;                                                                 \
+    s1 ^= s3;                                                                 \
+    s3 = ~s3;                                                                 \
+    s2 ^= s0 & s1;                                                            \
+  } while (0)
+
+#define INV_SBOX(s0, s1, s2, s3) do {                                         \
+    s2 ^= s0 & s1;                                                            \
+    s3 = ~s3;                                                                 \
+    s1 ^= s3;                                                                 \
+    s3 ^= s2;                                                                 \
+    s2 ^= s0 | s1;                                                            \
+    s0 ^= s1 & s3;                                                            \
+    s1 ^= s0 & s2;                                                            \
+  } while (0)
+
+/**
+ * 5 consecutive rounds, rk and rc pointing to their 10 round key words and 5
+ * round constants.
+ */
+static inline void quintuple_round(uint32_t s[4], const uint32_t* rk, const uint32_t* rc)
+{
+  uint32_t s0 = s[0], s1 = s[1], s2 = s[2], s3 = s[3];
+
+  SBOX(s0, s1, s2, s3);
+  s3 = NIBBLE_ROR_1(s3);
+  s1 = NIBBLE_ROR_2(s1);
+  s2 = NIBBLE_ROR_3(s2);
+  s1 ^= rk[0];
+  s2 ^= rk[1];
+  s0 ^= rc[0];
+
+  SBOX(s3, s1, s2, s0);
+  s0 = HALF_ROR_4(s0);
+  s1 = HALF_ROR_8(s1);
+  s2 = HALF_ROR_12(s2);
+  s1 ^= rk[2];
+  s2 ^= rk[3];
+  s3 ^= rc[1];
+
+  SBOX(s0, s1, s2, s3);
+  s3 = ROR(s3, 16);
+  s2 = ROR(s2, 16);
+  SWAPMOVE(s1, 0x55555555, 1);
+  SWAPMOVE(s2, 0x00005555, 1);
+  SWAPMOVE(s3, 0x55550000, 1);
+  s1 ^= rk[4];
+  s2 ^= rk[5];
+  s0 ^= rc[2];
+
+  SBOX(s3, s1, s2, s0);
+  s0 = BYTE_ROR_6(s0);
+  s1 = BYTE_ROR_4(s1);
+  s2 = BYTE_ROR_2(s2);
+  s1 ^= rk[6];
+  s2 ^= rk[7];
+  s3 ^= rc[3];
+
+  SBOX(s0, s1, s2, s3);
+  s[0] = ROR(s3, 24);
+  s[1] = ROR(s1, 16) ^ rk[8];
+  s[2] = ROR(s2, 8) ^ rk[9];
+  s[3] = s0 ^ rc[4];
+}
+
+static inline void inv_quintuple_round(uint32_t s[4], const uint32_t* rk, const uint32_t* rc)
+{
+  uint32_t s0 = s[3] ^ rc[4], s1 = s[1] ^ rk[8], s2 = s[2] ^ rk[9], s3 = s[0];
+
+  s3 = ROR(s3, 8);
+  s1 = ROR(s1, 16);
+  s2 = ROR(s2, 24);
+  INV_SBOX(s0, s1, s2, s3);
+
+  s3 ^= rc[3];
+  s1 ^= rk[6];
+  s2 ^= rk[7];
+  s0 = BYTE_ROR_2(s0);
+  s1 = BYTE_ROR_4(s1);
+  s2 = BYTE_ROR_6(s2);
+  INV_SBOX(s3, s1, s2, s0);
+
+  s0 ^= rc[2];
+  s1 ^= rk[4];
+  s2 ^= rk[5];
+  SWAPMOVE(s1, 0x55555555, 1);
+  SWAPMOVE(s2, 0x00005555, 1);
+  SWAPMOVE(s3, 0x55550000, 1);
+  s3 = ROR(s3, 16);
+  s2 = ROR(s2, 16);
+  INV_SBOX(s0, s1, s2, s3);
+
+  s3 ^= rc[1];
+  s1 ^= rk[2];
+  s2 ^= rk[3];
+  s0 = HALF_ROR_12(s0);
+  s1 = HALF_ROR_8(s1);
+  s2 = HALF_ROR_4(s2);
+  INV_SBOX(s3, s1, s2, s0);
+
+  s0 ^= rc[0];
+  s1 ^= rk[0];
+  s2 ^= rk[1];
+  s3 = NIBBLE_ROR_3(s3);
+  s1 = NIBBLE_ROR_2(s1);
+  s2 = NIBBLE_ROR_1(s2);
+  INV_SBOX(s0, s1, s2, s3);
+
+  s[0] = s0, s[1] = s1, s[2] = s2, s[3] = s3;
+}
+
+void giftb128_enc(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys)
+{
+  uint32_t s[4];
+  int      i;
+
+  for (i = 0; i < 4; i++)
+    s[i] = load_be32(in + 4*i);
+  for (i = 0; i < 8; i++)
+    quintuple_round(s, roundkeys->rk + 10*i, rconst + 5*i);
+  for (i = 0; i < 4; i++)
+    store_be32(out + 4*i, s[i]);
+}
+
+void giftb128_dec(unsigned char out[BLOCKBYTES], const unsigned char in[BLOCKBYTES], const roundkeys_t* roundkeys)
+{
+  uint32_t s[4];
+  int      i;
+
+  for (i = 0; i < 4; i++)
+    s[i] = load_be32(in + 4*i);
+  for (i = 7; i >= 0; i--)
+    inv_quintuple_round(s, roundkeys->rk + 10*i, rconst + 5*i);
+  for (i = 0; i < 4; i++)
+    store_be32(out + 4*i, s[i]);
+}
+
+void giftb128_enc_blocks(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys)
+{
+  for (size_t i = 0; i < nblocks; i++)
+    giftb128_enc(out + i*BLOCKBYTES, in + i*BLOCKBYTES, roundkeys);
+}
+
+void giftb128_dec_blocks(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys)
+{
+  for (size_t i = 0; i < nblocks; i++)
+    giftb128_dec(out + i*BLOCKBYTES, in + i*BLOCKBYTES, roundkeys);
+}
@@ -0,0 +1,314 @@
+#include <immintrin.h>
+#include <string.h>
+#include "block_cipher.h"
+
+/**
+ * AVX2 kernels, compiled for their own target (see manx-cpu.h).
+ *
+ * 8 independent blocks are processed in lockstep, v[i] holding the i-th
+ * big-endian 32-bit word of each block (block j in lane j), i.e. the i-th
+ * slice of the fixsliced state of gift128.c, whose rounds are made of bitwise
+ * operations, shifts and masks that map directly to 32-bit lane operations.
+ * The 8-bit multiple rotations are byte shuffles.
+ */
+#define AVX2 __attribute__((target("avx2")))
+
+#define AND(x, y)  _mm256_and_si256(x, y)
+#define OR(x, y)   _mm256_or_si256(x, y)
+#define XOR(x, y)  _mm256_xor_si256(x, y)
+#define NOT(x)     _mm256_xor_si256(x, _mm256_set1_epi32(-1))
+#define C(m)       _mm256_set1_epi32((int)(m))
+
+/**
+ * Rotation of each sub-word of a 32-bit lane by n bits to the right, m1
+ * masking the bits shifted to the right and m2 those shifted by l to the left.
+ */
+#define SUBROT(x, n, m1, l, m2)                                               \
+  OR(AND(_mm256_srli_epi32(x, n), C(m1)), _mm256_slli_epi32(AND(x, C(m2)), l))
+
+#define NIBBLE_ROR_1(x) SUBROT(x,  1, 0x77777777,  3, 0x11111111)
+#define NIBBLE_ROR_2(x) SUBROT(x,  2, 0x33333333,  2, 0x33333333)
+#define NIBBLE_ROR_3(x) SUBROT(x,  3, 0x11111111,  1, 0x77777777)
+#define HALF_ROR_4(x)   SUBROT(x,  4, 0x0fff0fff, 12, 0x000f000f)
+#define HALF_ROR_8(x)   SUBROT(x,  8, 0x00ff00ff,  8, 0x00ff00ff)
+#define HALF_ROR_12(x)  SUBROT(x, 12, 0x000f000f,  4, 0x0fff0fff)
+#define BYTE_ROR_2(x)   SUBROT(x,  2, 0x3f3f3f3f,  6, 0x03030303)
+#define BYTE_ROR_4(x)   SUBROT(x,  4, 0x0f0f0f0f,  4, 0x0f0f0f0f)
+#define BYTE_ROR_6(x)   SUBROT(x,  6, 0x03030303,  2, 0x3f3f3f3f)
+
+#define ROR8(x)  _mm256_shuffle_epi8(x, ror8)
+#define ROR16(x) _mm256_shuffle_epi8(x, ror16)
+#define ROR24(x) _mm256_shuffle_epi8(x, ror24)
+
+#define SWAPMOVE(x, mask, n)                                                  \
+  do {                                                                        \
+    __m256i t = AND(XOR(x, _mm256_srli_epi32(x, n)), C(mask));                \
+    x = XOR(x, XOR(t, _mm256_slli_epi32(t, n)));                              \
+  } while (0)
+
+/**
+ * Byte shuffles rotating each 32-bit lane by 8, 16 and 24 bits to the right,
+ * and reversing the byte order of each lane (the blocks being loaded as
+ * big-endian words).
+ */
+#define SHUFFLE_MASKS                                                         \
+  const __m256i ror8  = _mm256_setr_epi8(                                     \
+    1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12,                     \
+    1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);                    \
+  const __m256i ror16 = _mm256_setr_epi8(                                     \
+    2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,                     \
+    2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);                    \
+  const __m256i ror24 = _mm256_setr_epi8(                                     \
+    3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,                     \
+    3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);                    \
+  const __m256i bswap = _mm256_setr_epi8(                                     \
+    3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,                     \
+    3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+
+/**
+ * Transpose the 4x4 matrices of 32-bit words held in each 128-bit half of
+ * x0..x3. It turns the blocks j and j+4 held in x_j into the words v0..v3 of
+ * the 8 blocks, and conversely.
+ */
+#define TRANSPOSE(x0, x1, x2, x3)                                             \
+  do {                                                                        \
+    __m256i t0 = _mm256_unpacklo_epi32(x0, x1);                               \
+    __m256i t1 = _mm256_unpackhi_epi32(x0, x1);                               \
+    __m256i t2 = _mm256_unpacklo_epi32(x2, x3);                               \
+    __m256i t3 = _mm256_unpackhi_epi32(x2, x3);                               \
+    x0 = _mm256_unpacklo_epi64(t0, t2);                                       \
+    x1 = _mm256_unpackhi_epi64(t0, t2);                                       \
+    x2 = _mm256_unpacklo_epi64(t1, t3);                                       \
+    x3 = _mm256_unpackhi_epi64(t1, t3);                                       \
+  } while (0)
+
+AVX2 static inline __m256i load2(const unsigned char* in, size_t j)
+{
+  __m128i lo = _mm_loadu_si128((const __m128i*)(in + j*BLOCKBYTES));
+  __m128i hi = _mm_loadu_si128((const __m128i*)(in + (j+4)*BLOCKBYTES));
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+AVX2 static inline void store2(unsigned char* out, size_t j, __m256i x)
+{
+  _mm_storeu_si128((__m128i*)(out + j*BLOCKBYTES), _mm256_castsi256_si128(x));
+  _mm_storeu_si128((__m128i*)(out + (j+4)*BLOCKBYTES), _mm256_extracti128_si256(x, 1));
+}
+
+#define SBOX(s0, s1, s2, s3)                                                  \
+  do {                                                                        \
+    s1 = XOR(s1, AND(s0, s2));                                                \
+    s0 = XOR(s0, AND(s1, s3));                                                \
+    s2 = XOR(s2, OR(s0, s1));                                                 \
+    s3 = XOR(s3, s2);                                                         \
+    s1 = XOR(s1, s3);                                                         \
+    s3 = NOT(s3);                                                             \
+    s2 = XOR(s2, AND(s0, s1));                                                \
+  } while (0)
+
+#define INV_SBOX(s0, s1, s2, s3)                                              \
+  do {                                                                        \
+    s2 = XOR(s2, AND(s0, s1));                                                \
+    s3 = NOT(s3);                                                             \
+    s1 = XOR(s1, s3);                                                         \
+    s3 = XOR(s3, s2);                                                         \
+    s2 = XOR(s2, OR(s0, s1));                                                 \
+    s0 = XOR(s0, AND(s1, s3));                                                \
+    s1 = XOR(s1, AND(s0, s2));                                                \
+  } while (0)
+
+/**
+ * Quintuple round of gift128.c on 8 blocks (rk and rc pointing to its 10
+ * round key words and 5 round constants, broadcast to all lanes), and its
+ * inverse. The final swap of s0 and s3 is left to the caller, as a mere
+ * renaming of the registers.
+ */
+#define QUINTUPLE_ROUND(s0, s1, s2, s3, rk, rc)                               \
+  do {                                                                        \
+    SBOX(s0, s1, s2, s3);                                                     \
+    s3 = NIBBLE_ROR_1(s3);                                                    \
+    s1 = XOR(NIBBLE_ROR_2(s1), C(rk[0]));                                     \
+    s2 = XOR(NIBBLE_ROR_3(s2), C(rk[1]));                                     \
+    s0 = XOR(s0, C(rc[0]));                                                   \
+    SBOX(s3, s1, s2, s0);                                                     \
+    s0 = HALF_ROR_4(s0);                                                      \
+    s1 = XOR(HALF_ROR_8(s1), C(rk[2]));                                       \
+    s2 = XOR(HALF_ROR_12(s2), C(rk[3]));                                      \
+    s3 = XOR(s3, C(rc[1]));                                                   \
+    SBOX(s0, s1, s2, s3);                                                     \
+    s3 = ROR16(s3);                                                           \
+    s2 = ROR16(s2);                                                           \
+    SWAPMOVE(s1, 0x55555555, 1);                                              \
+    SWAPMOVE(s2, 0x00005555, 1);                                              \
+    SWAPMOVE(s3, 0x55550000, 1);                                              \
+    s1 = XOR(s1, C(rk[4]));                                                   \
+    s2 = XOR(s2, C(rk[5]));                                                   \
+    s0 = XOR(s0, C(rc[2]));                                                   \
+    SBOX(s3, s1, s2, s0);                                                     \
+    s0 = BYTE_ROR_6(s0);                                                      \
+    s1 = XOR(BYTE_ROR_4(s1), C(rk[6]));                                       \
+    s2 = XOR(BYTE_ROR_2(s2), C(rk[7]));                                       \
+    s3 = XOR(s3, C(rc[3]));                                                   \
+    SBOX(s0, s1, s2, s3);                                                     \
+    s3 = ROR24(s3);                                                           \
+    s1 = XOR(ROR16(s1), C(rk[8]));                                            \
+    s2 = XOR(ROR8(s2), C(rk[9]));                                             \
+    s0 = XOR(s0, C(rc[4]));                                                   \
+  } while (0)
+
+#define INV_QUINTUPLE_ROUND(s0, s1, s2, s3, rk, rc)                           \
+  do {                                                                        \
+    s0 = XOR(s0, C(rc[4]));                                                   \
+    s1 = ROR16(XOR(s1, C(rk[8])));                                            \
+    s2 = ROR24(XOR(s2, C(rk[9])));                                            \
+    s3 = ROR8(s3);                                                            \
+    INV_SBOX(s0, s1, s2, s3);                                                 \
+    s3 = XOR(s3, C(rc[3]));                                                   \
+    s1 = BYTE_ROR_4(XOR(s1, C(rk[6])));                                       \
+    s2 = BYTE_ROR_6(XOR(s2, C(rk[7])));                                       \
+    s0 = BYTE_ROR_2(s0);                                                      \
+    INV_SBOX(s3, s1, s2, s0);                                                 \
+    s0 = XOR(s0, C(rc[2]));                                                   \
+    s1 = XOR(s1, C(rk[4]));                                                   \
+    s2 = XOR(s2, C(rk[5]));                                                   \
+    SWAPMOVE(s1, 0x55555555, 1);                                              \
+    SWAPMOVE(s2, 0x00005555, 1);                                              \
+    SWAPMOVE(s3, 0x55550000, 1);                                              \
+    s3 = ROR16(s3);                                                           \
+    s2 = ROR16(s2);                                                           \
+    INV_SBOX(s0, s1, s2, s3);                                                 \
+    s3 = XOR(s3, C(rc[1]));                                                   \
+    s1 = HALF_ROR_8(XOR(s1, C(rk[2])));                                       \
+    s2 = HALF_ROR_4(XOR(s2, C(rk[3])));                                       \
+    s0 = HALF_ROR_12(s0);                                                     \
+    INV_SBOX(s3, s1, s2, s0);                                                 \
+    s0 = XOR(s0, C(rc[0]));                                                   \
+    s1 = NIBBLE_ROR_2(XOR(s1, C(rk[0])));                                     \
+    s2 = NIBBLE_ROR_1(XOR(s2, C(rk[1])));                                     \
+    s3 = NIBBLE_ROR_3(s3);                                                    \
+    INV_SBOX(s0, s1, s2, s3);                                                 \
+  } while (0)
+
+/**
+ * Round constants in fixsliced representation (see gift128.c).
+ */
+static const uint32_t rconst[40] = {
+  0x10000008, 0x80018000, 0x54000002, 0x01010181,
+  0x8000001f, 0x10888880, 0x6001e000, 0x51500002,
+  0x03030180, 0x8000002f, 0x10088880, 0x60016000,
+  0x41500002, 0x03030080, 0x80000027, 0x10008880,
+  0x4001e000, 0x11500002, 0x03020180, 0x8000002b,
+  0x10080880, 0x60014000, 0x01400002, 0x02020080,
+  0x80000021, 0x10000080, 0x0001c000, 0x51000002,
+  0x03010180, 0x8000002e, 0x10088800, 0x60012000,
+  0x40500002, 0x01030080, 0x80000006, 0x10008808,
+  0xc001a000, 0x14500002, 0x01020181, 0x8000001a
+};
+
+/**
+ * The 8 quintuple rounds on the slices of NV groups of 8 blocks, the swap of
+ * s0 and s3 ending each quintuple round being undone by unrolling them by 2.
+ */
+#define ENC_ROUNDS(v, NV)                                                     \
+  do {                                                                        \
+    const uint32_t* rk = roundkeys->rk;                                       \
+    for (q = 0; q < 8; q += 2) {                                              \
+      for (j = 0; j < NV; j++)                                                \
+        QUINTUPLE_ROUND(v[j][0], v[j][1], v[j][2], v[j][3],                   \
+                        (rk + 10*q), (rconst + 5*q));                         \
+      for (j = 0; j < NV; j++)                                                \
+        QUINTUPLE_ROUND(v[j][3], v[j][1], v[j][2], v[j][0],                   \
+                        (rk + 10*q + 10), (rconst + 5*q + 5));                \
+    }                                                                         \
+  } while (0)
+
+#define DEC_ROUNDS(v, NV)                                                     \
+  do {                                                                        \
+    const uint32_t* rk = roundkeys->rk;                                       \
+    for (q = 8; q > 0; q -= 2) {                                              \
+      for (j = 0; j < NV; j++)                                                \
+        INV_QUINTUPLE_ROUND(v[j][3], v[j][1], v[j][2], v[j][0],               \
+                            (rk + 10*q - 10), (rconst + 5*q - 5));            \
+      for (j = 0; j < NV; j++)                                                \
+        INV_QUINTUPLE_ROUND(v[j][0], v[j][1], v[j][2], v[j][3],               \
+                            (rk + 10*q - 20), (rconst + 5*q - 10));           \
+    }                                                                         \
+  } while (0)
+
+/**
+ * Process NV groups of 8 blocks in lockstep (OP is either ENC or DEC).
+ */
+#define GIFTB128_AVX2(OP, NV)                                                 \
+  do {                                                                        \
+    __m256i v[NV][4];                                                         \
+    for (j = 0; j < NV; j++) {                                                \
+      for (i = 0; i < 4; i++)                                                 \
+        v[j][i] = _mm256_shuffle_epi8(load2(in + 8*j*BLOCKBYTES, i), bswap);  \
+      TRANSPOSE(v[j][0], v[j][1], v[j][2], v[j][3]);                          \
+    }                                                                         \
+    OP##_ROUNDS(v, NV);                                                       \
+    for (j = 0; j < NV; j++) {                                                \
+      TRANSPOSE(v[j][0], v[j][1], v[j][2], v[j][3]);                          \
+      for (i = 0; i < 4; i++)                                                 \
+        store2(out + 8*j*BLOCKBYTES, i, _mm256_shuffle_epi8(v[j][i], bswap)); \
+    }                                                                         \
+    in += 8*NV*BLOCKBYTES, out += 8*NV*BLOCKBYTES, nblocks -= 8*NV;           \
+  } while (0)
+
+AVX2 void giftb128_enc_x8_avx2(unsigned char out[8*BLOCKBYTES], const unsigned char in[8*BLOCKBYTES], const roundkeys_t* roundkeys)
+{
+  unsigned int i, j, q;
+  size_t nblocks = 8;
+  SHUFFLE_MASKS;
+
+  GIFTB128_AVX2(ENC, 1);
+}
+
+AVX2 void giftb128_dec_x8_avx2(unsigned char out[8*BLOCKBYTES], const unsigned char in[8*BLOCKBYTES], const roundkeys_t* roundkeys)
+{
+  unsigned int i, j, q;
+  size_t nblocks = 8;
+  SHUFFLE_MASKS;
+
+  GIFTB128_AVX2(DEC, 1);
+}
+
+/**
+ * Process groups of 32 blocks, then 16 and 8 blocks, several independent
+ * groups hiding the latency of the S-box dependency chain. The last
+ * nblocks % 8 blocks are processed by a padded 8-block kernel if they are
+ * numerous enough to amortize it, and by the portable functions otherwise.
+ */
+#define GIFTB128_AVX2_TAIL 2
+
+#define GIFTB128_AVX2_BLOCKS(OP, op)                                          \
+  do {                                                                        \
+    unsigned int i, j, q;                                                     \
+    SHUFFLE_MASKS;                                                            \
+    while (nblocks >= 32)                                                     \
+      GIFTB128_AVX2(OP, 4);                                                   \
+    if (nblocks >= 16)                                                        \
+      GIFTB128_AVX2(OP, 2);                                                   \
+    if (nblocks >= 8)                                                         \
+      GIFTB128_AVX2(OP, 1);                                                   \
+    if (nblocks >= GIFTB128_AVX2_TAIL) {                                      \
+      unsigned char buf[8*BLOCKBYTES] = {0};                                  \
+      size_t n = nblocks;                                                     \
+      unsigned char* dst = out;                                               \
+      memcpy(buf, in, n*BLOCKBYTES);                                          \
+      in = buf, out = buf;                                                    \
+      GIFTB128_AVX2(OP, 1);                                                   \
+      memcpy(dst, buf, n*BLOCKBYTES);                                         \
+    } else                                                                    \
+      giftb128_##op##_blocks(out, in, nblocks, roundkeys);                    \
+  } while (0)
+
+AVX2 void giftb128_enc_blocks_avx2(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys)
+{
+  GIFTB128_AVX2_BLOCKS(ENC, enc);
+}
+
+AVX2 void giftb128_dec_blocks_avx2(unsigned char* out, const unsigned char* in, size_t nblocks, const roundkeys_t* roundkeys)
+{
+  GIFTB128_AVX2_BLOCKS(DEC, dec);
+}
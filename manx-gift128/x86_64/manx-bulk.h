@@ -0,0 +1 @@
+../../manx/manx-bulk.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../manx/manx-config.h
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include "../dispatch.h"
+#include "manx-check.h"
+
+/**
+ * Bit-oriented GIFT-128 following its specification, as a reference for the
+ * fixsliced implementations (bit i of the state being bit i%8 of byte 15-i/8).
+ */
+static const uint8_t gift_sbox[16] = {
+    0x1, 0xa, 0x4, 0xc, 0x6, 0xf, 0x3, 0x9, 0x2, 0xd, 0xb, 0x7, 0x5, 0x0, 0x8, 0xe
+};
+
+static int get_bit(const uint8_t s[16], int i)
+{
+    return (s[15 - i/8] >> (i%8)) & 1;
+}
+
+static void flip_bit(uint8_t s[16], int i, int b)
+{
+    s[15 - i/8] ^= b << (i%8);
+}
+
+static void gift128_ref(uint8_t ctext[16], const uint8_t ptext[16], const uint8_t key[16])
+{
+    uint8_t  s[16], t[16], rc = 0;
+    uint16_t k[8];
+
+    memcpy(s, ptext, 16);
+    for (int i = 0; i < 8; i++)
+        k[i] = (key[14 - 2*i] << 8) | key[15 - 2*i];
+    for (int r = 0; r < 40; r++) {
+        for (int i = 0; i < 16; i++)
+            s[i] = (gift_sbox[s[i] >> 4] << 4) | gift_sbox[s[i] & 0xf];
+        memset(t, 0, sizeof(t));
+        for (int i = 0; i < 128; i++)
+            flip_bit(t, 4*(i/16) + 32*((3*((i%16)/4) + (i%4)) % 4) + (i%4), get_bit(s, i));
+        memcpy(s, t, sizeof(s));
+        uint32_t u = ((uint32_t)k[5] << 16) | k[4], v = ((uint32_t)k[1] << 16) | k[0];
+        for (int i = 0; i < 32; i++) {
+            flip_bit(s, 4*i + 2, (u >> i) & 1);
+            flip_bit(s, 4*i + 1, (v >> i) & 1);
+        }
+        rc = ((rc << 1) & 0x3f) | (((rc >> 5) ^ (rc >> 4) ^ 1) & 1);
+        flip_bit(s, 127, 1);
+        for (int j = 0; j < 6; j++)
+            flip_bit(s, 4*j + 3, (rc >> j) & 1);
+        uint16_t k0 = k[0], k1 = k[1];
+        memmove(k, k + 2, 6*sizeof(k[0]));
+        k[6] = (k0 >> 12) | (k0 << 4);
+        k[7] = (k1 >> 2) | (k1 << 14);
+    }
+    memcpy(ctext, s, 16);
+}
+
+/**
+ * Conversion of a GIFT-128 block to the bitsliced representation processed by
+ * GIFTb-128 (see gift128_encrypt_block in ../../armv7m/gift128.S), and back.
+ */
+static uint32_t load_be32(const uint8_t *a)
+{
+    return ((uint32_t)a[0] << 24) | ((uint32_t)a[1] << 16) | ((uint32_t)a[2] << 8) | a[3];
+}
+
+static void store_be32(uint8_t *a, uint32_t x)
+{
+    a[0] = x >> 24, a[1] = x >> 16, a[2] = x >> 8, a[3] = x;
+}
+
+#define SWAPMOVE(a, b, mask, n) do {            \
+        uint32_t t = ((b) ^ ((a) >> (n))) & (mask); \
+        (b) ^= t;                               \
+        (a) ^= t << (n);                        \
+    } while (0)
+
+static void gift128_pack(uint8_t out[16], const uint8_t in[16])
+{
+    uint32_t w[4], s[4];
+
+    for (int i = 0; i < 4; i++)
+        w[i] = load_be32(in + 4*i);
+    s[0] = (w[1] << 16) | (w[3] & 0xffff);
+    s[1] = (w[1] & 0xffff0000) | (w[3] >> 16);
+    s[2] = (w[0] << 16) | (w[2] & 0xffff);
+    s[3] = (w[0] & 0xffff0000) | (w[2] >> 16);
+    for (int i = 0; i < 4; i++) {
+        SWAPMOVE(s[i], s[i], 0x0a0a0a0a, 3);
+        SWAPMOVE(s[i], s[i], 0x00cc00cc, 6);
+    }
+    SWAPMOVE(s[0], s[1], 0x000f000f, 4);
+    SWAPMOVE(s[0], s[2], 0x000f000f, 8);
+    SWAPMOVE(s[0], s[3], 0x000f000f, 12);
+    SWAPMOVE(s[1], s[2], 0x00f000f0, 4);
+    SWAPMOVE(s[1], s[3], 0x00f000f0, 8);
+    SWAPMOVE(s[2], s[3], 0x0f000f00, 4);
+    for (int i = 0; i < 4; i++)
+        store_be32(out + 4*i, s[i]);
+}
+
+static void gift128_unpack(uint8_t out[16], const uint8_t in[16])
+{
+    uint32_t s[4];
+
+    for (int i = 0; i < 4; i++)
+        s[i] = load_be32(in + 4*i);
+    SWAPMOVE(s[2], s[3], 0x0f000f00, 4);
+    SWAPMOVE(s[1], s[3], 0x00f000f0, 8);
+    SWAPMOVE(s[1], s[2], 0x00f000f0, 4);
+    SWAPMOVE(s[0], s[3], 0x000f000f, 12);
+    SWAPMOVE(s[0], s[2], 0x000f000f, 8);
+    SWAPMOVE(s[0], s[1], 0x000f000f, 4);
+    for (int i = 0; i < 4; i++) {
+        SWAPMOVE(s[i], s[i], 0x00cc00cc, 6);
+        SWAPMOVE(s[i], s[i], 0x0a0a0a0a, 3);
+    }
+    store_be32(out,      (s[3] & 0xffff0000) | (s[2] >> 16));
+    store_be32(out + 4,  (s[1] & 0xffff0000) | (s[0] >> 16));
+    store_be32(out + 8,  (s[3] << 16) | (s[2] & 0xffff));
+    store_be32(out + 12, (s[1] << 16) | (s[0] & 0xffff));
+}
+
+/**
+ * Test vectors of the GIFT-128 specification (key, plaintext, ciphertext).
+ */
+static const char *gift128_tv[][3] = {
+    { "00000000000000000000000000000000", "00000000000000000000000000000000",
+      "cd0bd738388ad3f668b15a36ceb6ff92" },
+    { "fedcba9876543210fedcba9876543210", "fedcba9876543210fedcba9876543210",
+      "8422241a6dbf5a9346af468409ee0152" },
+    { "d0f5c59a7700d3e799028fa9f90ad837", "e39c141fa57dba43f08a85b6a91f86c1",
+      "13ede67cbdcc3dbf400a62d6977265ea" },
+};
+
+static void unhex(uint8_t *buf, size_t len, const char *hex)
+{
+    for (size_t i = 0; i < len; i++)
+        sscanf(hex + 2*i, "%2hhx", &buf[i]);
+}
+
+/**
+ * Reference against the test vectors, portable block cipher against the
+ * reference one (through the packing), decryption round trips and the
+ * functions bound at compile time.
+ */
+static void check_cipher(const uint8_t key[16])
+{
+    uint8_t     in[BLOCKBYTES], ref[BLOCKBYTES], out[BLOCKBYTES], inv[BLOCKBYTES];
+    uint8_t     k[16], b[BLOCKBYTES];
+    roundkeys_t rkeys;
+    int         ok_tv = 1, ok_enc = 1, ok_dec = 1, ok_static = 1;
+
+    for (size_t i = 0; i < sizeof(gift128_tv)/sizeof(gift128_tv[0]); i++) {
+        unhex(k, sizeof(k), gift128_tv[i][0]);
+        unhex(in, sizeof(in), gift128_tv[i][1]);
+        gift128_ref(ref, in, k);
+        ok_tv &= hexeq(ref, sizeof(ref), gift128_tv[i][2]);
+        giftb128_kexp(&rkeys, k);
+        gift128_pack(b, in);
+        giftb128_enc(out, b, &rkeys);
+        gift128_unpack(b, out);
+        ok_enc &= hexeq(b, sizeof(b), gift128_tv[i][2]);
+    }
+    check(ok_tv, "GIFT-128 reference matches the test vectors");
+
+    giftb128_kexp(&rkeys, key);
+    for (size_t i = 0; i < 1000; i++) {
+        fill(in, sizeof(in), i);
+        in[i % BLOCKBYTES] ^= i >> 4;
+        gift128_pack(b, in);
+        gift128_ref(ref, in, key);
+        giftb128_enc(out, b, &rkeys);
+        gift128_unpack(in, out);
+        ok_enc &= memcmp(ref, in, sizeof(in)) == 0;
+        giftb128_dec(inv, out, &rkeys);
+        ok_dec &= memcmp(b, inv, sizeof(b)) == 0;
+#if MANX_STATIC_BOUND
+        MANX_STATIC_ENCRYPT(inv, b, &rkeys);
+        ok_static &= memcmp(out, inv, sizeof(out)) == 0;
+        MANX_STATIC_DECRYPT(inv, out, &rkeys);
+        ok_static &= memcmp(b, inv, sizeof(b)) == 0;
+#endif
+    }
+    check(ok_enc, "giftb128_enc matches GIFT-128 through the packing");
+    check(ok_dec, "giftb128_dec inverts giftb128_enc");
+    check(ok_static, "statically bound functions match giftb128_enc and giftb128_dec");
+}
+
+static void check_x8(const uint8_t key[16])
+{
+    uint8_t     in[8*BLOCKBYTES], ref[8*BLOCKBYTES], out[8*BLOCKBYTES];
+    roundkeys_t rkeys;
+
+    if (!giftb128_impl_supported(GIFTB128_IMPL_AVX2))
+        return;
+    giftb128_kexp(&rkeys, key);
+    fill(in, sizeof(in), 0x42);
+    giftb128_enc_blocks(ref, in, 8, &rkeys);
+    giftb128_enc_x8_avx2(out, in, &rkeys);
+    check(memcmp(ref, out, sizeof(out)) == 0, "giftb128_enc_x8_avx2 matches giftb128_enc");
+    giftb128_dec_blocks(ref, in, 8, &rkeys);
+    giftb128_dec_x8_avx2(out, in, &rkeys);
+    check(memcmp(ref, out, sizeof(out)) == 0, "giftb128_dec_x8_avx2 matches giftb128_dec");
+}
+
+/**
+ * Known-answer ciphertexts for the same inputs as the AES-128 ones in
+ * ../../../manx-aes128/x86_64/test/check.c (the block cipher itself being
+ * checked against a bit-oriented GIFT-128, see gift128_ref).
+ */
+static const check_suite suite = {
+    .kexpand            = giftb128_kexp,
+    .encrypt            = giftb128_enc,
+    .decrypt            = giftb128_dec,
+    .kat_manx1_96_30_64 = "3e4269d0510f5d60c5d212fecf2036f0",
+    .kat_manx1_128_63_0 = "a72db8ce7ef7143f011b213e6d7b64fb",
+    .kat_manx2_64_96_0  = "3c5779defa235af4e2c852ae6841c613d2e3486b21b438a34a0948c18398fab7",
+    .sweep_manx1        = 0x862decbc293ad383ULL,
+    .sweep_manx2        = 0x03ababd535a6efc1ULL,
+    .check_impl         = check_kat,
+};
+
+int main(void) {
+    uint8_t            key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    const manx_cipher *ciphers[GIFTB128_IMPL_COUNT];
+
+    printf("GIFTb-128 implementation selected: %s\n", giftb128_cipher_best()->name);
+    check_cipher(key);
+    check_x8(key);
+
+    for (int i = 0; i < GIFTB128_IMPL_COUNT; i++)
+        ciphers[i] = giftb128_cipher(i);
+    check_ciphers(&suite, ciphers, GIFTB128_IMPL_COUNT, key);
+
+    printf("%s\n", failures ? "checks FAILED" : "all checks passed");
+    return failures != 0;
+}
@@ -0,0 +1 @@
+../../../manx/test/manx-bench-aesni.h
\ No newline at end of file
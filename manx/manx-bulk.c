@@ -0,0 +1,254 @@
+/**
+ * @file manx-bulk.c
+ *
+ * @brief Bulk encryption/decryption of large arrays of Manx1/Manx2 messages
+ * across a pool of threads, with work stealing between them.
+ *
+ * @author Alexandre Adomnicai <alexandre@adomnicai.me>
+ *
+ * @date October 2026
+ */
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "manx-bulk.h"
+
+typedef size_t (*batch_func)(const manx_ctx *, manx_msg *, size_t);
+
+/**
+ * Messages [lo, hi) left to a thread: the owner takes chunks from the front,
+ * the other threads steal from the back. Aligned on a cache line so that the
+ * ranges of the different threads do not share one.
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    size_t          lo, hi;
+    size_t          failed;  // failures counted by the owner
+} __attribute__((aligned(64))) bulk_range;
+
+struct manx_pool {
+    size_t           nthreads;   // including the calling thread
+    pthread_t       *threads;    // nthreads - 1 workers
+    bulk_range      *ranges;     // one per thread, the calling one being 0
+    pthread_mutex_t  run;        // held for the whole bulk operation
+    pthread_mutex_t  lock;       // protects the fields below
+    pthread_cond_t   start;
+    pthread_cond_t   done;
+    unsigned long    generation; // incremented on every bulk operation
+    size_t           active;     // workers still running the operation
+    int              stop;
+    // current bulk operation
+    const manx_ctx  *ctx;
+    manx_msg        *msgs;
+    batch_func       batch;
+};
+
+typedef struct {
+    manx_pool *pool;
+    size_t     id;
+} bulk_worker;
+
+/**
+ * Take the next chunk of messages of a thread, stealing half of the messages
+ * left to another one if its range is empty. A single lock is held at a time.
+ *
+ * @return 1 if a chunk was taken, 0 if no message is left
+ */
+static int bulk_next(manx_pool *pool, size_t id, size_t *lo, size_t *hi)
+{
+    bulk_range *own = &pool->ranges[id];
+
+    for (;;) {
+        pthread_mutex_lock(&own->lock);
+        if (own->lo < own->hi) {
+            *lo      = own->lo;
+            *hi      = (own->hi - own->lo > MANX_BULK_CHUNK) ? own->lo + MANX_BULK_CHUNK : own->hi;
+            own->lo  = *hi;
+            pthread_mutex_unlock(&own->lock);
+            return 1;
+        }
+        pthread_mutex_unlock(&own->lock);
+
+        size_t slo = 0, shi = 0;
+        for (size_t i = 1; i < pool->nthreads && slo == shi; i++) {
+            bulk_range *victim = &pool->ranges[(id + i) % pool->nthreads];
+            pthread_mutex_lock(&victim->lock);
+            size_t left = victim->hi - victim->lo;
+            if (left > 0) {
+                size_t n = (left > MANX_BULK_CHUNK) ? left / 2 : left;
+                shi = victim->hi;
+                slo = victim->hi = victim->hi - n;
+            }
+            pthread_mutex_unlock(&victim->lock);
+        }
+        if (slo == shi)
+            return 0;
+        pthread_mutex_lock(&own->lock);
+        own->lo = slo;
+        own->hi = shi;
+        pthread_mutex_unlock(&own->lock);
+    }
+}
+
+static void bulk_work(manx_pool *pool, size_t id)
+{
+    size_t lo, hi, failed = 0;
+
+    while (bulk_next(pool, id, &lo, &hi))
+        failed += pool->batch(pool->ctx, pool->msgs + lo, hi - lo);
+    pool->ranges[id].failed = failed;
+}
+
+static void *bulk_thread(void *arg)
+{
+    bulk_worker   *w    = arg;
+    manx_pool     *pool = w->pool;
+    unsigned long  seen = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->stop && pool->generation == seen)
+            pthread_cond_wait(&pool->start, &pool->lock);
+        if (pool->stop) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        bulk_work(pool, w->id);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->active == 0)
+            pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    free(w);
+    return NULL;
+}
+
+manx_pool *manx_pool_create(size_t nthreads)
+{
+    manx_pool *pool;
+
+    if (nthreads == 0) {
+        long n   = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = (n > 0) ? (size_t)n : 1;
+    }
+    if ((pool = calloc(1, sizeof(*pool))) == NULL)
+        return NULL;
+    pool->ranges  = aligned_alloc(64, nthreads*sizeof(bulk_range));
+    pool->threads = calloc(nthreads, sizeof(pthread_t));
+    if (pool->ranges == NULL || pool->threads == NULL) {
+        free(pool->ranges);
+        free(pool->threads);
+        free(pool);
+        return NULL;
+    }
+    for (size_t i = 0; i < nthreads; i++)
+        pthread_mutex_init(&pool->ranges[i].lock, NULL);
+    pthread_mutex_init(&pool->run, NULL);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    // the calling thread being worker 0, only nthreads - 1 are started
+    pool->nthreads = 1;
+    for (size_t i = 1; i < nthreads; i++) {
+        bulk_worker *w = malloc(sizeof(*w));
+        if (w == NULL)
+            break;
+        *w = (bulk_worker){ .pool = pool, .id = i };
+        if (pthread_create(&pool->threads[i-1], NULL, bulk_thread, w)) {
+            free(w);
+            break;
+        }
+        pool->nthreads++;
+    }
+    if (pool->nthreads < nthreads) {
+        manx_pool_destroy(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+size_t manx_pool_size(const manx_pool *pool)
+{
+    return pool ? pool->nthreads : 1;
+}
+
+void manx_pool_destroy(manx_pool *pool)
+{
+    if (pool == NULL)
+        return;
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (size_t i = 1; i < pool->nthreads; i++)
+        pthread_join(pool->threads[i-1], NULL);
+
+    for (size_t i = 0; i < pool->nthreads; i++)
+        pthread_mutex_destroy(&pool->ranges[i].lock);
+    pthread_mutex_destroy(&pool->run);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+    free(pool->ranges);
+    free(pool->threads);
+    free(pool);
+}
+
+static size_t bulk_run(manx_pool *pool, const manx_ctx *ctx, batch_func batch,
+            manx_msg msgs[], size_t count)
+{
+    size_t failed = 0;
+
+    // a single chunk is not worth waking the workers up
+    if (pool == NULL || pool->nthreads == 1 || count <= MANX_BULK_CHUNK)
+        return batch(ctx, msgs, count);
+
+    pthread_mutex_lock(&pool->run);
+    for (size_t i = 0; i < pool->nthreads; i++) {
+        pool->ranges[i].lo     = count * i / pool->nthreads;
+        pool->ranges[i].hi     = count * (i + 1) / pool->nthreads;
+        pool->ranges[i].failed = 0;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->ctx    = ctx;
+    pool->msgs   = msgs;
+    pool->batch  = batch;
+    pool->active = pool->nthreads - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    bulk_work(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->active)
+        pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < pool->nthreads; i++)
+        failed += pool->ranges[i].failed;
+    pthread_mutex_unlock(&pool->run);
+    return failed;
+}
+
+size_t manx_bulk_enc(manx_pool *pool, const manx_ctx *ctx, manx_bulk_mode mode,
+        manx_msg msgs[], size_t count)
+{
+    return bulk_run(pool, ctx, (mode == MANX_BULK_MANX1) ? manx1_enc_batch : manx2_enc_batch,
+                    msgs, count);
+}
+
+size_t manx_bulk_dec(manx_pool *pool, const manx_ctx *ctx, manx_bulk_mode mode,
+        manx_msg msgs[], size_t count)
+{
+    // derive the decryption round keys before the workers share the context
+    if (ctx->cipher->decrypt != NULL)
+        manx_ctx_rkeys_inv(ctx);
+    return bulk_run(pool, ctx, (mode == MANX_BULK_MANX1) ? manx1_dec_batch : manx2_dec_batch,
+                    msgs, count);
+}
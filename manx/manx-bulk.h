@@ -0,0 +1,89 @@
+/**
+ * @file manx-bulk.h
+ *
+ * @brief Bulk encryption/decryption of large arrays of Manx1/Manx2 messages
+ * across a pool of threads (POSIX threads, for hosts only).
+ *
+ * @author Alexandre Adomnicai <alexandre@adomnicai.me>
+ *
+ * @date October 2026
+ */
+#ifndef MANX_BULK_H
+#define MANX_BULK_H
+
+#include "manx.h"
+
+/**
+ * Number of consecutive messages processed by a worker at once, small enough
+ * for their inputs and outputs to stay in the L1/L2 caches.
+ */
+#ifndef MANX_BULK_CHUNK
+#define MANX_BULK_CHUNK 256
+#endif
+
+/**
+ * Mode used by a bulk operation.
+ */
+typedef enum {
+    MANX_BULK_MANX1,
+    MANX_BULK_MANX2
+} manx_bulk_mode;
+
+/**
+ * Pool of worker threads, the calling thread taking part in every bulk
+ * operation as one of them. A pool runs one bulk operation at a time, the
+ * concurrent calls being serialized.
+ */
+typedef struct manx_pool manx_pool;
+
+/**
+ * @brief Create a pool of threads.
+ *
+ * @param nthreads The number of threads, including the calling one (0 for
+ * the number of online processors)
+ *
+ * @return The pool, NULL if it could not be created
+ */
+manx_pool *manx_pool_create(size_t nthreads);
+
+/**
+ * @brief Number of threads of a pool, including the calling one.
+ */
+size_t manx_pool_size(const manx_pool *pool);
+
+/**
+ * @brief Stop the threads of a pool and release it.
+ */
+void manx_pool_destroy(manx_pool *pool);
+
+/**
+ * @brief Authenticated encryption of an array of independent messages.
+ * The messages are split into chunks of MANX_BULK_CHUNK messages processed by
+ * the batch functions (`manx1_enc_batch`, `manx2_enc_batch`) on the threads of
+ * the pool: each thread starts with an even share of the array, then steals
+ * half of the remaining messages of another thread once its share is done.
+ * Each descriptor gets the outputs of the corresponding single-message
+ * function (`outlen` and `ret`), regardless of the thread processing it.
+ *
+ * @param pool The pool of threads (NULL to only use the calling thread)
+ * @param ctx The Manx context, shared by all the threads
+ * @param mode The mode (Manx1 or Manx2)
+ * @param msgs The message descriptors
+ * @param count The number of messages
+ *
+ * @return The number of messages whose encryption failed (see `ret`)
+ */
+size_t manx_bulk_enc(manx_pool *pool, const manx_ctx *ctx, manx_bulk_mode mode,
+        manx_msg msgs[], size_t count);
+
+/**
+ * @brief Authenticated decryption of an array of independent ciphertexts.
+ * Same as `manx_bulk_enc`, where `in` and `out` refer to the ciphertext and
+ * the plaintext respectively.
+ *
+ * @return The number of messages whose decryption failed (see `ret`)
+ */
+size_t manx_bulk_dec(manx_pool *pool, const manx_ctx *ctx, manx_bulk_mode mode,
+        manx_msg msgs[], size_t count);
+
+#endif
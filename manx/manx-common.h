@@ -21,6 +21,213 @@
  *  Set i-th bit of x to b.
  */
 #define CHGBIT(x, i, b) ((x) = (x) ^ ((-(b) ^ (x)) & (1UL << (i))))
+/**
+ *  Inlining hint for the small helpers whose arguments are meant to be
+ *  propagated at the call site (e.g. to keep a state in registers).
+ */
+#if defined(__GNUC__)
+#define MANX_ALWAYS_INLINE static inline __attribute__((always_inline))
+#else
+#define MANX_ALWAYS_INLINE static inline
+#endif
+
+/**
+ *  Attributes of the functions calling the block cipher bound at compile time.
+ */
+#ifndef MANX_STATIC_ATTR
+#define MANX_STATIC_ATTR
+#endif
+
+/**
+ *  Phase timers (see MANX_PHASE_TIMERS in manx-config.h): MANX_PHASE_BEGIN
+ *  starts timing in the current scope, then MANX_PHASE(p) charges the cycles
+ *  elapsed since the previous mark to the phase p.
+ */
+#if MANX_PHASE_TIMERS
+#ifndef MANX_PHASE_CLOCK
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define MANX_PHASE_CLOCK() __rdtsc()
+#else
+#error "MANX_PHASE_TIMERS requires MANX_PHASE_CLOCK() to be defined"
+#endif
+#endif
+extern _Thread_local manx_phase_stats manx_phase_local;
+#define MANX_PHASE_BEGIN() uint64_t manx_phase_t0 = MANX_PHASE_CLOCK()
+#define MANX_PHASE(p)                                               \
+    do {                                                            \
+        uint64_t manx_phase_t1 = MANX_PHASE_CLOCK();                \
+        manx_phase_local.cycles[p] += manx_phase_t1 - manx_phase_t0; \
+        manx_phase_t0 = manx_phase_t1;                              \
+    } while (0)
+#define MANX_PHASE_CALL() (manx_phase_local.calls++)
+#else
+#define MANX_PHASE_BEGIN() do {} while (0)
+#define MANX_PHASE(p)      do {} while (0)
+#define MANX_PHASE_CALL()  do {} while (0)
+#endif
+
+/**
+ * @brief Translate 4 bytes into a 32-bit word (little-endian encoding).
+ *
+ * @param a The input array
+ * 
+ * @return The corresponding 32-bit word
+ */
+static inline uint32_t GET_LE32(const uint8_t *a)
+{
+    return ((uint32_t)a[3] << 24) | ((uint32_t)a[2] << 16) | ((uint32_t)a[1] << 8) | (uint32_t)a[0];
+}
+
+/**
+ * @brief Translate a 32-bit word into 4 bytes (little-endian encoding).
+ *
+ * @param a The output byte array
+ * @param val The input 32-bit word
+ */
+static inline void PUT_LE32(uint8_t *a, uint32_t val)
+{
+    a[3] = (val >> 24) & 0xff;
+    a[2] = (val >> 16) & 0xff;
+    a[1] = (val >>  8) & 0xff;
+    a[0] = (val >>  0) & 0xff;
+}
+
+/**
+ * @brief Translate 2, 4 or 8 bytes into a 16-, 32- or 64-bit word (big-endian encoding).
+ *
+ * @param a The input array
+ * 
+ * @return The corresponding word
+ */
+static inline uint16_t GET_BE16(const uint8_t *a)
+{
+    return ((uint16_t)a[0] << 8) | (uint16_t)a[1];
+}
+
+static inline uint32_t GET_BE32(const uint8_t *a)
+{
+    return ((uint32_t)a[0] << 24) | ((uint32_t)a[1] << 16) | ((uint32_t)a[2] << 8) | (uint32_t)a[3];
+}
+
+static inline uint64_t GET_BE64(const uint8_t *a)
+{
+    return ((uint64_t)GET_BE32(a) << 32) | (uint64_t)GET_BE32(a + 4);
+}
+
+/**
+ * @brief Translate a 64-bit word into 8 bytes (big-endian encoding).
+ *
+ * @param a The output byte array
+ * @param val The input 64-bit word
+ */
+static inline void PUT_BE64(uint8_t *a, uint64_t val)
+{
+    a[0] = (val >> 56) & 0xff;
+    a[1] = (val >> 48) & 0xff;
+    a[2] = (val >> 40) & 0xff;
+    a[3] = (val >> 32) & 0xff;
+    a[4] = (val >> 24) & 0xff;
+    a[5] = (val >> 16) & 0xff;
+    a[6] = (val >>  8) & 0xff;
+    a[7] = (val >>  0) & 0xff;
+}
+
+/**
+ * @brief Multiplication by x over GF(2^128) (i.e. doubling) using the
+ * irreducible polynomial x^128 + x^7 + x^2 + x + 1.
+ * Shift the 128-bit polynomial by 1 bit to the right, and add
+ * 0...010000111 (= 0x87) if its MSB equals 1.
+ *
+ * @param poly Input/output 128-bit polynomial
+ */
+static inline void doubling(uint8_t *poly)
+{
+    uint32_t val;
+    uint8_t cond = 0x00 - ((poly[15] & 0x80) >> 7);
+    // 1st 32-bit word to shift
+    val = GET_LE32(poly + 12);
+    val <<= 1;
+    val |= (poly[11] & 0x80) >> 7;
+    PUT_LE32(poly + 12, val);
+    // 2nd 32-bit word to shift
+    val = GET_LE32(poly + 8);
+    val <<= 1;
+    val |= (poly[7] & 0x80) >> 7;
+    PUT_LE32(poly + 8, val);
+    // 3rd 32-bit word to shift
+    val = GET_LE32(poly + 4);
+    val <<= 1;
+    val |= (poly[3] & 0x80) >> 7;
+    PUT_LE32(poly + 4, val);
+    // 4th 32-bit word to shift
+    val = GET_LE32(poly);
+    val <<= 1;
+    val |= ((poly[3] & 0x80) >> 7);
+    PUT_LE32(poly, val);
+    // Add 0x87 if and only if MSB is set to 1
+    poly[0] ^= 0x87 & cond;
+}
+
+/**
+ * @brief Exclusive-OR between two 128-bit blocks.
+ *
+ * @param dst First operand and output
+ * @param src Second operand
+ */
+static inline void xor_block(uint8_t *dst, const uint8_t *src1, const uint8_t *src2)
+{
+    uint32_t *d  = (uint32_t *) dst;
+    uint32_t *s1 = (uint32_t *) src1;
+    uint32_t *s2 = (uint32_t *) src2;
+    *d++ = *s1++ ^ *s2++;
+    *d++ = *s1++ ^ *s2++;
+    *d++ = *s1++ ^ *s2++;
+    *d++ = *s1++ ^ *s2++;
+}
+
+/**
+ * @brief Encrypt several independent blocks stored contiguously, using the
+ * multi-block function of the cipher if any, one block at a time otherwise.
+ *
+ * @param ctx The Manx context
+ * @param out The output blocks
+ * @param in The input blocks
+ * @param nblocks The number of blocks
+ */
+static inline void ctx_encrypt_blocks(const manx_ctx *ctx,
+            uint8_t out[], const uint8_t in[], size_t nblocks)
+{
+    if (ctx->cipher->encrypt_blocks != NULL) {
+        ctx->cipher->encrypt_blocks(out, in, nblocks, &ctx->rkeys);
+        return;
+    }
+    for (size_t i = 0; i < nblocks; i++)
+        ctx->cipher->encrypt(out + i*BLOCKBYTES, in + i*BLOCKBYTES, &ctx->rkeys);
+}
+
+/**
+ * @brief Decrypt several independent blocks stored contiguously, using the
+ * multi-block function of the cipher if any, one block at a time otherwise.
+ * The cipher is assumed to support decryption.
+ *
+ * @param ctx The Manx context
+ * @param out The output blocks
+ * @param in The input blocks
+ * @param nblocks The number of blocks
+ */
+static inline void ctx_decrypt_blocks(const manx_ctx *ctx,
+            uint8_t out[], const uint8_t in[], size_t nblocks)
+{
+    const roundkeys_t *rkeys_inv = manx_ctx_rkeys_inv(ctx);
+
+    if (ctx->cipher->decrypt_blocks != NULL) {
+        ctx->cipher->decrypt_blocks(out, in, nblocks, rkeys_inv);
+        return;
+    }
+    for (size_t i = 0; i < nblocks; i++)
+        ctx->cipher->decrypt(out + i*BLOCKBYTES, in + i*BLOCKBYTES, rkeys_inv);
+}
 
 /**
  * @brief Given a bit position within an octet, increases its
@@ -71,35 +278,6 @@ static inline void rshift(uint8_t out[], const uint8_t in[], size_t inlen, size_
     }
 }
 
-/**
- * @brief Shift a byte array to the left by a certain amount of bits.
- *
- * @param out The shifted byte array
- * @param in The input byte array
- * @param inlen The number of bits to consider in the input byte array
- * @param b The number of bits to shift
- */
-static inline void lshift(uint8_t out[], const uint8_t in[], size_t inlen, size_t b)
-{   
-    int     i = 0;
-    uint8_t mask = 0xff << (8-b);
-
-    // while we can manipulate plain bytes
-    while (inlen >= 8) {
-        out[i]  = in[i] << b;
-        out[i] |= (in[i+1] & mask) >> (8-b);
-        inlen  -= 8;
-        i++;
-    }
-    // if the input is not byte aligned, ignore the least significant bits
-    if (inlen) {
-        mask   = 0xff << (8-inlen);
-        out[i] = (in[i] << b) & mask;
-        if (inlen > 8-b)
-            out[i] |= (in[i+1] & (mask << (8-b))) >> (8-b);
-    }
-}
-
 /**
  * @brief Concatenate bits into a byte array which is not-necessarily byte aligned.
  *
@@ -146,36 +324,301 @@ static inline void concat_bits(uint8_t out[], size_t *oct, size_t *bit, const ui
 }
 
 /**
- * @brief Depad one-zero padded input.
- * 
- * @param out The output unpadded block
- * @param in The input block
- * 
- * @return The number of output bits after depadding
- */
-static inline size_t depad_10(uint8_t *out, const uint8_t in[BLOCKBYTES])
-{
-    size_t bytes  = BLOCKBYTES - 1;
-    size_t outlen = BLOCKBITS  - 1;
-    size_t bit;
-    size_t tmp;
-
-    // decrement outlen while we did not find a bit equals to 1
-    while (bytes) {
-        tmp = in[bytes--];
-        for (bit = 0; bit < 8; bit++, outlen--) {
-            if (tmp & (1 << bit)) {
-                bytes = 0;
-                break;
-            }
-        }
+ * @brief Load up to 64 bits from a byte array into a 64-bit word, the first
+ * bit of the array being the most significant bit of the word.
+ * Only the ceil(len/8) bytes holding these bits are read.
+ *
+ * @param in The input byte array
+ * @param len The number of bits to load (at most 64)
+ *
+ * @return The loaded bits, left-aligned (the least significant 64-len bits are cleared)
+ */
+MANX_ALWAYS_INLINE uint64_t load_bits64(const uint8_t in[], size_t len)
+{
+    size_t   nbytes = (len + 7) / 8;
+    uint64_t x;
+
+    if (len == 0)
+        return 0;
+    // two overlapping loads of fixed size cover nbytes bytes
+    if (nbytes == 8)
+        x = GET_BE64(in);
+    else if (nbytes >= 4)
+        x = ((uint64_t)GET_BE32(in) << 32) | ((uint64_t)GET_BE32(in + nbytes - 4) << (64 - 8*nbytes));
+    else if (nbytes >= 2)
+        x = ((uint64_t)GET_BE16(in) << 48) | ((uint64_t)GET_BE16(in + nbytes - 2) << (64 - 8*nbytes));
+    else
+        x = (uint64_t)in[0] << 56;
+    return x & (~(uint64_t)0 << (64 - len));
+}
+
+/**
+ * @brief Load up to 64 bits from a byte array, starting at any bit position.
+ * Only the bytes holding these bits are read.
+ *
+ * @param in The input byte array
+ * @param pos The bit position of the first bit to load
+ * @param len The number of bits to load (at most 64)
+ *
+ * @return The loaded bits, left-aligned (the least significant 64-len bits are cleared)
+ */
+MANX_ALWAYS_INLINE uint64_t load_bits64_at(const uint8_t in[], size_t pos, size_t len)
+{
+    size_t s = pos % 8;
+
+    if (len == 0)
+        return 0;
+    in += pos / 8;
+    if (s + len <= 64)
+        return load_bits64(in, s + len) << s;
+    // the last bits to load are in a 9th byte
+    return (load_bits64(in, 64) << s) |
+           ((uint64_t)(in[8] & (0xff << (72 - s - len))) >> (8 - s));
+}
+
+/**
+ * @brief Bit string written 64 bits at a time: the bits are accumulated in a
+ * 64-bit word which is stored (big-endian) once full, so that the output
+ * is written sequentially, each byte only once.
+ */
+typedef struct {
+    uint8_t  *out;  // where to store the next 64-bit word
+    uint64_t acc;   // pending bits, left-aligned
+    size_t   fill;  // number of pending bits (< 64)
+} bitbuf64_t;
+
+/**
+ * @brief Start writing a bit string to a byte array.
+ *
+ * @param b The bit string
+ * @param out The output byte array
+ */
+MANX_ALWAYS_INLINE void bitbuf64_init(bitbuf64_t *b, uint8_t out[])
+{
+    b->out  = out;
+    b->acc  = 0;
+    b->fill = 0;
+}
+
+/**
+ * @brief Append up to 64 bits to a bit string.
+ *
+ * @param b The bit string
+ * @param x The bits to append, left-aligned (the other bits must be cleared)
+ * @param len The number of bits to append (at most 64)
+ */
+MANX_ALWAYS_INLINE void bitbuf64_put(bitbuf64_t *b, uint64_t x, size_t len)
+{
+    size_t fill = b->fill;
+
+    b->acc  |= x >> fill;
+    b->fill += len;
+    if (b->fill >= 64) {
+        PUT_BE64(b->out, b->acc);
+        b->out  += 8;
+        b->fill -= 64;
+        // (x << 1) << (63 - fill) avoids an undefined shift by 64 when fill = 0
+        b->acc   = (x << 1) << (63 - fill);
+    }
+}
+
+/**
+ * @brief Append zeros to a bit string.
+ *
+ * @param b The bit string
+ * @param len The number of zeros to append
+ */
+MANX_ALWAYS_INLINE void bitbuf64_skip(bitbuf64_t *b, size_t len)
+{
+    for (; len > 64; len -= 64)
+        bitbuf64_put(b, 0, 64);
+    bitbuf64_put(b, 0, len);
+}
+
+/**
+ * @brief Append the bits of a byte array to a bit string.
+ *
+ * @param b The bit string
+ * @param in The input byte array
+ * @param pos The bit position of the first bit to append within in
+ * @param inlen The number of bits to append
+ */
+MANX_ALWAYS_INLINE void bitbuf64_concat(bitbuf64_t *b, const uint8_t in[], size_t pos, size_t inlen)
+{
+    for (; inlen > 64; inlen -= 64, pos += 64)
+        bitbuf64_put(b, load_bits64_at(in, pos, 64), 64);
+    bitbuf64_put(b, load_bits64_at(in, pos, inlen), inlen);
+}
+
+/**
+ * @brief Append zeros to a bit string until a given output position, and
+ * store the pending bits.
+ *
+ * @param b The bit string
+ * @param end The end of the output byte array (multiple of 64 bits)
+ */
+MANX_ALWAYS_INLINE void bitbuf64_flush(bitbuf64_t *b, uint8_t *end)
+{
+    while (b->out < end) {
+        PUT_BE64(b->out, b->acc);
+        b->out += 8;
+        b->acc  = 0;
     }
-    // copy outlen bits from input to output
-    for(size_t i = 0; i < outlen/8; i++)
-        out[i] = in[i];
-    out[(outlen+7)/8] = tmp & (0xff << (8-bit));
+    b->fill = 0;
+}
+
+/**
+ * @brief Load a block as two 64-bit big-endian limbs, w[0] holding its first
+ * 64 bits.
+ */
+MANX_ALWAYS_INLINE void load_block64(uint64_t w[2], const uint8_t in[BLOCKBYTES])
+{
+    w[0] = GET_BE64(in);
+    w[1] = GET_BE64(in + 8);
+}
+
+/**
+ * @brief Store a block given as two 64-bit big-endian limbs, w[0] holding its
+ * first 64 bits.
+ */
+MANX_ALWAYS_INLINE void store_block64(uint8_t out[BLOCKBYTES], const uint64_t w[2])
+{
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // two byte swaps and two word stores, which GCC does not always infer
+    uint64_t x[2] = {__builtin_bswap64(w[0]), __builtin_bswap64(w[1])};
+
+    __builtin_memcpy(out, x, sizeof(x));
+#else
+    PUT_BE64(out, w[0]);
+    PUT_BE64(out + 8, w[1]);
+#endif
+}
+
+/**
+ * @brief Shift a 128-bit value (w[0] being its most significant limb) to the
+ * left by 0 <= b <= 128 bits, without any branch.
+ */
+MANX_ALWAYS_INLINE void shl128(uint64_t w[2], size_t b)
+{
+    size_t   k   = b % 64;
+    uint64_t big = -(uint64_t)((b / 64) & 1);    // 64 <= b < 128
+    uint64_t all = -(uint64_t)(b >= 128);
+    uint64_t hi  = (w[0] << k) | ((w[1] >> 1) >> (63 - k));
+    uint64_t lo  = w[1] << k;
+
+    w[0] = ((hi & ~big) | (lo & big)) & ~all;
+    w[1] = lo & ~big & ~all;
+}
+
+/**
+ * @brief Shift a 128-bit value (w[0] being its most significant limb) to the
+ * right by 0 <= b <= 128 bits, without any branch.
+ */
+MANX_ALWAYS_INLINE void shr128(uint64_t w[2], size_t b)
+{
+    size_t   k   = b % 64;
+    uint64_t big = -(uint64_t)((b / 64) & 1);    // 64 <= b < 128
+    uint64_t all = -(uint64_t)(b >= 128);
+    uint64_t hi  = w[0] >> k;
+    uint64_t lo  = (w[1] >> k) | ((w[0] << 1) << (63 - k));
+
+    w[1] = ((lo & ~big) | (hi & big)) & ~all;
+    w[0] = hi & ~big & ~all;
+}
+
+/**
+ * @brief Keep the len <= 128 most significant bits of a 128-bit value and
+ * clear the others, without any branch.
+ */
+MANX_ALWAYS_INLINE void mask128(uint64_t w[2], size_t len)
+{
+    uint64_t m[2] = {~(uint64_t)0, ~(uint64_t)0};
+
+    shr128(m, len);
+    w[0] &= ~m[0];
+    w[1] &= ~m[1];
+}
+
+/**
+ * @brief Add two 128-bit values (w[0] being their most significant limb),
+ * modulo 2^128, without any branch.
+ */
+MANX_ALWAYS_INLINE void add128(uint64_t w[2], const uint64_t x[2])
+{
+    uint64_t lo = w[1] + x[1];
+
+    w[0] += x[0] + (lo < x[1]);
+    w[1]  = lo;
+}
+
+/**
+ * @brief Load up to 128 bits from a byte array as a 128-bit value (w[0] being
+ * its most significant limb), the first bit of the array being its most
+ * significant bit. Only the ceil(len/8) bytes holding these bits are read.
+ */
+MANX_ALWAYS_INLINE void load_bits128(uint64_t w[2], const uint8_t in[], size_t len)
+{
+    w[0] = load_bits64(in, (len < 64) ? len : 64);
+    w[1] = (len > 64) ? load_bits64(in + 8, len - 64) : 0;
+}
+
+/**
+ * @brief Count the trailing zeros of a non-zero 64-bit word.
+ * On the targeted platforms, the GCC builtin compiles to an instruction whose
+ * latency does not depend on its operand (e.g. tzcnt/bsf, rbit+clz); the
+ * portable fallback is branch-free.
+ */
+MANX_ALWAYS_INLINE size_t ctz64(uint64_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    size_t n = 0, z;
+
+    x &= -x;
+    z = ((x & 0x00000000ffffffffULL) == 0); n += z << 5;
+    z = ((x & 0x0000ffff0000ffffULL) == 0); n += z << 4;
+    z = ((x & 0x00ff00ff00ff00ffULL) == 0); n += z << 3;
+    z = ((x & 0x0f0f0f0f0f0f0f0fULL) == 0); n += z << 2;
+    z = ((x & 0x3333333333333333ULL) == 0); n += z << 1;
+    z = ((x & 0x5555555555555555ULL) == 0); n += z;
+    return n;
+#endif
+}
+
+/**
+ * @brief Locate the one-zero padding of a 128-bit value in constant time,
+ * i.e. without any branch nor memory access depending on its position.
+ *
+ * @param w The padded value (w[0] being its most significant limb)
+ * @param len The number of bits preceding the padding bit
+ *
+ * @return 0 if a padding bit was found, non-zero value if w is null
+ */
+MANX_ALWAYS_INLINE int depad_10(const uint64_t w[2], size_t *len)
+{
+    uint64_t lo0 = -(uint64_t)(w[1] == 0);       // padding within w[0]
+    uint64_t x   = (w[1] & ~lo0) | (w[0] & lo0);
+    int      ret = (x == 0);
+
+    // the top bit only avoids calling ctz64 on 0 when there is no padding
+    *len = BLOCKBITS - 1 - (ctz64(x | ((uint64_t)ret << 63)) + (lo0 & 64));
+    return ret;
+}
+
+/**
+ * @brief Store the len <= 128 most significant bits of a 128-bit value, i.e.
+ * write the (len + 7) / 8 first bytes of out. The bits following the len
+ * stored ones within the last byte are cleared.
+ */
+MANX_ALWAYS_INLINE void store_bits128(uint8_t out[], const uint64_t w[2], size_t len)
+{
+    size_t i;
 
-    return outlen;
+    for (i = 0; i < len / 8; i++)
+        out[i] = (uint8_t)(w[i / 8] >> (56 - 8*(i % 8)));
+    if (len % 8)
+        out[i] = (uint8_t)(w[i / 8] >> (56 - 8*(i % 8))) & (0xff << (8 - len%8));
 }
 
 /**
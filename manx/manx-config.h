@@ -19,4 +19,63 @@
  */
 #define MANX2_ALPHAMAX 24
 
+/**
+ *  Preprocessor directives to indicate whether the input blocks are formatted
+ *  with 64-bit word operations rather than byte-wise bit concatenations.
+ *  The word-level formatter pays off on 64-bit platforms for Manx2, whose
+ *  fields are rarely byte-aligned, while most Manx1 fields are byte-aligned
+ *  for usual nonce lengths, making the byte-wise formatter hard to beat.
+ */
+#ifndef MANX1_WORD_FORMATTING
+#define MANX1_WORD_FORMATTING 0
+#endif
+#ifndef MANX2_WORD_FORMATTING
+#if defined(__x86_64__) || defined(__aarch64__)
+#define MANX2_WORD_FORMATTING 1
+#else
+#define MANX2_WORD_FORMATTING 0
+#endif
+#endif
+
+/**
+ *  Preprocessor directive to indicate whether the manx1_static_* and
+ *  manx2_static_* functions are compiled when block_cipher.h binds a block
+ *  cipher at compile time (see manx.h), so that its calls can be inlined.
+ */
+#ifndef MANX_STATIC_CIPHER
+#define MANX_STATIC_CIPHER 1
+#endif
+
+/**
+ *  Preprocessor directive to indicate whether the Manx1 and Manx2 functions
+ *  accumulate the cycles spent in each of their phases (key expansion,
+ *  formatting, cipher calls, ...) in per-thread counters (see manx_phase_get
+ *  in manx.h). The cycle counter is read with MANX_PHASE_CLOCK(), which
+ *  defaults to RDTSC on x86 and has to be defined on other platforms.
+ *  The timers add a few tens of cycles per phase: only for profiling builds.
+ */
+#ifndef MANX_PHASE_TIMERS
+#define MANX_PHASE_TIMERS 0
+#endif
+
+/**
+ *  Preprocessor directive to indicate whether the decryption round keys of a
+ *  Manx context are derived the first time it is used for decryption (see
+ *  manx-ctx.c) rather than in manx_ctx_init. The lazy derivation relies on a
+ *  compare-and-swap, hence is disabled on targets without native atomics
+ *  (e.g. AVR, Cortex-M0), where it would require libatomic.
+ */
+#ifndef MANX_CTX_LAZY_INV
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4) && __GCC_ATOMIC_INT_LOCK_FREE == 2
+#define MANX_CTX_LAZY_INV 1
+#else
+#define MANX_CTX_LAZY_INV 0
+#endif
+#endif
+
+/**
+ *  Maximal number of messages processed in lockstep by the batch functions.
+ */
+#define MANX_BATCH 8
+
 #endif
@@ -0,0 +1,78 @@
+/**
+ * @file manx-cpu.c
+ *
+ * @brief CPU features probed at runtime by the x86_64 ports (see manx-cpu.h).
+ *
+ * @author Alexandre Adomnicai <alexandre@adomnicai.me>
+ *
+ * @date October 2026
+ */
+#include <cpuid.h>
+#include <stdint.h>
+#include "manx-cpu.h"
+
+/**
+ * Set once the CPU has been probed, so that a CPU without any feature is not
+ * probed again.
+ */
+#define CPU_PROBED 0x100
+
+static uint32_t xgetbv(uint32_t xcr)
+{
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(xcr));
+    (void)hi;
+    return lo;
+}
+
+static int cpu_probe(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+    int features = CPU_PROBED;
+    int ymm = 0, zmm = 0;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return features;
+    if (ecx & bit_AES)
+        features |= MANX_CPU_AES;
+    if ((ecx & bit_OSXSAVE) && (ecx & bit_AVX)) {
+        uint32_t xcr0 = xgetbv(0);
+        ymm = (xcr0 & 0x06) == 0x06;  // XMM and YMM states
+        zmm = (xcr0 & 0xe6) == 0xe6;  // XMM, YMM, opmask and ZMM states
+    }
+    if (!ymm || !__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        return features;
+    if (ebx & bit_AVX2)
+        features |= MANX_CPU_AVX2;
+    if ((features & MANX_CPU_AES) && (ecx & bit_VAES)) {
+        if (ebx & bit_AVX2)
+            features |= MANX_CPU_VAES256;
+        if (zmm && (ebx & bit_AVX512F))
+            features |= MANX_CPU_VAES512;
+    }
+    return features;
+}
+
+int manx_cpu_features(void)
+{
+    static int features = 0;
+    int f = __atomic_load_n(&features, __ATOMIC_RELAXED);
+    if (!f) {
+        f = cpu_probe();
+        __atomic_store_n(&features, f, __ATOMIC_RELAXED);
+    }
+    return f & ~CPU_PROBED;
+}
+
+int manx_cpu_supports(int features)
+{
+    return (manx_cpu_features() & features) == features;
+}
+
+int manx_cpu_best(const int required[], int count)
+{
+    int impl = count - 1;
+    while (impl > 0 && !manx_cpu_supports(required[impl]))
+        impl--;
+    return impl;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file manx-cpu.h
+ *
+ * @brief CPU features probed at runtime by the x86_64 ports, to select the
+ * implementation of their block cipher (see dispatch.c in each of them).
+ *
+ * The ports are not built with -march=native, so that a single binary runs on
+ * any x86_64 processor: the kernels relying on instruction set extensions
+ * (AES-NI, AVX2, VAES) are compiled for their own target, through function
+ * attributes or a per-file flag, so that the rest of the code does not require
+ * them. Such kernels must thus only be called if the CPU (and the OS, for the
+ * AVX states) supports their target, as reported by manx_cpu_supports. Each
+ * port describes its implementations by the features they require, from the
+ * slowest to the fastest one, and manx_cpu_best picks the fastest supported.
+ *
+ * @author Alexandre Adomnicai <alexandre@adomnicai.me>
+ *
+ * @date October 2026
+ */
+#ifndef MANX_CPU_H
+#define MANX_CPU_H
+
+/**
+ * CPU features, the AVX ones requiring the OS to enable the corresponding
+ * register states (XGETBV).
+ */
+#define MANX_CPU_AES     0x01  // AES-NI
+#define MANX_CPU_AVX2    0x02  // AVX2, YMM state enabled by the OS
+#define MANX_CPU_VAES256 0x04  // VAES and AVX2, YMM state enabled by the OS
+#define MANX_CPU_VAES512 0x08  // VAES and AVX512F, ZMM state enabled by the OS
+
+/**
+ * @brief Features of the CPU, probed (CPUID and XGETBV) once and for all.
+ *
+ * @return A combination of MANX_CPU_* flags
+ */
+int manx_cpu_features(void);
+
+/**
+ * @brief Whether the CPU supports all the given features.
+ *
+ * @param features A combination of MANX_CPU_* flags (0 for portable code)
+ *
+ * @return 1 if supported, 0 otherwise
+ */
+int manx_cpu_supports(int features);
+
+/**
+ * @brief Fastest implementation supported out of count ones.
+ *
+ * @param required The features required by each implementation, from the
+ * slowest to the fastest one, the first one being portable
+ * @param count The number of implementations considered
+ *
+ * @return The index of the last implementation supported
+ */
+int manx_cpu_best(const int required[], int count);
+
+#endif
@@ -0,0 +1,126 @@
+/**
+ * @file manx-ctx.c
+ * 
+ * @brief Manx contexts to expand the key once and for all, so that the key
+ * schedule is not computed again on every Manx1/Manx2 call.
+ *
+ * @author Alexandre Adomnicai <alexandre@adomnicai.me>
+ *
+ * @date October 2026
+ */
+#include "manx.h"
+#include "manx-common.h"
+
+/**
+ *  States of the decryption round keys within a Manx context.
+ */
+#define INV_NONE  0 // not derived yet
+#define INV_BUSY  1 // being derived by another thread
+#define INV_READY 2 // ready to be used
+
+#if MANX_CTX_LAZY_INV
+/**
+ *  Hint for the loop waiting for another thread to derive the decryption
+ *  round keys.
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CPU_RELAX() _mm_pause()
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sched.h>
+#define CPU_RELAX() sched_yield()
+#else
+#define CPU_RELAX()
+#endif
+#endif
+
+/**
+ *  Bytes of round keys of a block cipher, the decryption round keys of a
+ *  context being stored right after the ones for encryption.
+ */
+static size_t rkeys_size(const manx_cipher *cipher)
+{
+    return cipher->rkeys_size ? cipher->rkeys_size : sizeof(roundkeys_t);
+}
+
+static roundkeys_t *ctx_rkeys_inv(const manx_ctx *ctx)
+{
+    return (roundkeys_t *)((uint8_t *)&ctx->rkeys + rkeys_size(ctx->cipher));
+}
+
+size_t manx_ctx_size(const manx_cipher *cipher)
+{
+    size_t size = offsetof(manx_ctx, rkeys) + rkeys_size(cipher);
+
+    if (cipher->kexpand_inv != NULL)
+        size += rkeys_size(cipher);
+    size = (size + _Alignof(manx_ctx) - 1) & ~(_Alignof(manx_ctx) - 1);
+    return size < sizeof(manx_ctx) ? size : sizeof(manx_ctx);
+}
+
+int manx_ctx_init(manx_ctx *ctx, const uint8_t k[], const manx_cipher *cipher)
+{
+    ctx->cipher = NULL;
+    if (cipher == NULL || cipher->kexpand == NULL || cipher->encrypt == NULL)
+        return 1;
+
+    ctx->cipher    = cipher;
+    ctx->inv_state = INV_NONE;
+    cipher->kexpand(&ctx->rkeys, k);
+#if !MANX_CTX_LAZY_INV
+    // no compare-and-swap to derive them safely later on
+    if (cipher->kexpand_inv != NULL)
+        cipher->kexpand_inv(ctx_rkeys_inv(ctx), &ctx->rkeys);
+    ctx->inv_state = INV_READY;
+#endif
+
+    return 0;
+}
+
+const roundkeys_t *manx_ctx_rkeys_inv(const manx_ctx *ctx)
+{
+    if (ctx->cipher->kexpand_inv == NULL)
+        return &ctx->rkeys;
+#if MANX_CTX_LAZY_INV
+    // the decryption round keys are logically part of the (const) context,
+    // they are just derived lazily so that encryption-only keys do not pay it
+    manx_ctx *mctx = (manx_ctx *)ctx;
+    int state;
+
+    state = __atomic_load_n(&mctx->inv_state, __ATOMIC_ACQUIRE);
+    if (state != INV_READY) {
+        state = INV_NONE;
+        if (__atomic_compare_exchange_n(&mctx->inv_state, &state, INV_BUSY, 0,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+            ctx->cipher->kexpand_inv(ctx_rkeys_inv(ctx), &ctx->rkeys);
+            __atomic_store_n(&mctx->inv_state, INV_READY, __ATOMIC_RELEASE);
+        }
+        // another thread is deriving the round keys, wait for it
+        while (__atomic_load_n(&mctx->inv_state, __ATOMIC_ACQUIRE) != INV_READY)
+            CPU_RELAX();
+    }
+#endif
+
+    return ctx_rkeys_inv(ctx);
+}
+
+void manx_ctx_wipe(manx_ctx *ctx)
+{
+    // volatile accesses so that the compiler does not optimize it out
+    volatile uint8_t *p = (volatile uint8_t *)ctx;
+    size_t size = ctx->cipher ? manx_ctx_size(ctx->cipher) : offsetof(manx_ctx, rkeys);
+    for (size_t i = 0; i < size; i++)
+        p[i] = 0x00;
+}
+
+#if MANX_PHASE_TIMERS
+_Thread_local manx_phase_stats manx_phase_local;
+
+void manx_phase_get(manx_phase_stats *stats, int reset)
+{
+    if (stats != NULL)
+        *stats = manx_phase_local;
+    if (reset)
+        manx_phase_local = (manx_phase_stats){0};
+}
+#endif
@@ -0,0 +1,224 @@
+/**
+ * @file manx-fixed.h
+ *
+ * @brief Manx encoders specialized at compile time for a fixed parameter set.
+ *
+ * When the nonce, AD and message lengths (ν, α, ℓ) of an application are
+ * known in advance, `MANX1_FIXED` and `MANX2_FIXED` generate encoding and
+ * encryption functions for this parameter set only. All the bit positions are
+ * then compile-time constants, so that the formatting boils down to a few
+ * constant shifts and masks instead of the generic bit-level concatenation.
+ * The generated functions produce the same blocks and ciphertexts as their
+ * generic counterparts, and the parameter set is validated at compile time.
+ */
+#ifndef MANX_FIXED_H_
+#define MANX_FIXED_H_
+
+#include "manx.h"
+#include "manx-common.h"
+
+/**
+ * @brief Read w <= 8 bits from a byte array, starting at bit position pos.
+ * Only the bytes covering these bits are accessed.
+ *
+ * @param in The input byte array
+ * @param pos The bit position of the first bit to read
+ * @param w The number of bits to read
+ *
+ * @return The bits read, left-aligned in a byte (the others are cleared)
+ */
+MANX_ALWAYS_INLINE uint8_t fixed_get8(const uint8_t in[], size_t pos, size_t w)
+{
+    size_t  o = pos / 8;
+    size_t  s = pos % 8;
+    uint8_t x = in[o] << s;
+
+    if (s && s + w > 8)
+        x |= in[o+1] >> (8 - s);
+    return x & (0xff << (8 - w));
+}
+
+/**
+ * @brief Append w <= 8 left-aligned bits to a zero-initialized byte array,
+ * starting at bit position pos.
+ *
+ * @param out The output byte array
+ * @param pos The bit position of the first bit to write
+ * @param x The bits to write (left-aligned, other bits cleared)
+ * @param w The number of bits to write
+ */
+MANX_ALWAYS_INLINE void fixed_put8(uint8_t out[], size_t pos, uint8_t x, size_t w)
+{
+    size_t o = pos / 8;
+    size_t s = pos % 8;
+
+    out[o] |= x >> s;
+    if (s && s + w > 8)
+        out[o+1] |= x << (8 - s);
+}
+
+/**
+ * @brief Copy len bits from in (starting at bit position ipos) to a
+ * zero-initialized byte array out (starting at bit position opos).
+ * When called with constant arguments, the loop is fully unrolled and all the
+ * shifts and masks are resolved at compile time.
+ *
+ * @param out The output byte array
+ * @param opos The bit position within out
+ * @param in The input byte array
+ * @param ipos The bit position within in
+ * @param len The number of bits to copy
+ */
+MANX_ALWAYS_INLINE void fixed_copy_bits(uint8_t out[], size_t opos,
+            const uint8_t in[], size_t ipos, size_t len)
+{
+#if defined(__GNUC__)
+#pragma GCC unroll 32
+#endif
+    for (size_t i = 0; i < len; i += 8) {
+        size_t w = (len - i < 8) ? len - i : 8;
+        fixed_put8(out, opos + i, fixed_get8(in, ipos + i, w), w);
+    }
+}
+
+/**
+ * @brief Set the bit at position pos within a byte array.
+ */
+MANX_ALWAYS_INLINE void fixed_set_bit(uint8_t out[], size_t pos)
+{
+    out[pos / 8] |= 0x80 >> (pos % 8);
+}
+
+/**
+ *  Manx1 parameter s = max(n - ν + τ, α_max) for a nonce length NU.
+ */
+#define MANX1_FIXED_S(NU) MAX(BLOCKBITS - (NU) + MANX_TAU, MANX1_ALPHAMAX)
+/**
+ *  Position of the message within the Manx1 blocks (V[1], V[2]).
+ */
+#define MANX1_FIXED_MPOS(NU, ALPHA) \
+    (MANX1_VARIABLE_ADLEN ? (NU) + MANX1_FIXED_S(NU) : (NU) + (ALPHA))
+
+/**
+ * @brief Generate Manx1 functions specialized for nonces, AD and messages of
+ * NU, ALPHA and ELL bits respectively:
+ *
+ * - `void name_init_blocks(uint8_t v[2*BLOCKBYTES], const uint8_t n[],
+ *   const uint8_t a[], const uint8_t m[])` builds the same blocks
+ *   (V[1], V[2] || pad_{n-v2}(M)) as `manx1_init_blocks`.
+ * - `void name_enc(const manx_ctx *ctx, uint8_t c[], const uint8_t n[],
+ *   const uint8_t a[], const uint8_t m[])` computes the same BLOCKBITS-bit
+ *   ciphertext as `manx1_ctx_enc`.
+ *
+ * Parameter sets rejected by `manx1_enc` do not compile.
+ */
+#define MANX1_FIXED(name, NU, ALPHA, ELL)                                      \
+_Static_assert((ELL) < BLOCKBITS - MANX_TAU,                                   \
+    #name ": message too long (error code 1)");                                \
+_Static_assert((ALPHA) <= MANX1_ALPHAMAX,                                      \
+    #name ": additional data too long (error code 2)");                        \
+_Static_assert((ELL) < BLOCKBITS - (MANX1_FIXED_S(NU) - (BLOCKBITS - (NU))),   \
+    #name ": message too long for this nonce length (error code 3)");          \
+                                                                               \
+MANX_ALWAYS_INLINE void name##_init_blocks(uint8_t v[2*BLOCKBYTES],             \
+            const uint8_t n[], const uint8_t a[], const uint8_t m[])           \
+{                                                                              \
+    for (size_t i = 0; i < 2*BLOCKBYTES; i++)                                  \
+        v[i] = 0x00;                                                           \
+    fixed_copy_bits(v, 0, n, 0, (NU));                                         \
+    fixed_copy_bits(v, (NU), a, 0, (ALPHA));                                   \
+    /* if |A| = s, the AD padding bit is overwritten by the 1st message bit */ \
+    if (MANX1_VARIABLE_ADLEN && ((ELL) == 0 || (ALPHA) != MANX1_FIXED_S(NU)))  \
+        fixed_set_bit(v, (NU) + (ALPHA));                                      \
+    fixed_copy_bits(v, MANX1_FIXED_MPOS(NU, ALPHA), m, 0, (ELL));              \
+    fixed_set_bit(v, MANX1_FIXED_MPOS(NU, ALPHA) + (ELL));                     \
+}                                                                              \
+                                                                               \
+static inline void name##_enc(const manx_ctx *ctx, uint8_t c[],                \
+            const uint8_t n[], const uint8_t a[], const uint8_t m[])           \
+{                                                                              \
+    uint8_t v[2*BLOCKBYTES];                                                   \
+    uint8_t *v1 = v;                                                           \
+    uint8_t *v2 = v + BLOCKBYTES;                                              \
+                                                                               \
+    name##_init_blocks(v, n, a, m);                                            \
+    ctx->cipher->encrypt(v1, v1, &ctx->rkeys);                                 \
+    doubling(v1);                                                              \
+    xor_block(v2, v2, v1);                                                     \
+    ctx->cipher->encrypt(c, v2, &ctx->rkeys);                                  \
+    xor_block(c, c, v1);                                                       \
+}
+
+/**
+ *  Manx2 parameter r = n - (ν + α* + 2) for a nonce length NU.
+ */
+#define MANX2_FIXED_R(NU) (BLOCKBITS - ((NU) + MANX2_ALPHASTAR + 2))
+
+/**
+ * @brief Generate Manx2 functions specialized for nonces, AD and messages of
+ * NU, ALPHA and ELL bits respectively:
+ *
+ * - `size_t name_init_blocks(uint8_t t[2*BLOCKBYTES], const uint8_t n[],
+ *   const uint8_t a[], const uint8_t m[])` builds the same block(s) as
+ *   `manx2_init_blocks` and returns their number (1 for tiny messages, 2
+ *   otherwise). For tiny messages, only the first block of t is written.
+ * - `void name_enc(const manx_ctx *ctx, uint8_t c[], const uint8_t n[],
+ *   const uint8_t a[], const uint8_t m[])` computes the same ciphertext as
+ *   `manx2_ctx_enc`, whose length is `name_init_blocks(...)*BLOCKBITS` bits.
+ *
+ * Parameter sets rejected by `manx2_enc` do not compile.
+ */
+#define MANX2_FIXED(name, NU, ALPHA, ELL)                                      \
+_Static_assert((NU) >= MANX_TAU,                                               \
+    #name ": nonce too short (error code 1)");                                 \
+_Static_assert((ELL) < BLOCKBITS - (NU) - 2 + MANX2_FIXED_R(NU),               \
+    #name ": message too long (error code 2)");                                \
+_Static_assert((ALPHA) <= MANX2_ALPHAMAX,                                      \
+    #name ": additional data too long (error code 3)");                        \
+                                                                               \
+MANX_ALWAYS_INLINE size_t name##_init_blocks(uint8_t t[2*BLOCKBYTES],           \
+            const uint8_t n[], const uint8_t a[], const uint8_t m[])           \
+{                                                                              \
+    const size_t r    = MANX2_FIXED_R(NU);                                     \
+    const size_t mpos = (NU) + 2 + MANX2_ALPHASTAR;                            \
+    const size_t l2   = ((ELL) > r) ? (ELL) - r : 0; /* |M[2]| */              \
+                                                                               \
+    for (size_t i = 0; i < ((ELL) <= r ? 1 : 2)*BLOCKBYTES; i++)               \
+        t[i] = 0x00;                                                           \
+    /* N || xx || \bar{A} */                                                   \
+    fixed_copy_bits(t, 0, n, 0, (NU));                                         \
+    if ((ELL) <= r)                                                            \
+        fixed_set_bit(t, (NU));                                                \
+    if ((ELL) == r)                                                            \
+        fixed_set_bit(t, (NU) + 1);                                            \
+    fixed_copy_bits(t, (NU) + 2, a, 0, (ALPHA));                               \
+    if (MANX2_VARIABLE_ADLEN)                                                  \
+        fixed_set_bit(t, (NU) + 2 + (ALPHA));                                  \
+    /* tiny message: N || xx || \bar{A} || pad_r(M) */                         \
+    if ((ELL) <= r) {                                                          \
+        fixed_copy_bits(t, mpos, m, 0, (ELL));                                 \
+        if ((ELL) < r)                                                         \
+            fixed_set_bit(t, mpos + (ELL));                                    \
+        return 1;                                                              \
+    }                                                                          \
+    /* short message: (N || 00 || \bar{A} || M[1], N || 01 || pad_r(M[2])) */ \
+    fixed_copy_bits(t, mpos, m, 0, r);                                         \
+    fixed_copy_bits(t, BLOCKBITS, n, 0, (NU));                                 \
+    fixed_set_bit(t, BLOCKBITS + (NU) + 1);                                    \
+    fixed_copy_bits(t, BLOCKBITS + (NU) + 2, m, r, l2);                         \
+    fixed_set_bit(t, BLOCKBITS + (NU) + 2 + l2);                               \
+    return 2;                                                                  \
+}                                                                              \
+                                                                               \
+static inline void name##_enc(const manx_ctx *ctx, uint8_t c[],                \
+            const uint8_t n[], const uint8_t a[], const uint8_t m[])           \
+{                                                                              \
+    uint8_t t[2*BLOCKBYTES];                                                   \
+                                                                               \
+    if (name##_init_blocks(t, n, a, m) == 1)                                   \
+        ctx->cipher->encrypt(c, t, &ctx->rkeys);                               \
+    else                                                                       \
+        ctx_encrypt_blocks(ctx, c, t, 2);                                      \
+}
+
+#endif
@@ -0,0 +1,400 @@
+/**
+ * @file manx-keycache.c
+ *
+ * @brief Cache of Manx contexts (i.e. expanded round keys) keyed by device
+ * identifier, split into shards evicting their entries with CLOCK, the
+ * entries in use being pinned.
+ *
+ * @author Alexandre Adomnicai <alexandre@adomnicai.me>
+ *
+ * @date October 2026
+ */
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "manx-keycache.h"
+
+#define KC_NONE UINT32_MAX
+
+/**
+ * States of an entry.
+ */
+#define KC_FREE   0 // not in use
+#define KC_LINKED 1 // in the hash table
+#define KC_STALE  2 // invalidated while pinned, freed by the last release
+
+/**
+ * Entry of a shard, followed by the context of the device: only its first
+ * manx_ctx_size(cipher) bytes are allocated (see kc_entry_size).
+ */
+typedef struct {
+    uint64_t id;
+    uint32_t next;   // next entry of the same bucket (KC_NONE for the last one)
+    uint16_t pins;   // acquisitions not released yet
+    uint8_t  state;
+    uint8_t  ref;    // used since the last sweep of the clock hand
+    manx_ctx ctx;
+} kc_entry;
+
+/**
+ * Shard of a cache: a hash table of size entries chained by bucket, the
+ * entries being swept by the clock hand. Aligned on a cache line so that the
+ * locks and counters of the different shards do not share one.
+ */
+typedef struct {
+    pthread_mutex_t lock;    // protects the whole shard
+    uint8_t        *entries; // size entries of stride bytes
+    uint32_t       *buckets; // first entry of each bucket
+    size_t          stride;
+    size_t          size;    // number of entries
+    size_t          mask;    // number of buckets - 1
+    size_t          hand;    // next entry considered for eviction
+    size_t          count;   // entries in the hash table
+    uint64_t        hits, misses, inserts, evictions;
+} __attribute__((aligned(64))) kc_shard;
+
+struct manx_keycache {
+    kc_shard          *shards;
+    size_t             nshards;  // power of two
+    const manx_cipher *cipher;
+    manx_key_load     *load;
+    void              *arg;
+};
+
+/**
+ * Bytes taken by an entry holding a context of the given cipher.
+ */
+static size_t kc_entry_size(const manx_cipher *cipher)
+{
+    return offsetof(kc_entry, ctx) + manx_ctx_size(cipher);
+}
+
+/**
+ * Mix the bits of a device identifier (splitmix64 finalizer), the shard being
+ * selected by the most significant bits of the hash and the bucket by the
+ * least significant ones.
+ */
+static inline uint64_t kc_hash(uint64_t id)
+{
+    id ^= id >> 30;
+    id *= 0xbf58476d1ce4e5b9ULL;
+    id ^= id >> 27;
+    id *= 0x94d049bb133111ebULL;
+    return id ^ (id >> 31);
+}
+
+static inline kc_shard *kc_shard_of(const manx_keycache *cache, uint64_t h)
+{
+    return &cache->shards[(h >> 32) & (cache->nshards - 1)];
+}
+
+static inline kc_entry *kc_at(const kc_shard *sh, uint32_t i)
+{
+    return (kc_entry *)(sh->entries + i*sh->stride);
+}
+
+static inline uint32_t kc_index(const kc_shard *sh, const kc_entry *e)
+{
+    return (uint32_t)(((const uint8_t *)e - sh->entries) / sh->stride);
+}
+
+static kc_entry *kc_find(const kc_shard *sh, uint64_t id, uint64_t h)
+{
+    for (uint32_t i = sh->buckets[h & sh->mask]; i != KC_NONE; i = kc_at(sh, i)->next)
+        if (kc_at(sh, i)->id == id)
+            return kc_at(sh, i);
+    return NULL;
+}
+
+static void kc_unlink(kc_shard *sh, kc_entry *e)
+{
+    uint32_t *link = &sh->buckets[kc_hash(e->id) & sh->mask];
+
+    while (kc_at(sh, *link) != e)
+        link = &kc_at(sh, *link)->next;
+    *link = e->next;
+    sh->count--;
+}
+
+/**
+ * Wipe an entry out of the hash table, which is the next one taken.
+ */
+static void kc_free(kc_shard *sh, kc_entry *e)
+{
+    manx_ctx_wipe(&e->ctx);
+    e->state = KC_FREE;
+    e->ref   = 0;
+    sh->hand = kc_index(sh, e);
+}
+
+/**
+ * Pin an entry, NULL if it has been pinned too many times already.
+ */
+static kc_entry *kc_pin(kc_entry *e)
+{
+    if (e == NULL || e->pins == UINT16_MAX)
+        return NULL;
+    e->ref = 1;
+    e->pins++;
+    return e;
+}
+
+/**
+ * Take a free entry, or evict the first entry neither pinned nor used since
+ * the last sweep of the clock hand (the ones used being given a second
+ * chance), NULL if all of them are pinned.
+ */
+static kc_entry *kc_victim(kc_shard *sh)
+{
+    for (size_t i = 0; i < 2*sh->size; i++) {
+        kc_entry *e = kc_at(sh, sh->hand);
+        sh->hand = (sh->hand + 1) % sh->size;
+        if (e->state == KC_FREE)
+            return e;
+        if (e->pins)
+            continue;
+        if (!e->ref) {
+            kc_unlink(sh, e);
+            sh->evictions++;
+            return e;
+        }
+        e->ref = 0;
+    }
+    return NULL;
+}
+
+manx_keycache *manx_keycache_create(size_t budget, size_t nshards,
+        const manx_cipher *cipher, manx_key_load *load, void *arg)
+{
+    manx_keycache *cache;
+    size_t         size, stride, nbuckets = 1, n = 1;
+
+    if (cipher == NULL || load == NULL)
+        return NULL;
+    while (n < (nshards ? nshards : MANX_KEYCACHE_SHARDS))
+        n <<= 1;
+    // the buckets are at most twice as many as the entries
+    stride = kc_entry_size(cipher);
+    size   = budget / n / (stride + 2*sizeof(uint32_t));
+    if (size == 0)
+        return NULL;
+    if (size > KC_NONE - 1)
+        size = KC_NONE - 1;
+    while (nbuckets < size)
+        nbuckets <<= 1;
+
+    if ((cache = calloc(1, sizeof(*cache))) == NULL)
+        return NULL;
+    cache->cipher  = cipher;
+    cache->load    = load;
+    cache->arg     = arg;
+    cache->shards  = aligned_alloc(64, n*sizeof(kc_shard));
+    if (cache->shards == NULL) {
+        free(cache);
+        return NULL;
+    }
+    for (size_t i = 0; i < n; i++) {
+        kc_shard *sh    = &cache->shards[i];
+        size_t    bytes = (size*stride + 63) & ~(size_t)63;
+        *sh = (kc_shard){ .stride = stride, .size = size, .mask = nbuckets - 1 };
+        // entries on cache lines, e.g. one per line with the on-the-fly AES-NI
+        sh->entries = aligned_alloc(64, bytes);
+        sh->buckets = malloc(nbuckets*sizeof(uint32_t));
+        if (sh->entries == NULL || sh->buckets == NULL) {
+            free(sh->entries);
+            free(sh->buckets);
+            cache->nshards = i;
+            manx_keycache_destroy(cache);
+            return NULL;
+        }
+        memset(sh->entries, 0, bytes);
+        for (size_t b = 0; b < nbuckets; b++)
+            sh->buckets[b] = KC_NONE;
+        pthread_mutex_init(&sh->lock, NULL);
+    }
+    cache->nshards = n;
+
+    return cache;
+}
+
+void manx_keycache_destroy(manx_keycache *cache)
+{
+    if (cache == NULL)
+        return;
+    for (size_t i = 0; i < cache->nshards; i++) {
+        kc_shard *sh = &cache->shards[i];
+        for (size_t j = 0; j < sh->size; j++)
+            manx_ctx_wipe(&kc_at(sh, j)->ctx);
+        pthread_mutex_destroy(&sh->lock);
+        free(sh->entries);
+        free(sh->buckets);
+    }
+    free(cache->shards);
+    free(cache);
+}
+
+const manx_ctx *manx_keycache_acquire(manx_keycache *cache, uint64_t id)
+{
+    uint64_t  h  = kc_hash(id);
+    kc_shard *sh = kc_shard_of(cache, h);
+    kc_entry *e;
+    uint8_t   key[KEYBYTES];
+    manx_ctx  ctx = { .cipher = NULL }; // wiped even if the loader fails
+
+    pthread_mutex_lock(&sh->lock);
+    if ((e = kc_find(sh, id, h)) != NULL) {
+        sh->hits++;
+        e = kc_pin(e);
+        pthread_mutex_unlock(&sh->lock);
+        return e != NULL ? &e->ctx : NULL;
+    }
+    sh->misses++;
+    pthread_mutex_unlock(&sh->lock);
+
+    // the key is fetched (e.g. from a key store) and expanded without the lock
+    if (cache->load(cache->arg, id, key) == 0)
+        manx_ctx_init(&ctx, key, cache->cipher);
+    for (size_t i = 0; i < sizeof(key); i++)
+        ((volatile uint8_t *)key)[i] = 0x00;
+    if (ctx.cipher == NULL)
+        return NULL;
+
+    pthread_mutex_lock(&sh->lock);
+    // another thread may have loaded it in the meantime
+    if ((e = kc_find(sh, id, h)) == NULL && (e = kc_victim(sh)) != NULL) {
+        uint32_t *bucket = &sh->buckets[h & sh->mask];
+        memcpy(&e->ctx, &ctx, manx_ctx_size(cache->cipher));
+        e->id    = id;
+        e->state = KC_LINKED;
+        e->next  = *bucket;
+        *bucket  = kc_index(sh, e);
+        sh->count++;
+        sh->inserts++;
+    }
+    e = kc_pin(e);
+    pthread_mutex_unlock(&sh->lock);
+    manx_ctx_wipe(&ctx);
+
+    return e != NULL ? &e->ctx : NULL;
+}
+
+void manx_keycache_release(manx_keycache *cache, const manx_ctx *ctx)
+{
+    kc_entry *e  = (kc_entry *)((uint8_t *)ctx - offsetof(kc_entry, ctx));
+    kc_shard *sh = kc_shard_of(cache, kc_hash(e->id));
+
+    pthread_mutex_lock(&sh->lock);
+    if (--e->pins == 0 && e->state == KC_STALE)
+        kc_free(sh, e);
+    pthread_mutex_unlock(&sh->lock);
+}
+
+int manx_keycache_invalidate(manx_keycache *cache, uint64_t id)
+{
+    uint64_t  h  = kc_hash(id);
+    kc_shard *sh = kc_shard_of(cache, h);
+    kc_entry *e;
+
+    pthread_mutex_lock(&sh->lock);
+    if ((e = kc_find(sh, id, h)) != NULL) {
+        kc_unlink(sh, e);
+        // still in use: wiped by the last release
+        if (e->pins)
+            e->state = KC_STALE;
+        else
+            kc_free(sh, e);
+    }
+    pthread_mutex_unlock(&sh->lock);
+
+    return e != NULL;
+}
+
+void manx_keycache_stats_get(manx_keycache *cache, manx_keycache_stats *stats, int reset)
+{
+    *stats = (manx_keycache_stats){0};
+    for (size_t i = 0; i < cache->nshards; i++) {
+        kc_shard *sh = &cache->shards[i];
+        pthread_mutex_lock(&sh->lock);
+        stats->hits      += sh->hits;
+        stats->misses    += sh->misses;
+        stats->inserts   += sh->inserts;
+        stats->evictions += sh->evictions;
+        stats->entries   += sh->count;
+        stats->capacity  += sh->size;
+        if (reset)
+            sh->hits = sh->misses = sh->inserts = sh->evictions = 0;
+        pthread_mutex_unlock(&sh->lock);
+    }
+}
+
+int manx1_cached_enc(manx_keycache *cache, uint64_t id,
+        uint8_t c[], size_t *clen,
+        const uint8_t n[], size_t nlen,
+        const uint8_t m[], size_t mlen,
+        const uint8_t a[], size_t alen)
+{
+    const manx_ctx *ctx = manx_keycache_acquire(cache, id);
+    int             ret;
+
+    if (ctx == NULL) {
+        *clen = 0;
+        return -2;
+    }
+    ret = manx1_ctx_enc(ctx, c, clen, n, nlen, m, mlen, a, alen);
+    manx_keycache_release(cache, ctx);
+    return ret;
+}
+
+int manx1_cached_dec(manx_keycache *cache, uint64_t id,
+        uint8_t p[], size_t *plen,
+        const uint8_t n[], size_t nlen,
+        const uint8_t c[], size_t clen,
+        const uint8_t a[], size_t alen)
+{
+    const manx_ctx *ctx = manx_keycache_acquire(cache, id);
+    int             ret;
+
+    if (ctx == NULL) {
+        *plen = 0;
+        return -2;
+    }
+    ret = manx1_ctx_dec(ctx, p, plen, n, nlen, c, clen, a, alen);
+    manx_keycache_release(cache, ctx);
+    return ret;
+}
+
+int manx2_cached_enc(manx_keycache *cache, uint64_t id,
+        uint8_t c[], size_t *clen,
+        const uint8_t n[], size_t nlen,
+        const uint8_t m[], size_t mlen,
+        const uint8_t a[], size_t alen)
+{
+    const manx_ctx *ctx = manx_keycache_acquire(cache, id);
+    int             ret;
+
+    if (ctx == NULL) {
+        *clen = 0;
+        return -2;
+    }
+    ret = manx2_ctx_enc(ctx, c, clen, n, nlen, m, mlen, a, alen);
+    manx_keycache_release(cache, ctx);
+    return ret;
+}
+
+int manx2_cached_dec(manx_keycache *cache, uint64_t id,
+        uint8_t p[], size_t *plen,
+        const uint8_t n[], size_t nlen,
+        const uint8_t c[], size_t clen,
+        const uint8_t a[], size_t alen)
+{
+    const manx_ctx *ctx = manx_keycache_acquire(cache, id);
+    int             ret;
+
+    if (ctx == NULL) {
+        *plen = 0;
+        return -2;
+    }
+    ret = manx2_ctx_dec(ctx, p, plen, n, nlen, c, clen, a, alen);
+    manx_keycache_release(cache, ctx);
+    return ret;
+}
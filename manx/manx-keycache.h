@@ -0,0 +1,166 @@
+/**
+ * @file manx-keycache.h
+ *
+ * @brief Cache of Manx contexts (i.e. expanded round keys) keyed by device
+ * identifier, for gateways serving many devices with a key each (POSIX
+ * threads, for hosts only).
+ *
+ * @author Alexandre Adomnicai <alexandre@adomnicai.me>
+ *
+ * @date October 2026
+ */
+#ifndef MANX_KEYCACHE_H
+#define MANX_KEYCACHE_H
+
+#include "manx.h"
+
+/**
+ * Default number of shards of a cache, each one having its own lock.
+ */
+#ifndef MANX_KEYCACHE_SHARDS
+#define MANX_KEYCACHE_SHARDS 64
+#endif
+
+/**
+ * Callback fetching the key of a device missing from the cache (e.g. from a
+ * key store), the cache expanding it with its block cipher.
+ *
+ * @return 0 if successfully executed, non-zero value if the device is unknown
+ */
+typedef int (manx_key_load)(void *arg, uint64_t id, uint8_t k[KEYBYTES]);
+
+/**
+ * Cache of Manx contexts within a fixed memory budget, split into shards
+ * according to a hash of the device identifiers. Each shard holds a hash
+ * table of its entries and evicts them with the CLOCK algorithm (an entry
+ * used since the last sweep of the clock hand is given a second chance), so
+ * that a hit only sets a bit (and pins the entry) under the lock of its
+ * shard. Each entry only takes `manx_ctx_size` bytes of context (the round
+ * keys of the cipher and room for its decryption round keys, derived on
+ * first use) along with 16 bytes of bookkeeping, and is pinned while in use
+ * rather than locked.
+ */
+typedef struct manx_keycache manx_keycache;
+
+/**
+ * Statistics of a cache, summed over its shards.
+ */
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;     // including the devices which could not be loaded
+    uint64_t inserts;    // contexts loaded into an entry (a device missed by
+                         // several threads at once being inserted once)
+    uint64_t evictions;
+    size_t   entries;    // contexts currently cached
+    size_t   capacity;   // maximal number of contexts cached
+} manx_keycache_stats;
+
+/**
+ * @brief Create a cache.
+ *
+ * @param budget The memory budget of the entries and hash tables (in bytes)
+ * @param nshards The number of shards (0 for MANX_KEYCACHE_SHARDS), rounded up
+ * to a power of two
+ * @param cipher The functions of the block cipher the keys are expanded with
+ * @param load The callback fetching the key of a missing device
+ * @param arg The first argument passed to load
+ *
+ * @return The cache, NULL if it could not be created (e.g. if the budget does
+ * not allow one entry per shard)
+ */
+manx_keycache *manx_keycache_create(size_t budget, size_t nshards,
+        const manx_cipher *cipher, manx_key_load *load, void *arg);
+
+/**
+ * @brief Wipe the contexts of a cache and release it, none of them being in
+ * use anymore.
+ */
+void manx_keycache_destroy(manx_keycache *cache);
+
+/**
+ * @brief Get the context of a device, loading it on a miss (outside of the
+ * lock of its shard) and evicting another one if needed. The context is
+ * pinned, so that it is not evicted (nor wiped) until it is released, the
+ * lock of its shard being only held within this call: any number of contexts
+ * can be acquired at once, by any number of threads.
+ *
+ * @param cache The cache
+ * @param id The device identifier
+ *
+ * @return The context, NULL if the device could not be loaded or if all the
+ * entries of its shard are pinned
+ */
+const manx_ctx *manx_keycache_acquire(manx_keycache *cache, uint64_t id);
+
+/**
+ * @brief Unpin a context returned by `manx_keycache_acquire`, which must not
+ * be used afterwards.
+ */
+void manx_keycache_release(manx_keycache *cache, const manx_ctx *ctx);
+
+/**
+ * @brief Remove the context of a device (e.g. after a key rotation), which
+ * is wiped, once released if it is in use: the next acquisition loads the
+ * device again.
+ *
+ * @return 1 if the device was cached, 0 otherwise
+ */
+int manx_keycache_invalidate(manx_keycache *cache, uint64_t id);
+
+/**
+ * @brief Get the statistics of a cache.
+ *
+ * @param cache The cache
+ * @param stats The statistics
+ * @param reset Whether the hits, misses, inserts and evictions are reset
+ */
+void manx_keycache_stats_get(manx_keycache *cache, manx_keycache_stats *stats, int reset);
+
+/**
+ * @brief Authenticated encryption using Manx1 with the key of a device.
+ *
+ * @param cache The cache
+ * @param id The device identifier
+ *
+ * See `manx1_enc` for the description of the other parameters.
+ *
+ * @return 0 if successfully executed, -2 if the context of the device could not
+ * be acquired, error code of `manx1_ctx_enc` otherwise
+ */
+int manx1_cached_enc(manx_keycache *cache, uint64_t id,
+        uint8_t c[], size_t *clen,
+        const uint8_t n[], size_t nlen,
+        const uint8_t m[], size_t mlen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Authenticated decryption using Manx1 with the key of a device.
+ * Same as `manx1_cached_enc`, with the error codes of `manx1_ctx_dec`.
+ */
+int manx1_cached_dec(manx_keycache *cache, uint64_t id,
+        uint8_t p[], size_t *plen,
+        const uint8_t n[], size_t nlen,
+        const uint8_t c[], size_t clen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Authenticated encryption using Manx2 with the key of a device.
+ * Same as `manx1_cached_enc`, with the error codes of `manx2_ctx_enc`.
+ */
+int manx2_cached_enc(manx_keycache *cache, uint64_t id,
+        uint8_t c[], size_t *clen,
+        const uint8_t n[], size_t nlen,
+        const uint8_t m[], size_t mlen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Authenticated decryption using Manx2 with the key of a device.
+ * Same as `manx1_cached_enc`, with the error codes of `manx2_ctx_dec`.
+ */
+int manx2_cached_dec(manx_keycache *cache, uint64_t id,
+        uint8_t p[], size_t *plen,
+        const uint8_t n[], size_t nlen,
+        const uint8_t c[], size_t clen,
+        const uint8_t a[], size_t alen);
+
+#endif
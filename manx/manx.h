@@ -9,15 +9,29 @@
 /**
  *  Bit-length of the underlying block cipher
  */
-#define BLOCKBITS  BLOCKBYTES*8
+#define BLOCKBITS  (BLOCKBYTES*8)
 /**
  *  τ refers to the authenticity security level (in bits)
  */
-#define MANX_TAU BLOCKBITS/2
+#define MANX_TAU (BLOCKBITS/2)
 /**
  *  Length of the padded AD in the Manx2 AEAD scheme.
  */
 #define MANX2_ALPHASTAR (MANX2_ALPHAMAX+MANX2_VARIABLE_ADLEN)
+/**
+ *  Whether the block cipher is bound at compile time, i.e. whether
+ *  block_cipher.h names inline definitions of the key expansion and block
+ *  encryption (MANX_STATIC_KEXPAND, MANX_STATIC_ENCRYPT) and optionally of the
+ *  block decryption (MANX_STATIC_DECRYPT). As `kexpand_inv` in manx_cipher,
+ *  MANX_STATIC_KEXPAND_INV (optional) derives the round keys MANX_STATIC_DECRYPT
+ *  relies on from the encryption ones; if undefined, it relies on the latter.
+ *  MANX_STATIC_ATTR (optional) gives the attributes required to inline them.
+ */
+#if MANX_STATIC_CIPHER && defined(MANX_STATIC_KEXPAND) && defined(MANX_STATIC_ENCRYPT)
+#define MANX_STATIC_BOUND 1
+#else
+#define MANX_STATIC_BOUND 0
+#endif
 
 
 /**
@@ -32,6 +46,81 @@ typedef void (enc_func)(uint8_t*, const uint8_t*, const roundkeys_t*);
  * Function type for the block decryption..
  */
 typedef void (dec_func)(uint8_t*, const uint8_t*, const roundkeys_t*);
+/**
+ * Function type for the derivation of the decryption round keys from the
+ * encryption ones (e.g. for the equivalent inverse cipher).
+ */
+typedef void (kinv_func)(roundkeys_t*, const roundkeys_t*);
+/**
+ * Function type for the encryption of several independent blocks stored
+ * contiguously, so that the underlying implementation can interleave them.
+ */
+typedef void (encn_func)(uint8_t*, const uint8_t*, size_t, const roundkeys_t*);
+/**
+ * Function type for the decryption of several independent blocks stored
+ * contiguously, so that the underlying implementation can interleave them.
+ */
+typedef void (decn_func)(uint8_t*, const uint8_t*, size_t, const roundkeys_t*);
+
+/**
+ * Block cipher functions used to instantiate a Manx context.
+ * `kexpand_inv` can be NULL if `decrypt` directly relies on the round keys
+ * returned by `kexpand`, and `decrypt` can be NULL for encryption-only ciphers.
+ * If `encrypt_blocks` (resp. `decrypt_blocks`) is NULL, independent blocks are
+ * processed one at a time through `encrypt` (resp. `decrypt`). `decrypt_blocks`
+ * relies on the same round keys as `decrypt`.
+ * `rkeys_size` is the number of bytes of round keys actually written by
+ * `kexpand` (and by `kexpand_inv`) when smaller than a `roundkeys_t` (e.g. for
+ * ciphers computing the round keys on the fly), a multiple of its alignment;
+ * 0 stands for sizeof(roundkeys_t).
+ */
+typedef struct {
+    kexp_func *kexpand;        // key expansion
+    kinv_func *kexpand_inv;    // decryption round keys derivation (optional)
+    enc_func  *encrypt;        // block encryption
+    dec_func  *decrypt;        // block decryption (optional)
+    encn_func *encrypt_blocks; // multi-block encryption (optional)
+    decn_func *decrypt_blocks; // multi-block decryption (optional)
+    const char *name;          // implementation name, for reporting (optional)
+    size_t     rkeys_size;     // bytes of round keys (optional, see above)
+} manx_cipher;
+
+/**
+ * Manx context holding the key material of a given key.
+ * The key expansion is computed once when initializing the context, while the
+ * decryption round keys (if any) are derived the first time the context is
+ * used for decryption (when MANX_CTX_LAZY_INV is set, otherwise along with the
+ * key expansion). Apart from this one-time derivation, which is thread-safe,
+ * the context is only read: it can be shared across threads.
+ * A context only takes manx_ctx_size(cipher) bytes out of sizeof(manx_ctx):
+ * for ciphers with a `rkeys_size`, the decryption round keys follow the
+ * encryption ones right after `rkeys_size` bytes (see manx_ctx_rkeys_inv), so
+ * that contexts can be allocated with this size (e.g. in arrays) instead.
+ */
+typedef struct {
+    const manx_cipher *cipher;    // underlying block cipher
+    int                inv_state; // state of the decryption round keys (see manx-ctx.c)
+    roundkeys_t        rkeys;     // round keys for encryption
+    roundkeys_t        rkeys_inv; // round keys for decryption (if kexpand_inv)
+} manx_ctx;
+
+/**
+ * Message descriptor for the batch functions.
+ * `out` must be large enough to hold the output of the corresponding
+ * single-message function, while `outlen` and `ret` are set by the batch
+ * function to the values the single-message function would have returned.
+ */
+typedef struct {
+    const uint8_t *n;      // nonce
+    size_t         nlen;   // nonce length (in bits)
+    const uint8_t *a;      // additional data
+    size_t         alen;   // additional data length (in bits)
+    const uint8_t *in;     // input message/ciphertext
+    size_t         inlen;  // input length (in bits)
+    uint8_t       *out;    // output ciphertext/plaintext
+    size_t         outlen; // output length (in bits)
+    int            ret;    // return code
+} manx_msg;
 
 
 /**
@@ -136,4 +225,675 @@ int manx2_dec(uint8_t p[], size_t *plen,
         enc_func  decrypt,
         kexp_func kexpand);
 
-#endif
\ No newline at end of file
+/**
+ * @brief Check the input lengths and build the Manx1 input blocks
+ * (V[1], V[2] || pad_{n-v2}(M)) as done by `manx1_enc` before any cipher call.
+ *
+ * See `manx1_enc` for the description of the other parameters.
+ *
+ * @param v The output 256-bit array (V[1], V[2] || pad_{n-v2}(M))
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+int manx1_init_blocks(uint8_t v[2*BLOCKBYTES],
+        const uint8_t n[], size_t nlen,
+        const uint8_t m[], size_t mlen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Variants of `manx1_init_blocks` formatting the blocks with byte-wise
+ * bit concatenations and with 64-bit word operations respectively. Both
+ * produce identical blocks, `manx1_init_blocks` relying on one or the other
+ * depending on `MANX1_WORD_FORMATTING` (see `manx-config.h`).
+ */
+int manx1_init_blocks_bytes(uint8_t v[2*BLOCKBYTES],
+        const uint8_t n[], size_t nlen,
+        const uint8_t m[], size_t mlen,
+        const uint8_t a[], size_t alen);
+int manx1_init_blocks_words(uint8_t v[2*BLOCKBYTES],
+        const uint8_t n[], size_t nlen,
+        const uint8_t m[], size_t mlen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Check the input lengths and build the Manx2 input block(s) as done
+ * by `manx2_enc` before any cipher call.
+ *
+ * See `manx2_enc` for the description of the other parameters.
+ *
+ * @param t The output input block(s) (should be at least 32-byte long)
+ * @param nblocks The number of input blocks (1 for tiny messages, 2 otherwise)
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+int manx2_init_blocks(uint8_t t[2*BLOCKBYTES], size_t *nblocks,
+        const uint8_t n[], size_t nlen,
+        const uint8_t m[], size_t mlen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Variants of `manx2_init_blocks` formatting the blocks with byte-wise
+ * bit concatenations and with 64-bit word operations respectively. Both
+ * produce identical blocks, `manx2_init_blocks` relying on one or the other
+ * depending on `MANX2_WORD_FORMATTING` (see `manx-config.h`).
+ */
+int manx2_init_blocks_bytes(uint8_t t[2*BLOCKBYTES], size_t *nblocks,
+        const uint8_t n[], size_t nlen,
+        const uint8_t m[], size_t mlen,
+        const uint8_t a[], size_t alen);
+int manx2_init_blocks_words(uint8_t t[2*BLOCKBYTES], size_t *nblocks,
+        const uint8_t n[], size_t nlen,
+        const uint8_t m[], size_t mlen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Number of bytes taken by a Manx context for a given block cipher,
+ * i.e. up to its round keys (and its decryption round keys if any) as given
+ * by `rkeys_size`, rounded up to the alignment of manx_ctx.
+ *
+ * @param cipher The functions of the underlying block cipher
+ *
+ * @return The size of the context, at most sizeof(manx_ctx)
+ */
+size_t manx_ctx_size(const manx_cipher *cipher);
+
+/**
+ * @brief Initialize a Manx context by expanding the key once and for all.
+ *
+ * @param ctx The context to initialize, of manx_ctx_size(cipher) bytes at least
+ * @param k The encryption key
+ * @param cipher The functions of the underlying block cipher
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+int manx_ctx_init(manx_ctx *ctx, const uint8_t k[], const manx_cipher *cipher);
+
+/**
+ * @brief Get the decryption round keys of a Manx context, deriving them from
+ * the encryption round keys the first time it is called. It is called by the
+ * decryption functions but can be called beforehand to take the derivation
+ * off the critical path of the first decryption. If MANX_CTX_LAZY_INV is 0
+ * (see manx-config.h), they are derived by `manx_ctx_init` instead.
+ *
+ * @param ctx The Manx context
+ *
+ * @return The round keys to be passed to the decryption function
+ */
+const roundkeys_t *manx_ctx_rkeys_inv(const manx_ctx *ctx);
+
+/**
+ * @brief Erase the key material held by a Manx context, i.e. its first
+ * manx_ctx_size(ctx->cipher) bytes (only the header if ctx->cipher is NULL,
+ * e.g. after a failed manx_ctx_init).
+ *
+ * @param ctx The context to wipe, passed to manx_ctx_init beforehand
+ */
+void manx_ctx_wipe(manx_ctx *ctx);
+
+#if MANX_PHASE_TIMERS
+/**
+ * Phases of the Manx1 and Manx2 functions timed when MANX_PHASE_TIMERS is set.
+ */
+typedef enum {
+    MANX_PHASE_KEXPAND,  // key expansion (manx1_enc, manx2_dec, ...)
+    MANX_PHASE_FORMAT,   // input blocks formatting (vencode, init_short_msg, ...)
+    MANX_PHASE_CIPHER,   // block cipher calls
+    MANX_PHASE_DOUBLING, // doubling (Manx1)
+    MANX_PHASE_XOR,      // xor_block (Manx1)
+    MANX_PHASE_VERIFY,   // tag verification and plaintext extraction (depad_10, sec_memcmp_bits, ...)
+    MANX_PHASE_COUNT
+} manx_phase;
+
+/**
+ * Cycles accumulated in each phase by the calling thread, and number of calls.
+ */
+typedef struct {
+    uint64_t cycles[MANX_PHASE_COUNT];
+    uint64_t calls;
+} manx_phase_stats;
+
+/**
+ * @brief Get (and optionally reset) the phase timers of the calling thread.
+ *
+ * @param stats The timers (can be NULL to only reset them)
+ * @param reset Whether the timers are reset once read
+ */
+void manx_phase_get(manx_phase_stats *stats, int reset);
+#endif
+
+/**
+ * @brief Authenticated encryption using Manx1 and a pre-initialized context.
+ *
+ * See `manx1_enc` for the description of the other parameters.
+ *
+ * @param ctx The Manx context
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+int manx1_ctx_enc(const manx_ctx *ctx,
+        uint8_t c[], size_t *clen,
+        const uint8_t n[], size_t nlen,
+        const uint8_t m[], size_t mlen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Authenticated encryption of several independent messages using Manx1.
+ * Up to MANX_BATCH messages are processed in lockstep so that their block
+ * cipher calls can be interleaved through `encrypt_blocks`. The outputs are
+ * the same as the ones of `manx1_ctx_enc` for each message.
+ *
+ * @param ctx The Manx context
+ * @param msgs The message descriptors
+ * @param count The number of messages
+ *
+ * @return The number of messages whose encryption failed (see `ret`)
+ */
+size_t manx1_enc_batch(const manx_ctx *ctx, manx_msg msgs[], size_t count);
+
+/**
+ * @brief Authenticated decryption of several independent ciphertexts using
+ * Manx1. Same as `manx1_enc_batch`, where `in` and `out` refer to the
+ * ciphertext and the plaintext respectively.
+ *
+ * @param ctx The Manx context
+ * @param msgs The message descriptors
+ * @param count The number of messages
+ *
+ * @return The number of messages whose decryption failed (see `ret`), `ret`
+ * being set to -1 for all messages if the cipher does not support decryption
+ */
+size_t manx1_dec_batch(const manx_ctx *ctx, manx_msg msgs[], size_t count);
+
+/**
+ * @brief Authenticated decryption using Manx1 and a pre-initialized context.
+ *
+ * See `manx1_dec` for the description of the other parameters.
+ *
+ * @param ctx The Manx context
+ *
+ * @return 0 if successfully executed, -1 if the cipher does not support
+ * decryption, error code otherwise
+ */
+int manx1_ctx_dec(const manx_ctx *ctx,
+        uint8_t p[], size_t *plen,
+        const uint8_t n[], size_t nlen,
+        const uint8_t c[], size_t clen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * Manx1 mask precomputed for a given nonce and AD: in Manx1, V[1] only
+ * depends on them, so that S = 2E_K(V[1]) can be computed before the message
+ * is known, leaving a single cipher call to the encryption itself.
+ * S must be kept as secret as the key, and a mask used only once.
+ */
+typedef struct {
+    uint8_t n[BLOCKBYTES];  // nonce
+    size_t  nlen;           // nonce length (in bits)
+    uint8_t s[BLOCKBYTES];  // S = 2E_K(V[1])
+    uint8_t v2[BLOCKBYTES]; // V[2] without pad_{n-v2}(M)
+} manx1_mask;
+
+/**
+ * Ring of Manx1 masks precomputed for consecutive counter nonces, the nonce
+ * being incremented as a big-endian integer of nlen bits (modulo 2^nlen), and
+ * a fixed AD. A ring is not thread-safe.
+ */
+typedef struct {
+    const manx_ctx *ctx;
+    manx1_mask     *masks;   // storage for size masks
+    size_t          size;
+    size_t          head;    // oldest mask ready
+    size_t          count;   // number of masks ready
+    uint8_t         next[BLOCKBYTES];  // nonce of the next mask to compute
+    size_t          nlen;
+    uint8_t         a[(MANX1_ALPHAMAX + 7)/8];
+    size_t          alen;
+} manx1_ring;
+
+/**
+ * @brief Offline part of Manx1 encryption: compute the mask of a nonce and AD.
+ *
+ * @param ctx The Manx context
+ * @param mask The output mask
+ *
+ * See `manx1_enc` for the description of the other parameters.
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+int manx1_precompute(const manx_ctx *ctx, manx1_mask *mask,
+        const uint8_t n[], size_t nlen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Online part of Manx1 encryption: same output as `manx1_ctx_enc` for
+ * the nonce and AD of a precomputed mask, with a single block cipher call.
+ *
+ * @param ctx The Manx context used to compute the mask
+ * @param mask The mask of the nonce and AD
+ *
+ * See `manx1_enc` for the description of the other parameters.
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+int manx1_enc_precomputed(const manx_ctx *ctx, const manx1_mask *mask,
+        uint8_t c[], size_t *clen,
+        const uint8_t m[], size_t mlen);
+
+/**
+ * @brief Initialize an empty ring of masks.
+ *
+ * @param ring The ring
+ * @param ctx The Manx context, which must outlive the ring
+ * @param masks The storage of the masks
+ * @param size The number of masks of the storage
+ * @param n The first nonce
+ * @param nlen The nonce length (in bits, non-zero)
+ * @param a The additional data of all the messages
+ * @param alen The additional data length (in bits)
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+int manx1_ring_init(manx1_ring *ring, const manx_ctx *ctx,
+        manx1_mask masks[], size_t size,
+        const uint8_t n[], size_t nlen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Precompute the masks of the next nonces (e.g. in idle time), their
+ * V[1] blocks being encrypted up to MANX_BATCH at a time.
+ *
+ * @param ring The ring
+ * @param max The maximal number of masks to compute (0 to fill the ring)
+ *
+ * @return The number of masks computed
+ */
+size_t manx1_ring_fill(manx1_ring *ring, size_t max);
+
+/**
+ * @brief Encrypt a message with the oldest mask of a ring, which is then
+ * wiped. If no mask is ready, the mask of the next nonce is computed first.
+ *
+ * @param ring The ring
+ * @param c The output ciphertext
+ * @param clen The length of the ciphertext
+ * @param n The nonce used (can be NULL)
+ * @param m The message to secure
+ * @param mlen The message length (in bits)
+ *
+ * @return 0 if successfully executed, error code otherwise (the mask being
+ * kept for the next message)
+ */
+int manx1_ring_enc(manx1_ring *ring,
+        uint8_t c[], size_t *clen, uint8_t n[],
+        const uint8_t m[], size_t mlen);
+
+/**
+ * @brief Wipe a ring and its masks.
+ */
+void manx1_ring_wipe(manx1_ring *ring);
+
+/**
+ * @brief Authenticated decryption using Manx1 and the precomputed mask of the
+ * nonce and AD (see `manx1_precompute`), with a single block cipher call.
+ * Same output as `manx1_ctx_dec` for the nonce and AD of the mask.
+ *
+ * @param ctx The Manx context used to compute the mask
+ * @param mask The mask of the nonce and AD
+ *
+ * See `manx1_dec` for the description of the other parameters.
+ *
+ * @return 0 if successfully executed, -1 if the cipher does not support
+ * decryption, error code otherwise
+ */
+int manx1_dec_precomputed(const manx_ctx *ctx, const manx1_mask *mask,
+        uint8_t p[], size_t *plen,
+        const uint8_t c[], size_t clen);
+
+/**
+ * Receiver-side window of Manx1 masks precomputed for the next expected
+ * counter nonces of a sender (with a fixed AD), the counter being made of the
+ * last min(nlen, 64) bits of the nonce. The mask of a counter is stored in
+ * the slot counter mod size, so that the masks of late frames are kept until
+ * the window moves past them. A window is not thread-safe: refilling it in the
+ * background (e.g. from another thread) must be serialized with decryption.
+ */
+typedef struct {
+    const manx_ctx *ctx;
+    manx1_mask     *masks;  // storage for size masks
+    size_t          size;   // power of 2
+    uint64_t        lo;     // counter following the last authentic frame
+    uint64_t        next;   // counter of the next mask to compute
+    uint8_t         next_n[BLOCKBYTES]; // nonce of the next mask to compute
+    size_t          nlen;
+    uint8_t         a[(MANX1_ALPHAMAX + 7)/8];
+    size_t          alen;
+    uint64_t        hits;   // frames decrypted with a precomputed mask
+    uint64_t        misses; // frames decrypted with manx1_ctx_dec
+} manx1_window;
+
+/**
+ * @brief Initialize an empty window of masks.
+ *
+ * @param win The window
+ * @param ctx The Manx context, which must outlive the window
+ * @param masks The storage of the masks
+ * @param size The number of masks of the storage (a power of 2, at most half
+ * of the counter values)
+ * @param n The first nonce expected
+ * @param nlen The nonce length (in bits, non-zero)
+ * @param a The additional data of all the frames
+ * @param alen The additional data length (in bits)
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+int manx1_window_init(manx1_window *win, const manx_ctx *ctx,
+        manx1_mask masks[], size_t size,
+        const uint8_t n[], size_t nlen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Precompute the masks of the next expected nonces (e.g. in idle
+ * time), up to size nonces after the last authentic frame.
+ *
+ * @param win The window
+ * @param max The maximal number of masks to compute (0 to fill the window)
+ *
+ * @return The number of masks computed
+ */
+size_t manx1_window_fill(manx1_window *win, size_t max);
+
+/**
+ * @brief Authenticated decryption using Manx1, with the precomputed mask of the
+ * nonce if it is in the window (hit), through `manx1_ctx_dec` otherwise (miss).
+ * An authentic frame ahead of the window moves it past its counter, the masks
+ * of the nonces it skipped being replaced as the window is refilled.
+ *
+ * @param win The window
+ *
+ * See `manx1_dec` for the description of the other parameters.
+ *
+ * @return 0 if successfully executed, -1 if the cipher does not support
+ * decryption, error code otherwise
+ */
+int manx1_window_dec(manx1_window *win,
+        uint8_t p[], size_t *plen,
+        const uint8_t n[], size_t nlen,
+        const uint8_t c[], size_t clen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Wipe a window and its masks.
+ */
+void manx1_window_wipe(manx1_window *win);
+
+/**
+ * Manx1 encryption stream for consecutive counter nonces (incremented as
+ * big-endian integers of nlen bits, modulo 2^nlen) and a fixed AD. V[1] and
+ * V[2] are encoded once as 128-bit templates (w[0] holding the first 64 bits):
+ * the nonce being the first field of V[1], its increment is a 128-bit
+ * addition to the template, and the message is inserted into a copy of the V[2]
+ * template with a few shifts, instead of encoding the whole blocks bit by bit.
+ * A stream is not thread-safe.
+ */
+typedef struct {
+    const manx_ctx *ctx;
+    uint64_t        v1[2];   // N || beginning of \bar{A}, N being the next nonce
+    uint64_t        v2[2];   // V[2] without pad_{n-v2}(M)
+    uint64_t        inc[2];  // increment of the nonce field of V[1]
+    size_t          nlen;
+    size_t          v2len;   // offset of the message within V[2]
+} manx1_stream;
+
+/**
+ * @brief Initialize a Manx1 encryption stream.
+ *
+ * @param st The stream
+ * @param ctx The Manx context, which must outlive the stream
+ * @param n The first nonce
+ * @param nlen The nonce length (in bits, non-zero and at most BLOCKBITS)
+ * @param a The additional data of all the messages
+ * @param alen The additional data length (in bits)
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+int manx1_stream_init(manx1_stream *st, const manx_ctx *ctx,
+        const uint8_t n[], size_t nlen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Encrypt a message with the next nonce of a stream, then increment
+ * it. Same output as `manx1_ctx_enc` for this nonce and the AD of the stream.
+ *
+ * @param st The stream
+ * @param c The output ciphertext
+ * @param clen The length of the ciphertext
+ * @param n The nonce used (can be NULL)
+ * @param m The message to secure
+ * @param mlen The message length (in bits)
+ *
+ * @return 0 if successfully executed, error code otherwise (the nonce being
+ * kept for the next message)
+ */
+int manx1_stream_enc(manx1_stream *st,
+        uint8_t c[], size_t *clen, uint8_t n[],
+        const uint8_t m[], size_t mlen);
+
+/**
+ * @brief Wipe a Manx1 encryption stream.
+ */
+void manx1_stream_wipe(manx1_stream *st);
+
+/**
+ * @brief Authenticated encryption using Manx2 and a pre-initialized context.
+ *
+ * See `manx2_enc` for the description of the other parameters.
+ *
+ * @param ctx The Manx context
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+int manx2_ctx_enc(const manx_ctx *ctx,
+        uint8_t c[], size_t *clen,
+        const uint8_t n[], size_t nlen,
+        const uint8_t m[], size_t mlen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Authenticated encryption of several independent messages using Manx2.
+ * Same as `manx1_enc_batch`, up to 2*MANX_BATCH blocks being passed at once to
+ * `encrypt_blocks`. The outputs are the same as the ones of `manx2_ctx_enc`.
+ *
+ * @param ctx The Manx context
+ * @param msgs The message descriptors
+ * @param count The number of messages
+ *
+ * @return The number of messages whose encryption failed (see `ret`)
+ */
+size_t manx2_enc_batch(const manx_ctx *ctx, manx_msg msgs[], size_t count);
+
+/**
+ * @brief Authenticated decryption of several independent ciphertexts using
+ * Manx2. Same as `manx2_enc_batch`, where `in` and `out` refer to the
+ * ciphertext and the plaintext respectively.
+ *
+ * @param ctx The Manx context
+ * @param msgs The message descriptors
+ * @param count The number of messages
+ *
+ * @return The number of messages whose decryption failed (see `ret`), `ret`
+ * being set to -1 for all messages if the cipher does not support decryption
+ */
+size_t manx2_dec_batch(const manx_ctx *ctx, manx_msg msgs[], size_t count);
+
+/**
+ * @brief Authenticated decryption using Manx2 and a pre-initialized context.
+ *
+ * See `manx2_dec` for the description of the other parameters.
+ *
+ * @param ctx The Manx context
+ *
+ * @return 0 if successfully executed, -1 if the cipher does not support
+ * decryption, error code otherwise
+ */
+int manx2_ctx_dec(const manx_ctx *ctx,
+        uint8_t p[], size_t *plen,
+        const uint8_t n[], size_t nlen,
+        const uint8_t c[], size_t clen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * Pre-encoded header of Manx2 blocks for a nonce length and an AD: in the
+ * first block of a ciphertext, the nonce and the domain separator are followed
+ * by \bar{A}, which only depends on them.
+ */
+typedef struct {
+    size_t   nlen;      // nonce length (in bits), 0 for an empty entry
+    size_t   alen;
+    uint8_t  a[(MANX2_ALPHAMAX + 7)/8];
+    uint64_t abar[2];   // \bar{A} from bit nlen + 2 (w[0] holding the first 64 bits)
+    uint64_t hmask[2];  // mask of the nlen + 2 + α* bits of the header
+} manx2_ad_entry;
+
+/**
+ * Cache of pre-encoded headers for Manx2 decryption, when the ciphertexts
+ * only rely on a few ADs (e.g. message type tags): the header of a decrypted
+ * block is then verified with a masked 128-bit comparison, instead of being
+ * encoded from the AD on every call. The AD of an authentic ciphertext is
+ * cached on a miss, replacing the entries in round-robin order once the cache
+ * is full. A cache is not thread-safe.
+ */
+typedef struct {
+    manx2_ad_entry *entries; // storage for size entries
+    size_t          size;
+    size_t          next;    // next entry to replace
+    uint64_t        hits;    // calls whose header was found in the cache
+    uint64_t        misses;
+} manx2_ad_cache;
+
+/**
+ * @brief Initialize an empty cache of pre-encoded headers.
+ *
+ * @param cache The cache
+ * @param entries The storage of the entries
+ * @param size The number of entries of the storage
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+int manx2_ad_cache_init(manx2_ad_cache *cache, manx2_ad_entry entries[], size_t size);
+
+/**
+ * @brief Authenticated decryption using Manx2, a pre-initialized context and
+ * a cache of pre-encoded headers. Same output as `manx2_ctx_dec`.
+ *
+ * @param ctx The Manx context
+ * @param cache The cache of headers, updated (with its counters) accordingly
+ *
+ * See `manx2_dec` for the description of the other parameters.
+ *
+ * @return 0 if successfully executed, -1 if the cipher does not support
+ * decryption, error code otherwise
+ */
+int manx2_ctx_dec_cached(const manx_ctx *ctx, manx2_ad_cache *cache,
+        uint8_t p[], size_t *plen,
+        const uint8_t n[], size_t nlen,
+        const uint8_t c[], size_t clen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Wipe a cache of pre-encoded headers and its entries.
+ */
+void manx2_ad_cache_wipe(manx2_ad_cache *cache);
+
+/**
+ * Manx2 encryption stream for consecutive counter nonces and a fixed AD, as
+ * `manx1_stream`: the blocks N || xx || \bar{A} || M[1] and N || 01 || M[2]
+ * are encoded once as 128-bit templates whose nonce fields are incremented in
+ * place, the domain separator and the message being inserted into copies of
+ * them. A stream is not thread-safe.
+ */
+typedef struct {
+    const manx_ctx *ctx;
+    uint64_t        t1[2];   // N || 00 || \bar{A}, N being the next nonce
+    uint64_t        t2[2];   // N || 01
+    uint64_t        inc[2];  // increment of the nonce fields
+    uint64_t        ds10[2]; // domain separators 10 and 11 within t1
+    uint64_t        ds11[2];
+    size_t          nlen;
+} manx2_stream;
+
+/**
+ * @brief Initialize a Manx2 encryption stream.
+ *
+ * @param st The stream
+ * @param ctx The Manx context, which must outlive the stream
+ * @param n The first nonce
+ * @param nlen The nonce length (in bits)
+ * @param a The additional data of all the messages
+ * @param alen The additional data length (in bits)
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+int manx2_stream_init(manx2_stream *st, const manx_ctx *ctx,
+        const uint8_t n[], size_t nlen,
+        const uint8_t a[], size_t alen);
+
+/**
+ * @brief Encrypt a message with the next nonce of a stream, then increment
+ * it. Same output as `manx2_ctx_enc` for this nonce and the AD of the stream.
+ *
+ * @param st The stream
+ * @param c The output ciphertext
+ * @param clen The length of the ciphertext
+ * @param n The nonce used (can be NULL)
+ * @param m The message to secure
+ * @param mlen The message length (in bits)
+ *
+ * @return 0 if successfully executed, error code otherwise (the nonce being
+ * kept for the next message)
+ */
+int manx2_stream_enc(manx2_stream *st,
+        uint8_t c[], size_t *clen, uint8_t n[],
+        const uint8_t m[], size_t mlen);
+
+/**
+ * @brief Wipe a Manx2 encryption stream.
+ */
+void manx2_stream_wipe(manx2_stream *st);
+
+#if MANX_STATIC_BOUND
+/**
+ * @brief Same as `manx1_enc`, `manx1_dec`, `manx2_enc` and `manx2_dec`
+ * respectively, with the block cipher bound at compile time by block_cipher.h
+ * instead of being passed as function pointers. The calls to the block cipher
+ * are inlined, so that the round keys can stay in registers. The decryption
+ * functions are only available if `MANX_STATIC_DECRYPT` is defined.
+ *
+ * See `manx1_enc` for the description of the parameters.
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+int manx1_static_enc(uint8_t c[], size_t *clen,
+        const uint8_t k[],
+        const uint8_t n[], size_t nlen,
+        const uint8_t m[], size_t mlen,
+        const uint8_t a[], size_t alen);
+int manx2_static_enc(uint8_t c[], size_t *clen,
+        const uint8_t k[],
+        const uint8_t n[], size_t nlen,
+        const uint8_t m[], size_t mlen,
+        const uint8_t a[], size_t alen);
+#ifdef MANX_STATIC_DECRYPT
+int manx1_static_dec(uint8_t p[], size_t *plen,
+        const uint8_t k[],
+        const uint8_t n[], size_t nlen,
+        const uint8_t c[], size_t clen,
+        const uint8_t a[], size_t alen);
+int manx2_static_dec(uint8_t p[], size_t *plen,
+        const uint8_t k[],
+        const uint8_t n[], size_t nlen,
+        const uint8_t c[], size_t clen,
+        const uint8_t a[], size_t alen);
+#endif
+#endif
+
+#endif
@@ -25,242 +25,991 @@
 #include "manx-common.h"
 
 /**
- * @brief Translate 4 bytes into a 32-bit word (little-endian encoding).
+ * @brief Build (V[1],V[2]) <- vencode(N,A).
  *
- * @param a The input array
- * 
- * @return The corresponding 32-bit word
+ * @param v The output 256-bit array (V[1],V[2])
+ * @param oct The byte position within v after vencode
+ * @param bit The bit position within oct after vencode
+ * @param n The nonce
+ * @param nlen The nonce length (in bits)
+ * @param a The additional data
+ * @param alen The additional data length (in bits)
  */
-static inline uint32_t GET_LE32(const uint8_t *a)
+static inline void vencode(uint8_t v[2*BLOCKBYTES],
+            size_t *oct, size_t *bit,
+            const uint8_t n[], size_t nlen,
+            const uint8_t a[], size_t alen)
 {
-    return ((uint32_t)a[3] << 24) | ((uint32_t)a[2] << 16) | ((uint32_t)a[1] << 8) | (uint32_t)a[0];
+    size_t s = MAX(BLOCKBITS - nlen + MANX_TAU, MANX1_ALPHAMAX);
+
+    for (size_t i = 0; i < 2*BLOCKBYTES; i++)
+        v[i] = 0x00;
+    *oct = 0; // current byte position in b is set to 0
+    *bit = 0; // current bit position in oct is set to 0
+    concat_bits(v, oct, bit, n, nlen);
+    concat_bits(v, oct, bit, a, alen);
+#if MANX1_VARIABLE_ADLEN
+    // one-zero padding to build \bar{A} from A
+    SETBIT(v[*oct], 7-*bit);
+    inc_bitpos(oct, bit, s - alen);
+#else
+    (void)s;
+#endif
 }
 
 /**
- * @brief Translate a 32-bit word into 4 bytes (little-endian encoding).
+ * @brief Check the input lengths for Manx1 encryption.
  *
- * @param a The output byte array
- * @param val The input 32-bit word
+ * @return 0 if the lengths are valid, error code otherwise
  */
-static inline void PUT_LE32(uint8_t *a, uint32_t val)
+static inline int manx1_check_lengths(size_t nlen, size_t mlen, size_t alen)
 {
-    a[3] = (val >> 24) & 0xff;
-    a[2] = (val >> 16) & 0xff;
-    a[1] = (val >>  8) & 0xff;
-    a[0] = (val >>  0) & 0xff;
-}
+    size_t s = MAX(BLOCKBITS - nlen + MANX_TAU, MANX1_ALPHAMAX);
 
-/**
- * @brief Multiplication by x over GF(2^128) (i.e. doubling) using the
- * irreducible polynomial x^128 + x^7 + x^2 + x + 1.
- * Shift the 128-bit polynomial by 1 bit to the right, and add
- * 0...010000111 (= 0x87) if its MSB equals 1.
- *
- * @param poly Input/output 128-bit polynomial
- */
-static inline void doubling(uint8_t *poly)
-{
-    uint32_t val;
-    uint8_t cond = 0x00 - ((poly[15] & 0x80) >> 7);
-    // 1st 32-bit word to shift
-    val = GET_LE32(poly + 12);
-    val <<= 1;
-    val |= (poly[11] & 0x80) >> 7;
-    PUT_LE32(poly + 12, val);
-    // 2nd 32-bit word to shift
-    val = GET_LE32(poly + 8);
-    val <<= 1;
-    val |= (poly[7] & 0x80) >> 7;
-    PUT_LE32(poly + 8, val);
-    // 3rd 32-bit word to shift
-    val = GET_LE32(poly + 4);
-    val <<= 1;
-    val |= (poly[3] & 0x80) >> 7;
-    PUT_LE32(poly + 4, val);
-    // 4th 32-bit word to shift
-    val = GET_LE32(poly);
-    val <<= 1;
-    val |= ((poly[3] & 0x80) >> 7);
-    PUT_LE32(poly, val);
-    // Add 0x87 if and only if MSB is set to 1
-    poly[0] ^= 0x87 & cond;
+    // ensure that |M| < n − τ
+    if (mlen >= BLOCKBITS - MANX_TAU)
+        return 1;
+    // ensure that [AD| < α_max
+    if (alen > MANX1_ALPHAMAX)
+        return 2;
+    // ensure that |M| < n - |V[2]|
+    if (mlen >= BLOCKBITS - (s - (BLOCKBITS - nlen)))
+        return 3;
+    return 0;
 }
 
 /**
- * @brief Exclusive-OR between two 128-bit blocks.
+ * @brief Append vencode(N,A) to a bit string (i.e. the beginning of (V[1],V[2])).
  *
- * @param dst First operand and output
- * @param src Second operand
+ * @param b The bit string
+ * @param n The nonce
+ * @param nlen The nonce length (in bits)
+ * @param a The additional data
+ * @param alen The additional data length (in bits)
+ * @param msg Whether pad_{n-v2}(M) is appended afterwards
  */
-static inline void xor_block(uint8_t *dst, const uint8_t *src1, const uint8_t *src2)
+static inline void vencode_words(bitbuf64_t *b,
+            const uint8_t n[], size_t nlen,
+            const uint8_t a[], size_t alen,
+            int msg)
 {
-    uint32_t *d  = (uint32_t *) dst;
-    uint32_t *s1 = (uint32_t *) src1;
-    uint32_t *s2 = (uint32_t *) src2;
-    *d++ = *s1++ ^ *s2++;
-    *d++ = *s1++ ^ *s2++;
-    *d++ = *s1++ ^ *s2++;
-    *d++ = *s1++ ^ *s2++;
+    size_t s = MAX(BLOCKBITS - nlen + MANX_TAU, MANX1_ALPHAMAX);
+
+    bitbuf64_concat(b, n, 0, nlen);
+    bitbuf64_concat(b, a, 0, alen);
+#if MANX1_VARIABLE_ADLEN
+    // one-zero padding to build \bar{A} from A
+    // (if |A| = s, the padding bit is overwritten by pad_{n-v2}(M))
+    if (alen < s || !msg) {
+        bitbuf64_put(b, (uint64_t)1 << 63, 1);
+        alen++;
+    }
+    if (alen < s)
+        bitbuf64_skip(b, s - alen);
+#else
+    (void)s;
+    (void)msg;
+#endif
 }
 
-int manx1_enc(uint8_t c[], size_t *clen,
-            const uint8_t k[],
+int manx1_init_blocks_bytes(uint8_t v[2*BLOCKBYTES],
             const uint8_t n[], size_t nlen,
             const uint8_t m[], size_t mlen,
-            const uint8_t a[], size_t alen,
-            enc_func  enc,
-            kexp_func kexpand)
+            const uint8_t a[], size_t alen)
 {
     size_t  oct;
     size_t  bit;
-    uint8_t v[2*BLOCKBYTES];
-    uint8_t *v1 = v;
-    uint8_t *v2 = v + BLOCKBYTES;
-    size_t  s   = MAX(BLOCKBITS - nlen + MANX_TAU, MANX1_ALPHAMAX);
-
-    roundkeys_t roundkeys;
-    if (kexpand != NULL)
-        kexpand(&roundkeys, k);
+    int     ret;
 
-    // ensure that |M| < n − τ
-    if (mlen >= BLOCKBITS - MANX_TAU) {
-        *clen = 0;
-        return 1;
-    }
-    // ensure that [AD| < α_max
-    if (alen > MANX1_ALPHAMAX) {
-        *clen = 0;
-        return 2;
-    }
-    // ensure that |M| < n - |V[2]|
-    if (mlen >= BLOCKBITS - (s - (BLOCKBITS - nlen))) {
-        *clen = 0;
-        return 3;
-    }
+    if ((ret = manx1_check_lengths(nlen, mlen, alen)))
+        return ret;
 
     // build (V[1],V[2]) <- vencode(N,A)
-    for (size_t i = 0; i < 2*BLOCKBYTES; i++)
-        v[i] = 0x00;
-    oct = 0; // current byte position in b is set to 0
-    bit = 0; // current bit position in oct is set to 0
-    concat_bits(v, &oct, &bit, n, nlen);
-    concat_bits(v, &oct, &bit, a, alen);
-#if MANX1_VARIABLE_ADLEN
-    // one-zero padding to build \bar{A} from A
-    SETBIT(v[oct], 7-bit);
-    inc_bitpos(&oct, &bit, s - alen);
-#endif
+    vencode(v, &oct, &bit, n, nlen, a, alen);
 
     // append pad_{n-v2}(M) to (V[1],V[2])
     concat_bits(v, &oct, &bit, m, mlen);
     SETBIT(v[oct], 7-bit);
 
+    return 0;
+}
+
+int manx1_init_blocks_words(uint8_t v[2*BLOCKBYTES],
+            const uint8_t n[], size_t nlen,
+            const uint8_t m[], size_t mlen,
+            const uint8_t a[], size_t alen)
+{
+    bitbuf64_t b;
+    int        ret;
+
+    if ((ret = manx1_check_lengths(nlen, mlen, alen)))
+        return ret;
+
+    bitbuf64_init(&b, v);
+
+    // build (V[1],V[2]) <- vencode(N,A)
+    vencode_words(&b, n, nlen, a, alen, 1);
+
+    // append pad_{n-v2}(M) to (V[1],V[2])
+    bitbuf64_concat(&b, m, 0, mlen);
+    bitbuf64_put(&b, (uint64_t)1 << 63, 1);
+    bitbuf64_flush(&b, v + 2*BLOCKBYTES);
+
+    return 0;
+}
+
+int manx1_init_blocks(uint8_t v[2*BLOCKBYTES],
+            const uint8_t n[], size_t nlen,
+            const uint8_t m[], size_t mlen,
+            const uint8_t a[], size_t alen)
+{
+#if MANX1_WORD_FORMATTING
+    return manx1_init_blocks_words(v, n, nlen, m, mlen, a, alen);
+#else
+    return manx1_init_blocks_bytes(v, n, nlen, m, mlen, a, alen);
+#endif
+}
+
+/**
+ * @brief Manx1 encryption core, relying on pre-computed round keys.
+ */
+MANX_ALWAYS_INLINE int manx1_enc_rk(uint8_t c[], size_t *clen,
+            const roundkeys_t *rkeys,
+            const uint8_t n[], size_t nlen,
+            const uint8_t m[], size_t mlen,
+            const uint8_t a[], size_t alen,
+            enc_func enc)
+{
+    int     ret;
+    uint8_t v[2*BLOCKBYTES];
+    uint8_t *v1 = v;
+    uint8_t *v2 = v + BLOCKBYTES;
+    MANX_PHASE_BEGIN();
+
+    MANX_PHASE_CALL();
+    ret = manx1_init_blocks(v, n, nlen, m, mlen, a, alen);
+    MANX_PHASE(MANX_PHASE_FORMAT);
+    if (ret) {
+        *clen = 0;
+        return ret;
+    }
+
     // V[1] <- E_K(V[1])
-    if (kexpand != NULL)
-        enc(v1, v1, &roundkeys);
-    else
-        enc(v1, v1, (roundkeys_t*)k);
+    enc(v1, v1, rkeys);
+    MANX_PHASE(MANX_PHASE_CIPHER);
 
     // V[1] <- 2V[1]
     doubling(v1);
+    MANX_PHASE(MANX_PHASE_DOUBLING);
 
     // V[2] <- V[1] ^ (V[2] || pad_{n-v2}(M))
     xor_block(v2, v2, v1);
+    MANX_PHASE(MANX_PHASE_XOR);
 
     // C <- E_K(V[2])
-    if (kexpand != NULL)
-        enc(c, v2, &roundkeys);
-    else
-        enc(c, v2, (roundkeys_t*)k);
+    enc(c, v2, rkeys);
+    MANX_PHASE(MANX_PHASE_CIPHER);
 
     // C <- C ^ V[1]
     xor_block(c, c, v1);  
+    MANX_PHASE(MANX_PHASE_XOR);
 
     *clen = BLOCKBITS;
     return 0;
 }
 
-int manx1_dec(uint8_t p[], size_t *plen,
-            const uint8_t k[],
+/**
+ * @brief Check the input lengths and build (V[1],V[2]) <- vencode(N,A) before
+ * any cipher call for decryption.
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+static int manx1_dec_init(uint8_t v[2*BLOCKBYTES],
+            const uint8_t n[], size_t nlen,
+            size_t clen,
+            const uint8_t a[], size_t alen)
+{
+    // ensure that the |C| = n
+    if (clen != BLOCKBITS)
+        return 1;
+    // ensure that |AD| < α_max
+    if (alen > MANX1_ALPHAMAX)
+        return 2;
+
+    // build (V[1],V[2]) <- vencode(N,A)
+#if MANX1_WORD_FORMATTING
+    bitbuf64_t b;
+
+    bitbuf64_init(&b, v);
+    vencode_words(&b, n, nlen, a, alen, 0);
+    bitbuf64_flush(&b, v + 2*BLOCKBYTES);
+#else
+    size_t oct;
+    size_t bit;
+
+    vencode(v, &oct, &bit, n, nlen, a, alen);
+#endif
+
+    return 0;
+}
+
+/**
+ * @brief Verify \tilde{V[2]} and extract the plaintext from it once all the
+ * cipher calls have been carried out.
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+static int manx1_dec_final(uint8_t p[], size_t *plen,
+            const uint8_t v2[], uint8_t v2_tilde[],
+            size_t nlen)
+{
+    size_t   s     = MAX(BLOCKBITS - nlen + MANX_TAU, MANX1_ALPHAMAX) ;
+    size_t   v2len = s - (BLOCKBITS - nlen);
+    size_t   padlen;
+    uint64_t w[2];
+    int      ret;
+
+    // locate the padding bit, which must follow the first v2len bits
+    load_block64(w, v2_tilde);
+    ret  = depad_10(w, &padlen);
+    ret |= (padlen < v2len);
+    // ensure v2 = \tilde{v2}
+    ret |= sec_memcmp_bits(v2, v2_tilde, v2len);
+    if (ret) {
+        *plen = 0;
+        return 3;
+    }
+
+    // move the plaintext to offset 0
+    *plen = padlen - v2len;
+    shl128(w, v2len);
+    store_bits128(p, w, *plen);
+
+    return 0;
+}
+
+/**
+ * @brief Manx1 decryption core, relying on pre-computed round keys.
+ */
+MANX_ALWAYS_INLINE int manx1_dec_rk(uint8_t p[], size_t *plen,
+            const roundkeys_t *rkeys,
+            const roundkeys_t *rkeys_inv,
             const uint8_t n[], size_t nlen,
             const uint8_t c[], size_t clen,
             const uint8_t a[], size_t alen,
             enc_func enc,
-            dec_func dec,
-            kexp_func kexpand)
+            dec_func dec)
 {
-    size_t  oct;
-    size_t  bit;
-    size_t  v2len;
-    size_t  s;
+    int     ret;
     uint8_t v2_tilde[BLOCKBYTES]  = {0x00};
     uint8_t v[2*BLOCKBYTES];
     uint8_t *v1 = v;
     uint8_t *v2 = v + BLOCKBYTES;
+    MANX_PHASE_BEGIN();
 
-    roundkeys_t roundkeys;
-    if (kexpand != NULL)
-        kexpand(&roundkeys, k);
-
-    s     = MAX(BLOCKBITS - nlen + MANX_TAU, MANX1_ALPHAMAX) ;
-    v2len = s - (BLOCKBITS - nlen);
-
-    // ensure that the |C| = n
-    if (clen != BLOCKBITS){
-        *plen = 0;
-        return 1;
-    }
-    // ensure that |AD| < α_max
-    if (alen > MANX1_ALPHAMAX){
+    MANX_PHASE_CALL();
+    ret = manx1_dec_init(v, n, nlen, clen, a, alen);
+    MANX_PHASE(MANX_PHASE_FORMAT);
+    if (ret) {
         *plen = 0;
-        return 2;
+        return ret;
     }
 
-    // build (V[1],V[2]) <- vencode(N,A)
-    for (size_t i = 0; i < 2*BLOCKBYTES; i++)
-        v[i] = 0x00;
-    oct = 0; // current byte position in b is set to 0
-    bit = 0; // current bit position in oct is set to 0
-    concat_bits(v, &oct, &bit, n, nlen);
-    concat_bits(v, &oct, &bit, a, alen);
-#if MANX1_VARIABLE_ADLEN
-    // one-zero padding to build \bar{A} from A
-    SETBIT(v[oct], 7-bit);
-    inc_bitpos(&oct, &bit, s - alen);
-#endif
-
     // S <- E_K(V[1])
-    if (kexpand != NULL)
-        enc(v1, v1, &roundkeys);
-    else
-        enc(v1, v1, (roundkeys_t*)k);
+    enc(v1, v1, rkeys);
+    MANX_PHASE(MANX_PHASE_CIPHER);
 
     // S <- 2S
     doubling(v1);
+    MANX_PHASE(MANX_PHASE_DOUBLING);
 
     // \tilde{v2} <- S ^ C
     xor_block(v2_tilde, v1, c);
+    MANX_PHASE(MANX_PHASE_XOR);
 
     // \tilde{v2} <- E_K^{-1}(S ^ C)
-    if (kexpand != NULL)
-        dec(v2_tilde, v2_tilde, &roundkeys);
-    else
-        dec(v2_tilde, v2_tilde, (roundkeys_t*)k);
-
+    dec(v2_tilde, v2_tilde, rkeys_inv);
+    MANX_PHASE(MANX_PHASE_CIPHER);
 
     // \tilde{v2} <- E_K^{-1}(S ^ C) ^ S
     xor_block(v2_tilde, v2_tilde, v1);
+    MANX_PHASE(MANX_PHASE_XOR);
 
-    // ensure v2 = \tilde{v2}
-    if (sec_memcmp_bits(v2, v2_tilde, v2len)) {
+    ret = manx1_dec_final(p, plen, v2, v2_tilde, nlen);
+    MANX_PHASE(MANX_PHASE_VERIFY);
+    return ret;
+}
+
+int manx1_enc(uint8_t c[], size_t *clen,
+            const uint8_t k[],
+            const uint8_t n[], size_t nlen,
+            const uint8_t m[], size_t mlen,
+            const uint8_t a[], size_t alen,
+            enc_func  enc,
+            kexp_func kexpand)
+{
+    roundkeys_t roundkeys;
+    const roundkeys_t *rkeys = (const roundkeys_t*)k;
+    MANX_PHASE_BEGIN();
+    if (kexpand != NULL) {
+        kexpand(&roundkeys, k);
+        rkeys = &roundkeys;
+    }
+    MANX_PHASE(MANX_PHASE_KEXPAND);
+
+    return manx1_enc_rk(c, clen, rkeys, n, nlen, m, mlen, a, alen, enc);
+}
+
+int manx1_dec(uint8_t p[], size_t *plen,
+            const uint8_t k[],
+            const uint8_t n[], size_t nlen,
+            const uint8_t c[], size_t clen,
+            const uint8_t a[], size_t alen,
+            enc_func enc,
+            dec_func dec,
+            kexp_func kexpand)
+{
+    roundkeys_t roundkeys;
+    const roundkeys_t *rkeys = (const roundkeys_t*)k;
+    MANX_PHASE_BEGIN();
+    if (kexpand != NULL) {
+        kexpand(&roundkeys, k);
+        rkeys = &roundkeys;
+    }
+    MANX_PHASE(MANX_PHASE_KEXPAND);
+
+    return manx1_dec_rk(p, plen, rkeys, rkeys, n, nlen, c, clen, a, alen, enc, dec);
+}
+
+int manx1_ctx_enc(const manx_ctx *ctx,
+            uint8_t c[], size_t *clen,
+            const uint8_t n[], size_t nlen,
+            const uint8_t m[], size_t mlen,
+            const uint8_t a[], size_t alen)
+{
+    return manx1_enc_rk(c, clen, &ctx->rkeys, n, nlen, m, mlen, a, alen,
+                        ctx->cipher->encrypt);
+}
+
+size_t manx1_enc_batch(const manx_ctx *ctx, manx_msg msgs[], size_t count)
+{
+    uint8_t v1[MANX_BATCH*BLOCKBYTES];
+    uint8_t v2[MANX_BATCH*BLOCKBYTES];
+    uint8_t v[2*BLOCKBYTES];
+    size_t  idx[MANX_BATCH];
+    size_t  failed = 0;
+    size_t  i      = 0;
+
+    while (i < count) {
+        size_t lanes = 0;
+
+        // gather up to MANX_BATCH valid messages
+        for (; i < count && lanes < MANX_BATCH; i++) {
+            manx_msg *msg = &msgs[i];
+            msg->ret = manx1_init_blocks(v, msg->n, msg->nlen, msg->in,
+                                         msg->inlen, msg->a, msg->alen);
+            if (msg->ret) {
+                msg->outlen = 0;
+                failed++;
+                continue;
+            }
+            for (size_t j = 0; j < BLOCKBYTES; j++) {
+                v1[lanes*BLOCKBYTES + j] = v[j];
+                v2[lanes*BLOCKBYTES + j] = v[BLOCKBYTES + j];
+            }
+            idx[lanes++] = i;
+        }
+        if (lanes == 0)
+            break;
+
+        // V[1] <- E_K(V[1]) for all messages
+        ctx_encrypt_blocks(ctx, v1, v1, lanes);
+
+        // V[1] <- 2V[1] and V[2] <- V[1] ^ (V[2] || pad_{n-v2}(M))
+        for (size_t l = 0; l < lanes; l++) {
+            doubling(v1 + l*BLOCKBYTES);
+            xor_block(v2 + l*BLOCKBYTES, v2 + l*BLOCKBYTES, v1 + l*BLOCKBYTES);
+        }
+
+        // C <- E_K(V[2]) for all messages
+        ctx_encrypt_blocks(ctx, v2, v2, lanes);
+
+        // C <- C ^ V[1]
+        for (size_t l = 0; l < lanes; l++) {
+            manx_msg *msg = &msgs[idx[l]];
+            xor_block(msg->out, v2 + l*BLOCKBYTES, v1 + l*BLOCKBYTES);
+            msg->outlen = BLOCKBITS;
+        }
+    }
+
+    return failed;
+}
+
+size_t manx1_dec_batch(const manx_ctx *ctx, manx_msg msgs[], size_t count)
+{
+    uint8_t v[MANX_BATCH][2*BLOCKBYTES];
+    uint8_t s[MANX_BATCH*BLOCKBYTES];
+    uint8_t v2_tilde[MANX_BATCH*BLOCKBYTES];
+    size_t  idx[MANX_BATCH];
+    size_t  failed = 0;
+    size_t  i      = 0;
+
+    if (ctx->cipher->decrypt == NULL) {
+        for (i = 0; i < count; i++) {
+            msgs[i].outlen = 0;
+            msgs[i].ret    = -1;
+        }
+        return count;
+    }
+
+    while (i < count) {
+        size_t lanes = 0;
+
+        // gather up to MANX_BATCH valid messages
+        for (; i < count && lanes < MANX_BATCH; i++) {
+            manx_msg *msg = &msgs[i];
+            msg->ret = manx1_dec_init(v[lanes], msg->n, msg->nlen,
+                                      msg->inlen, msg->a, msg->alen);
+            if (msg->ret) {
+                msg->outlen = 0;
+                failed++;
+                continue;
+            }
+            for (size_t j = 0; j < BLOCKBYTES; j++)
+                s[lanes*BLOCKBYTES + j] = v[lanes][j];
+            idx[lanes++] = i;
+        }
+        if (lanes == 0)
+            break;
+
+        // S <- E_K(V[1]) for all messages
+        ctx_encrypt_blocks(ctx, s, s, lanes);
+
+        // S <- 2S and \tilde{v2} <- S ^ C
+        for (size_t l = 0; l < lanes; l++) {
+            doubling(s + l*BLOCKBYTES);
+            xor_block(v2_tilde + l*BLOCKBYTES, s + l*BLOCKBYTES, msgs[idx[l]].in);
+        }
+
+        // \tilde{v2} <- E_K^{-1}(S ^ C) for all messages
+        ctx_decrypt_blocks(ctx, v2_tilde, v2_tilde, lanes);
+
+        // \tilde{v2} <- E_K^{-1}(S ^ C) ^ S, then verify and depad
+        for (size_t l = 0; l < lanes; l++) {
+            manx_msg *msg = &msgs[idx[l]];
+            xor_block(v2_tilde + l*BLOCKBYTES, v2_tilde + l*BLOCKBYTES, s + l*BLOCKBYTES);
+            msg->ret = manx1_dec_final(msg->out, &msg->outlen, v[l] + BLOCKBYTES,
+                                       v2_tilde + l*BLOCKBYTES, msg->nlen);
+            failed += (msg->ret != 0);
+        }
+    }
+
+    return failed;
+}
+
+int manx1_ctx_dec(const manx_ctx *ctx,
+            uint8_t p[], size_t *plen,
+            const uint8_t n[], size_t nlen,
+            const uint8_t c[], size_t clen,
+            const uint8_t a[], size_t alen)
+{
+    if (ctx->cipher->decrypt == NULL) {
         *plen = 0;
-        return 3;
+        return -1;
+    }
+
+    return manx1_dec_rk(p, plen, &ctx->rkeys, manx_ctx_rkeys_inv(ctx),
+                        n, nlen, c, clen, a, alen,
+                        ctx->cipher->encrypt, ctx->cipher->decrypt);
+}
+
+/**
+ * @brief Build the V[2] template of a mask, i.e. (V[1],V[2]) without
+ * pad_{n-v2}(M), and return its V[1] block in v1.
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+static int manx1_mask_init(manx1_mask *mask, uint8_t v1[BLOCKBYTES],
+            const uint8_t n[], size_t nlen,
+            const uint8_t a[], size_t alen)
+{
+    static const uint8_t empty[1] = {0x00};
+    size_t  s     = MAX(BLOCKBITS - nlen + MANX_TAU, MANX1_ALPHAMAX);
+    size_t  v2len = s - (BLOCKBITS - nlen);
+    uint8_t v[2*BLOCKBYTES];
+    int     ret;
+
+    // (V[1],V[2] || pad_{n-v2}(ε)), whose padding bit is then cleared
+    if ((ret = manx1_init_blocks(v, n, nlen, empty, 0, a, alen)))
+        return ret;
+    CLRBIT(v[BLOCKBYTES + v2len/8], 7 - v2len%8);
+    for (size_t i = 0; i < BLOCKBYTES; i++) {
+        v1[i]       = v[i];
+        mask->v2[i] = v[BLOCKBYTES + i];
+    }
+    for (size_t i = 0; i < BLOCKBYTES; i++)
+        mask->n[i] = (i < (nlen + 7)/8) ? n[i] : 0x00;
+    mask->nlen = nlen;
+
+    return 0;
+}
+
+int manx1_precompute(const manx_ctx *ctx, manx1_mask *mask,
+            const uint8_t n[], size_t nlen,
+            const uint8_t a[], size_t alen)
+{
+    int ret;
+
+    if ((ret = manx1_mask_init(mask, mask->s, n, nlen, a, alen)))
+        return ret;
+    // S <- 2E_K(V[1])
+    ctx->cipher->encrypt(mask->s, mask->s, &ctx->rkeys);
+    doubling(mask->s);
+
+    return 0;
+}
+
+int manx1_enc_precomputed(const manx_ctx *ctx, const manx1_mask *mask,
+            uint8_t c[], size_t *clen,
+            const uint8_t m[], size_t mlen)
+{
+    size_t  s     = MAX(BLOCKBITS - mask->nlen + MANX_TAU, MANX1_ALPHAMAX);
+    size_t  v2len = s - (BLOCKBITS - mask->nlen);
+    size_t  oct   = v2len / 8;
+    size_t  bit   = v2len % 8;
+    uint8_t v2[BLOCKBYTES];
+    int     ret;
+
+    // the AD length was already checked by manx1_precompute
+    if ((ret = manx1_check_lengths(mask->nlen, mlen, 0))) {
+        *clen = 0;
+        return ret;
+    }
+
+    // V[2] || pad_{n-v2}(M)
+    for (size_t i = 0; i < BLOCKBYTES; i++)
+        v2[i] = mask->v2[i];
+    concat_bits(v2, &oct, &bit, m, mlen);
+    SETBIT(v2[oct], 7-bit);
+
+    // C <- E_K(S ^ V[2]) ^ S
+    xor_block(v2, v2, mask->s);
+    ctx->cipher->encrypt(c, v2, &ctx->rkeys);
+    xor_block(c, c, mask->s);
+
+    *clen = BLOCKBITS;
+    return 0;
+}
+
+/**
+ * @brief Increment a nonce considered as a big-endian integer of nlen bits
+ * (i.e. its last bit being the least significant one), modulo 2^nlen.
+ */
+static void nonce_inc(uint8_t n[], size_t nlen)
+{
+    size_t   i     = (nlen - 1) / 8;
+    unsigned carry = 1u << (7 - (nlen - 1) % 8);
+
+    for (;;) {
+        carry += n[i];
+        n[i]   = (uint8_t)carry;
+        carry >>= 8;
+        if (!carry || i == 0)
+            break;
+        i--;
+    }
+}
+
+int manx1_ring_init(manx1_ring *ring, const manx_ctx *ctx,
+            manx1_mask masks[], size_t size,
+            const uint8_t n[], size_t nlen,
+            const uint8_t a[], size_t alen)
+{
+    int ret;
+
+    if (size == 0 || nlen == 0)
+        return 4;
+    if ((ret = manx1_check_lengths(nlen, 0, alen)))
+        return ret;
+
+    ring->ctx   = ctx;
+    ring->masks = masks;
+    ring->size  = size;
+    ring->head  = 0;
+    ring->count = 0;
+    ring->nlen  = nlen;
+    ring->alen  = alen;
+    for (size_t i = 0; i < BLOCKBYTES; i++)
+        ring->next[i] = (i < (nlen + 7)/8) ? n[i] : 0x00;
+    if (nlen % 8)
+        ring->next[(nlen - 1)/8] &= 0xff << (8 - nlen%8);
+    for (size_t i = 0; i < sizeof(ring->a); i++)
+        ring->a[i] = (i < (alen + 7)/8) ? a[i] : 0x00;
+
+    return 0;
+}
+
+/**
+ * @brief Compute the masks of cnt consecutive counter nonces, starting from
+ * next (which is incremented accordingly), their V[1] blocks being encrypted
+ * up to MANX_BATCH at a time.
+ */
+static void manx1_precompute_next(const manx_ctx *ctx, manx1_mask *masks[], size_t cnt,
+            uint8_t next[], size_t nlen,
+            const uint8_t a[], size_t alen)
+{
+    uint8_t v1[MANX_BATCH*BLOCKBYTES];
+
+    for (size_t k = 0; k < cnt; k += MANX_BATCH) {
+        size_t num = (cnt - k < MANX_BATCH) ? cnt - k : MANX_BATCH;
+
+        for (size_t j = 0; j < num; j++) {
+            manx1_mask_init(masks[k+j], v1 + j*BLOCKBYTES, next, nlen, a, alen);
+            nonce_inc(next, nlen);
+        }
+        ctx_encrypt_blocks(ctx, v1, v1, num);
+        for (size_t j = 0; j < num; j++) {
+            doubling(v1 + j*BLOCKBYTES);
+            for (size_t i = 0; i < BLOCKBYTES; i++)
+                masks[k+j]->s[i] = v1[j*BLOCKBYTES + i];
+        }
+    }
+}
+
+size_t manx1_ring_fill(manx1_ring *ring, size_t max)
+{
+    manx1_mask *masks[MANX_BATCH];
+    size_t      done = 0;
+
+    if (max == 0 || max > ring->size - ring->count)
+        max = ring->size - ring->count;
+
+    while (done < max) {
+        size_t cnt = (max - done < MANX_BATCH) ? max - done : MANX_BATCH;
+        size_t pos = ring->head + ring->count;
+
+        for (size_t j = 0; j < cnt; j++)
+            masks[j] = &ring->masks[(pos + j) % ring->size];
+        manx1_precompute_next(ring->ctx, masks, cnt, ring->next, ring->nlen,
+                              ring->a, ring->alen);
+        ring->count += cnt;
+        done        += cnt;
+    }
+
+    return done;
+}
+
+int manx1_ring_enc(manx1_ring *ring,
+            uint8_t c[], size_t *clen, uint8_t n[],
+            const uint8_t m[], size_t mlen)
+{
+    manx1_mask *mask;
+    int         ret;
+
+    // no mask ready: compute the one of the next nonce on the fly
+    if (ring->count == 0)
+        manx1_ring_fill(ring, 1);
+
+    mask = &ring->masks[ring->head];
+    if ((ret = manx1_enc_precomputed(ring->ctx, mask, c, clen, m, mlen)))
+        return ret;
+    if (n != NULL)
+        for (size_t i = 0; i < (ring->nlen + 7)/8; i++)
+            n[i] = mask->n[i];
+
+    // the mask is consumed (and wiped), as its nonce must not be reused
+    for (size_t i = 0; i < sizeof(*mask); i++)
+        ((volatile uint8_t *)mask)[i] = 0x00;
+    ring->head = (ring->head + 1) % ring->size;
+    ring->count--;
+
+    return 0;
+}
+
+void manx1_ring_wipe(manx1_ring *ring)
+{
+    volatile uint8_t *p = (volatile uint8_t *)ring->masks;
+
+    for (size_t i = 0; i < ring->size*sizeof(manx1_mask); i++)
+        p[i] = 0x00;
+    p = (volatile uint8_t *)ring;
+    for (size_t i = 0; i < sizeof(*ring); i++)
+        p[i] = 0x00;
+}
+
+int manx1_dec_precomputed(const manx_ctx *ctx, const manx1_mask *mask,
+            uint8_t p[], size_t *plen,
+            const uint8_t c[], size_t clen)
+{
+    uint8_t v2_tilde[BLOCKBYTES];
+
+    if (ctx->cipher->decrypt == NULL) {
+        *plen = 0;
+        return -1;
+    }
+    // ensure that the |C| = n
+    if (clen != BLOCKBITS) {
+        *plen = 0;
+        return 1;
+    }
+
+    // \tilde{v2} <- E_K^{-1}(S ^ C) ^ S
+    xor_block(v2_tilde, mask->s, c);
+    ctx->cipher->decrypt(v2_tilde, v2_tilde, manx_ctx_rkeys_inv(ctx));
+    xor_block(v2_tilde, v2_tilde, mask->s);
+
+    return manx1_dec_final(p, plen, mask->v2, v2_tilde, mask->nlen);
+}
+
+/**
+ * @brief Counter of a nonce within a window, i.e. its last min(nlen, 64) bits.
+ */
+static inline uint64_t window_ctr(const uint8_t n[], size_t nlen)
+{
+    size_t k = (nlen < 64) ? nlen : 64;
+
+    return load_bits64_at(n, nlen - k, k) >> (64 - k);
+}
+
+/**
+ * @brief Mask of the counter values within a window (2^min(nlen, 64) - 1).
+ */
+static inline uint64_t window_ctr_mask(size_t nlen)
+{
+    return (nlen < 64) ? ((uint64_t)1 << nlen) - 1 : ~(uint64_t)0;
+}
+
+int manx1_window_init(manx1_window *win, const manx_ctx *ctx,
+            manx1_mask masks[], size_t size,
+            const uint8_t n[], size_t nlen,
+            const uint8_t a[], size_t alen)
+{
+    int ret;
+
+    // the window must cover at most half of the counter values, so that the
+    // counters ahead of it can be told from the ones behind it
+    if (nlen == 0 || size == 0 || (size & (size - 1)) ||
+        (size - 1) > window_ctr_mask(nlen) / 2)
+        return 4;
+    if ((ret = manx1_check_lengths(nlen, 0, alen)))
+        return ret;
+
+    win->ctx    = ctx;
+    win->masks  = masks;
+    win->size   = size;
+    win->nlen   = nlen;
+    win->alen   = alen;
+    win->hits   = 0;
+    win->misses = 0;
+    for (size_t i = 0; i < BLOCKBYTES; i++)
+        win->next_n[i] = (i < (nlen + 7)/8) ? n[i] : 0x00;
+    if (nlen % 8)
+        win->next_n[(nlen - 1)/8] &= 0xff << (8 - nlen%8);
+    for (size_t i = 0; i < sizeof(win->a); i++)
+        win->a[i] = (i < (alen + 7)/8) ? a[i] : 0x00;
+    win->lo   = window_ctr(win->next_n, nlen);
+    win->next = win->lo;
+    // no mask yet (masks of nonces of nlen bits only are looked up)
+    for (size_t i = 0; i < size; i++)
+        masks[i].nlen = 0;
+
+    return 0;
+}
+
+size_t manx1_window_fill(manx1_window *win, size_t max)
+{
+    manx1_mask *masks[MANX_BATCH];
+    uint64_t    ctr_mask = window_ctr_mask(win->nlen);
+    size_t      left     = win->size - ((win->next - win->lo) & ctr_mask);
+    size_t      done     = 0;
+
+    if (max == 0 || max > left)
+        max = left;
+
+    while (done < max) {
+        size_t cnt = (max - done < MANX_BATCH) ? max - done : MANX_BATCH;
+
+        for (size_t j = 0; j < cnt; j++)
+            masks[j] = &win->masks[(win->next + j) & (win->size - 1)];
+        manx1_precompute_next(win->ctx, masks, cnt, win->next_n, win->nlen,
+                              win->a, win->alen);
+        win->next = (win->next + cnt) & ctr_mask;
+        done     += cnt;
+    }
+
+    return done;
+}
+
+int manx1_window_dec(manx1_window *win,
+            uint8_t p[], size_t *plen,
+            const uint8_t n[], size_t nlen,
+            const uint8_t c[], size_t clen,
+            const uint8_t a[], size_t alen)
+{
+    const manx1_mask *mask = NULL;
+    uint64_t          ctr_mask, ctr = 0;
+    int               ret;
+
+    // the nonce and the AD are public: they are compared in variable time
+    if (nlen == win->nlen && alen == win->alen && !sec_memcmp_bits(a, win->a, alen)) {
+        ctr  = window_ctr(n, nlen);
+        mask = &win->masks[ctr & (win->size - 1)];
+        if (mask->nlen != nlen || sec_memcmp_bits(mask->n, n, nlen))
+            mask = NULL;
+    }
+
+    if (mask != NULL) {
+        win->hits++;
+        ret = manx1_dec_precomputed(win->ctx, mask, p, plen, c, clen);
+    } else {
+        win->misses++;
+        ret = manx1_ctx_dec(win->ctx, p, plen, n, nlen, c, clen, a, alen);
+    }
+    if (ret || nlen != win->nlen || alen != win->alen || sec_memcmp_bits(a, win->a, alen))
+        return ret;
+
+    // slide the window past the counter of an authentic frame, the nonces
+    // being considered as ahead of the window on half of the counter values
+    ctr_mask = window_ctr_mask(nlen);
+    ctr      = window_ctr(n, nlen);
+    if (((ctr - win->lo) & ctr_mask) <= ctr_mask / 2)
+        win->lo = (ctr + 1) & ctr_mask;
+    // resynchronize the next nonce to compute if the frame is beyond it
+    if (((win->lo - win->next) & ctr_mask) <= ctr_mask / 2 && win->lo != win->next) {
+        for (size_t i = 0; i < (nlen + 7)/8; i++)
+            win->next_n[i] = n[i];
+        if (nlen % 8)
+            win->next_n[(nlen - 1)/8] &= 0xff << (8 - nlen%8);
+        nonce_inc(win->next_n, nlen);
+        win->next = win->lo;
+    }
+
+    return 0;
+}
+
+void manx1_window_wipe(manx1_window *win)
+{
+    volatile uint8_t *p = (volatile uint8_t *)win->masks;
+
+    for (size_t i = 0; i < win->size*sizeof(manx1_mask); i++)
+        p[i] = 0x00;
+    p = (volatile uint8_t *)win;
+    for (size_t i = 0; i < sizeof(*win); i++)
+        p[i] = 0x00;
+}
+
+int manx1_stream_init(manx1_stream *st, const manx_ctx *ctx,
+            const uint8_t n[], size_t nlen,
+            const uint8_t a[], size_t alen)
+{
+    manx1_mask mask;
+    uint8_t    v1[BLOCKBYTES];
+    int        ret;
+
+    // the nonce increment is an addition to V[1]
+    if (nlen == 0 || nlen > BLOCKBITS)
+        return 4;
+    // same template as a mask, before any cipher call
+    if ((ret = manx1_mask_init(&mask, v1, n, nlen, a, alen)))
+        return ret;
+
+    st->ctx    = ctx;
+    st->nlen   = nlen;
+    st->v2len  = MAX(BLOCKBITS - nlen + MANX_TAU, MANX1_ALPHAMAX) - (BLOCKBITS - nlen);
+    st->inc[0] = 0;
+    st->inc[1] = 1;
+    shl128(st->inc, BLOCKBITS - nlen);
+    load_block64(st->v1, v1);
+    load_block64(st->v2, mask.v2);
+
+    return 0;
+}
+
+int manx1_stream_enc(manx1_stream *st,
+            uint8_t c[], size_t *clen, uint8_t n[],
+            const uint8_t m[], size_t mlen)
+{
+    const manx_ctx *ctx = st->ctx;
+    uint8_t         s[BLOCKBYTES];
+    uint8_t         v2[BLOCKBYTES];
+    uint64_t        w[2];
+    int             ret;
+
+    // the AD length was already checked by manx1_stream_init
+    if ((ret = manx1_check_lengths(st->nlen, mlen, 0))) {
+        *clen = 0;
+        return ret;
     }
 
-    // depad plaintext
-    *plen = depad_10(v2_tilde, v2_tilde);
-    *plen -= v2len;
-    lshift(p, v2_tilde + (v2len/8), *plen, v2len%8);
+    // pad_{n-v2}(M) fits in 64 bits as |M| < n - τ, then V[2] || pad_{n-v2}(M)
+    w[0] = load_bits64(m, mlen) | (((uint64_t)1 << 63) >> mlen);
+    w[1] = 0;
+    shr128(w, st->v2len);
+    w[0] |= st->v2[0];
+    w[1] |= st->v2[1];
+    store_block64(v2, w);
+    store_block64(s, st->v1);
+
+    // S <- 2E_K(V[1])
+    ctx->cipher->encrypt(s, s, &ctx->rkeys);
+    doubling(s);
+
+    // C <- E_K(S ^ V[2]) ^ S
+    xor_block(v2, v2, s);
+    ctx->cipher->encrypt(c, v2, &ctx->rkeys);
+    xor_block(c, c, s);
+    *clen = BLOCKBITS;
+
+    // N being the first field of V[1], it is incremented in place
+    if (n != NULL)
+        store_bits128(n, st->v1, st->nlen);
+    add128(st->v1, st->inc);
 
     return 0;
 }
+
+void manx1_stream_wipe(manx1_stream *st)
+{
+    volatile uint8_t *p = (volatile uint8_t *)st;
+
+    for (size_t i = 0; i < sizeof(*st); i++)
+        p[i] = 0x00;
+}
+
+#if MANX_STATIC_BOUND
+MANX_STATIC_ATTR int manx1_static_enc(uint8_t c[], size_t *clen,
+            const uint8_t k[],
+            const uint8_t n[], size_t nlen,
+            const uint8_t m[], size_t mlen,
+            const uint8_t a[], size_t alen)
+{
+    roundkeys_t rkeys;
+
+    MANX_STATIC_KEXPAND(&rkeys, k);
+    return manx1_enc_rk(c, clen, &rkeys, n, nlen, m, mlen, a, alen,
+                        MANX_STATIC_ENCRYPT);
+}
+
+#ifdef MANX_STATIC_DECRYPT
+MANX_STATIC_ATTR int manx1_static_dec(uint8_t p[], size_t *plen,
+            const uint8_t k[],
+            const uint8_t n[], size_t nlen,
+            const uint8_t c[], size_t clen,
+            const uint8_t a[], size_t alen)
+{
+    roundkeys_t rkeys;
+#ifdef MANX_STATIC_KEXPAND_INV
+    roundkeys_t rkeys_inv;
+
+    MANX_STATIC_KEXPAND(&rkeys, k);
+    MANX_STATIC_KEXPAND_INV(&rkeys_inv, &rkeys);
+    return manx1_dec_rk(p, plen, &rkeys, &rkeys_inv, n, nlen, c, clen, a, alen,
+                        MANX_STATIC_ENCRYPT, MANX_STATIC_DECRYPT);
+#else
+    MANX_STATIC_KEXPAND(&rkeys, k);
+    return manx1_dec_rk(p, plen, &rkeys, &rkeys, n, nlen, c, clen, a, alen,
+                        MANX_STATIC_ENCRYPT, MANX_STATIC_DECRYPT);
+#endif
+}
+#endif
+#endif
@@ -75,7 +75,8 @@ static void init_tiny_msg(uint8_t b[],
     inc_bitpos(&oct, &bit, MANX2_ALPHASTAR - alen);
 #endif
     concat_bits(b, &oct, &bit, m, mlen);           // b <- N || xx || \bar{A} || M
-    SETBIT(b[oct], 7-bit);                         // b <- N || xx || \bar{A} || pad_r(M)
+    if (mlen < r)                                  // no padding if |M| = r
+        SETBIT(b[oct], 7-bit);                     // b <- N || xx || \bar{A} || pad_r(M)
 }
 
 static void init_short_msg(uint8_t b[],
@@ -123,154 +124,734 @@ static void init_short_msg(uint8_t b[],
     SETBIT(b[oct], 7-bit);               // b <- N || 01 || pad_r(M[2])
 }
 
-int manx2_enc(uint8_t c[], size_t *clen,
-            const uint8_t k[],
-            const uint8_t n[], size_t nlen,
-            const uint8_t m[], size_t mlen,
-            const uint8_t a[], size_t alen,
-            enc_func  encrypt,
-            kexp_func kexpand)
+/**
+ * @brief Check the input lengths for Manx2 encryption.
+ *
+ * @return 0 if the lengths are valid, error code otherwise
+ */
+static inline int manx2_check_lengths(size_t nlen, size_t mlen, size_t alen)
 {
     size_t r = BLOCKBITS - (nlen + MANX2_ALPHASTAR + 2);
-    roundkeys_t roundkeys;
 
     // nlen has to be >= TAU to ensure BLOCKBITS/2-bit privacy and TAU-bit authenticity
-    if (nlen < MANX_TAU) {
-        *clen = 0;
+    if (nlen < MANX_TAU)
         return 1;
-    }
     // ensure the message length is consistent w/ other parameters
-    if (mlen >= BLOCKBITS - nlen - 2 + r) {
-        *clen = 0;
+    if (mlen >= BLOCKBITS - nlen - 2 + r)
         return 2;
-    }
     // ensure the associated data is not too large
-    if(alen > MANX2_ALPHAMAX) {
-        *clen = 0;
+    if(alen > MANX2_ALPHAMAX)
         return 3;
-    }
+    return 0;
+}
 
-    // precomputes the round keys
-    if (kexpand != NULL)
-        kexpand(&roundkeys, k);
+int manx2_init_blocks_bytes(uint8_t t[2*BLOCKBYTES], size_t *nblocks,
+            const uint8_t n[], size_t nlen,
+            const uint8_t m[], size_t mlen,
+            const uint8_t a[], size_t alen)
+{
+    size_t r = BLOCKBITS - (nlen + MANX2_ALPHASTAR + 2);
+    int    ret;
+
+    if ((ret = manx2_check_lengths(nlen, mlen, alen)))
+        return ret;
 
     // in case of tiny message
     if (mlen <= r) {
-        uint8_t t[BLOCKBYTES];
+        // N || xx || \bar{A} || pad_r(M)
         init_tiny_msg(t, n, nlen, a, alen, m, mlen);
+        *nblocks = 1;
+    }
+    // in case of short message
+    else {
+        // (N || 00 || \bar{A} || M[1], N || 01 || pad_r(M[2]))
+        init_short_msg(t, n, nlen, a, alen, m, mlen);
+        *nblocks = 2;
+    }
+
+    return 0;
+}
+
+int manx2_init_blocks_words(uint8_t t[2*BLOCKBYTES], size_t *nblocks,
+            const uint8_t n[], size_t nlen,
+            const uint8_t m[], size_t mlen,
+            const uint8_t a[], size_t alen)
+{
+    size_t     r = BLOCKBITS - (nlen + MANX2_ALPHASTAR + 2);
+    bitbuf64_t b;
+    int        ret;
+
+    if ((ret = manx2_check_lengths(nlen, mlen, alen)))
+        return ret;
+
+    // N || xx || \bar{A}
+    bitbuf64_init(&b, t);
+    bitbuf64_concat(&b, n, 0, nlen);
+    if (mlen < r)           // domain separator = 10
+        bitbuf64_put(&b, (uint64_t)2 << 62, 2);
+    else if (mlen == r)     // domain separator = 11
+        bitbuf64_put(&b, (uint64_t)3 << 62, 2);
+    else                    // domain separator = 00
+        bitbuf64_put(&b, 0, 2);
+    bitbuf64_concat(&b, a, 0, alen);
+#if MANX2_VARIABLE_ADLEN
+    // one-zero padding to build \bar{A} from A
+    bitbuf64_put(&b, (uint64_t)1 << 63, 1);
+    bitbuf64_skip(&b, MANX2_ALPHASTAR - alen - 1);
+#endif
+
+    // in case of tiny message: N || xx || \bar{A} || pad_r(M)
+    if (mlen <= r) {
+        bitbuf64_concat(&b, m, 0, mlen);
+        if (mlen < r)       // no padding if |M| = r
+            bitbuf64_put(&b, (uint64_t)1 << 63, 1);
+        bitbuf64_flush(&b, t + BLOCKBYTES);
+        *nblocks = 1;
+        return 0;
+    }
+
+    // in case of short message: (N || 00 || \bar{A} || M[1], N || 01 || pad_r(M[2]))
+    bitbuf64_concat(&b, m, 0, r);
+    bitbuf64_concat(&b, n, 0, nlen);
+    bitbuf64_put(&b, (uint64_t)1 << 62, 2);
+    bitbuf64_concat(&b, m, r, mlen - r);
+    bitbuf64_put(&b, (uint64_t)1 << 63, 1);
+    bitbuf64_flush(&b, t + 2*BLOCKBYTES);
+    *nblocks = 2;
+    return 0;
+}
+
+int manx2_init_blocks(uint8_t t[2*BLOCKBYTES], size_t *nblocks,
+            const uint8_t n[], size_t nlen,
+            const uint8_t m[], size_t mlen,
+            const uint8_t a[], size_t alen)
+{
+#if MANX2_WORD_FORMATTING
+    return manx2_init_blocks_words(t, nblocks, n, nlen, m, mlen, a, alen);
+#else
+    return manx2_init_blocks_bytes(t, nblocks, n, nlen, m, mlen, a, alen);
+#endif
+}
+
+/**
+ * @brief Manx2 encryption core, relying on pre-computed round keys.
+ */
+MANX_ALWAYS_INLINE int manx2_enc_rk(uint8_t c[], size_t *clen,
+            const roundkeys_t *rkeys,
+            const uint8_t n[], size_t nlen,
+            const uint8_t m[], size_t mlen,
+            const uint8_t a[], size_t alen,
+            enc_func encrypt,
+            encn_func encrypt_blocks)
+{
+    int     ret;
+    size_t  nblocks;
+    uint8_t t[2*BLOCKBYTES];
+    MANX_PHASE_BEGIN();
+
+    MANX_PHASE_CALL();
+    ret = manx2_init_blocks(t, &nblocks, n, nlen, m, mlen, a, alen);
+    MANX_PHASE(MANX_PHASE_FORMAT);
+    if (ret) {
+        *clen = 0;
+        return ret;
+    }
+
+    // in case of tiny message
+    if (nblocks == 1) {
         // C <- E_K(N || xx || \bar{A} || pad_r(M))
-        if (kexpand != NULL)
-            encrypt(c, t, &roundkeys);
-        else
-            encrypt(c, t, (roundkeys_t*)k);
+        encrypt(c, t, rkeys);
         *clen = 128;
     }
     // in case of short message
     else {
-        uint8_t t[2*BLOCKBYTES];
-        init_short_msg(t, n, nlen, a, alen, m, mlen);
         // C[1] <- E_K(N || 00 || \bar{A} || M[1])
         // C[2] <- E_K(N || 01 || pad_r(M[2]))
-        if (kexpand != NULL) {
-            encrypt(c, t, &roundkeys);
-            encrypt(c + BLOCKBYTES, t + BLOCKBYTES, &roundkeys);
-        }
-        else {
-            encrypt(c, t, (roundkeys_t*)k);
-            encrypt(c + BLOCKBYTES, t + BLOCKBYTES, (roundkeys_t*)k);
+        if (encrypt_blocks != NULL) {
+            encrypt_blocks(c, t, 2, rkeys);
+        } else {
+            encrypt(c, t, rkeys);
+            encrypt(c + BLOCKBYTES, t + BLOCKBYTES, rkeys);
         }
         *clen = 256;
     }
+    MANX_PHASE(MANX_PHASE_CIPHER);
 
     return 0;
 }
 
+/**
+ * @brief Encode the header of the blocks but the nonce and the domain
+ * separator, i.e. \bar{A} from bit nlen + 2, as a 128-bit value (w[0] being
+ * its most significant limb), along with the mask of the nlen + 2 + α* bits
+ * of the header.
+ *
+ * @return 0 if successfully executed, 1 if the lengths are invalid
+ */
+static int manx2_hdr_init(uint64_t abar[2], uint64_t hmask[2],
+            size_t nlen,
+            const uint8_t a[], size_t alen)
+{
+    if (alen > MANX2_ALPHAMAX || nlen + 2 + MANX2_ALPHASTAR > BLOCKBITS)
+        return 1;
+    load_bits128(abar, a, alen);
+#if MANX2_VARIABLE_ADLEN
+    // one-zero padding to build \bar{A} from A
+    uint64_t pad[2] = {(uint64_t)1 << 63, 0};
+    shr128(pad, alen);
+    abar[0] |= pad[0];
+    abar[1] |= pad[1];
+#endif
+    shr128(abar, nlen + 2);
+    hmask[0] = ~(uint64_t)0;
+    hmask[1] = ~(uint64_t)0;
+    mask128(hmask, nlen + 2 + MANX2_ALPHASTAR);
+    return 0;
+}
 
-int manx2_dec(uint8_t p[], size_t *plen,
-            const uint8_t k[],
+/**
+ * @brief Verify the decrypted block(s) s and extract the plaintext from them
+ * once all the cipher calls have been carried out. The header of the first
+ * block is compared with a masked 128-bit comparison, given its \bar{A} field
+ * and mask (see `manx2_hdr_init`).
+ *
+ * @return 0 if successfully executed, error code otherwise
+ */
+static int manx2_dec_final(uint8_t p[], size_t *plen,
+            uint8_t s[2*BLOCKBYTES],
+            const uint8_t n[], size_t nlen,
+            size_t clen,
+            const uint64_t abar[2], const uint64_t hmask[2])
+{
+    size_t   r    = BLOCKBITS - (nlen + MANX2_ALPHASTAR + 2); // r ← n − (ν + α∗ + 2); 
+    size_t   mpos = nlen + 2 + MANX2_ALPHASTAR;
+    uint8_t *s2 = s + BLOCKBYTES;
+    uint64_t w[2], w2[2], t[2], d[2] = {(uint64_t)1 << 63, 0};
+    uint64_t full, diff;
+    size_t   padlen;
+    uint8_t  ds;
+    int      ret;
+
+    load_block64(w, s);
+    // d <- first bit of the domain separator
+    shr128(d, nlen);
+    if (clen == BLOCKBITS) {
+        // N || 1 || ds || \bar{A}, where ds is the second bit of the decrypted separator
+        load_bits128(t, n, nlen);
+        t[0] |= abar[0] | d[0];
+        t[1] |= abar[1] | d[1];
+        shr128(d, 1);
+        ds   = (w[0] & d[0]) != 0 || (w[1] & d[1]) != 0;
+        diff = ((w[0] ^ t[0]) & hmask[0] & ~d[0]) | ((w[1] ^ t[1]) & hmask[1] & ~d[1]);
+
+        // if ds = 0, the padding bit must follow \bar{A}
+        full = -(uint64_t)ds;
+        ret  = depad_10(w, &padlen);
+        ret |= (padlen < mpos);
+        ret &= !ds;
+        padlen = (padlen & ~full) | (BLOCKBITS & full);
+        ret |= (diff != 0);
+        if (ret) {
+            *plen = 0;
+            return 2;
+        }
+        *plen = padlen - mpos;
+        shl128(w, mpos);
+    }
+
+    else {
+        (void) n; // nonce is not required for decryption in case of short messages
+        // ensures \tilde{N}[1] == \tilde{N}[2] && \tilde{b}[1] == 00 && \tilde{A} == \bar{A}
+        load_block64(w2, s2);
+        t[0] = w2[0];
+        t[1] = w2[1];
+        mask128(t, nlen);
+        t[0] |= abar[0];
+        t[1] |= abar[1];
+        if (((w[0] ^ t[0]) & hmask[0]) | ((w[1] ^ t[1]) & hmask[1])) {
+            *plen = 0;
+            return 3;
+        }
+        // ensures \tilde{b}[2] == 01 and that the padding bit follows it
+        ret  = depad_10(w2, &padlen);
+        ret |= (padlen < nlen + 2);
+        ret |= GETBIT(s2[nlen/8], 7-(nlen%8)) != 0;
+        ret |= GETBIT(s2[(nlen+1)/8], 7-((nlen+1)%8)) != 1;
+        if (ret) {
+            *plen = 0;
+            return 4;
+        }
+        // M <- \tilde{M}[1] || depad_{r'}(\tilde{M}[2]), which fits in a block
+        *plen = r + padlen - (nlen + 2);
+        shl128(w, mpos);
+        shl128(w2, nlen + 2);
+        shr128(w2, r);
+        mask128(w, r);
+        w[0] |= w2[0];
+        w[1] |= w2[1];
+    }
+
+    // the plaintext is now at offset 0
+    store_bits128(p, w, *plen);
+
+    return 0;
+}
+
+/**
+ * @brief Manx2 decryption core, relying on pre-computed round keys.
+ */
+MANX_ALWAYS_INLINE int manx2_dec_rk(uint8_t p[], size_t *plen,
+            const roundkeys_t *rkeys,
             const uint8_t n[], size_t nlen,
             const uint8_t c[], size_t clen,
             const uint8_t a[], size_t alen,
-            dec_func  decrypt,
-            kexp_func kexpand)
+            const uint64_t *abar, const uint64_t *hmask,
+            dec_func decrypt,
+            decn_func decrypt_blocks)
 {
-    size_t r = BLOCKBITS - (nlen + MANX2_ALPHASTAR + 2); // r ← n − (ν + α∗ + 2); 
-    uint8_t  t[BLOCKBYTES]; // input block
-    uint8_t s1[BLOCKBYTES]; // input block
-    uint8_t ds;
-    size_t oct;
-    size_t bit;
+    uint8_t  s[2*BLOCKBYTES]; // decrypted blocks
+    uint64_t hdr[2][2];
+    int      ret;
+    MANX_PHASE_BEGIN();
 
+    MANX_PHASE_CALL();
     if (clen != BLOCKBITS && clen != 2*BLOCKBITS) {
             *plen = 0;
             return 1;
     }
+    // \bar{A} field of the header, unless pre-encoded
+    if (abar == NULL) {
+        if (manx2_hdr_init(hdr[0], hdr[1], nlen, a, alen)) {
+            *plen = 0;
+            return 1;
+        }
+        abar  = hdr[0];
+        hmask = hdr[1];
+        MANX_PHASE(MANX_PHASE_FORMAT);
+    }
+
+    if (clen == BLOCKBITS) {
+        decrypt(s, c, rkeys);
+    } else if (decrypt_blocks != NULL) {
+        decrypt_blocks(s, c, 2, rkeys);
+    } else {
+        decrypt(s, c, rkeys);
+        decrypt(s + BLOCKBYTES, c + BLOCKBYTES, rkeys);
+    }
+    MANX_PHASE(MANX_PHASE_CIPHER);
+
+    ret = manx2_dec_final(p, plen, s, n, nlen, clen, abar, hmask);
+    MANX_PHASE(MANX_PHASE_VERIFY);
+    return ret;
+}
 
+int manx2_enc(uint8_t c[], size_t *clen,
+            const uint8_t k[],
+            const uint8_t n[], size_t nlen,
+            const uint8_t m[], size_t mlen,
+            const uint8_t a[], size_t alen,
+            enc_func  encrypt,
+            kexp_func kexpand)
+{
     roundkeys_t roundkeys;
-    if (kexpand != NULL)
+    const roundkeys_t *rkeys = (const roundkeys_t*)k;
+
+    MANX_PHASE_BEGIN();
+
+    // precomputes the round keys
+    if (kexpand != NULL) {
         kexpand(&roundkeys, k);
+        rkeys = &roundkeys;
+    }
+    MANX_PHASE(MANX_PHASE_KEXPAND);
 
-    if (clen == BLOCKBITS) {
-        if (kexpand != NULL) 
-            decrypt(s1, c, &roundkeys);
-        else
-            decrypt(s1, c, (roundkeys_t*)k);
-        init_tiny_msg(t, n, nlen, a, alen, c, 0);
-        ds = GETBIT(s1[(nlen+1)/8], 7-((nlen+1)%8));
-        CHGBIT(t[(nlen+1)/8], 7-((nlen+1)%8), ds);
-        
-        if (sec_memcmp_bits(s1, t, nlen + 2 + MANX2_ALPHASTAR)) {
-            *plen = 0;
-            return 2;
+    return manx2_enc_rk(c, clen, rkeys, n, nlen, m, mlen, a, alen, encrypt, NULL);
+}
+
+int manx2_dec(uint8_t p[], size_t *plen,
+            const uint8_t k[],
+            const uint8_t n[], size_t nlen,
+            const uint8_t c[], size_t clen,
+            const uint8_t a[], size_t alen,
+            dec_func  decrypt,
+            kexp_func kexpand)
+{
+    roundkeys_t roundkeys;
+    const roundkeys_t *rkeys = (const roundkeys_t*)k;
+
+    MANX_PHASE_BEGIN();
+
+    // precomputes the round keys
+    if (kexpand != NULL) {
+        kexpand(&roundkeys, k);
+        rkeys = &roundkeys;
+    }
+    MANX_PHASE(MANX_PHASE_KEXPAND);
+
+    return manx2_dec_rk(p, plen, rkeys, n, nlen, c, clen, a, alen, NULL, NULL,
+                        decrypt, NULL);
+}
+
+int manx2_ctx_enc(const manx_ctx *ctx,
+            uint8_t c[], size_t *clen,
+            const uint8_t n[], size_t nlen,
+            const uint8_t m[], size_t mlen,
+            const uint8_t a[], size_t alen)
+{
+    return manx2_enc_rk(c, clen, &ctx->rkeys, n, nlen, m, mlen, a, alen,
+                        ctx->cipher->encrypt, ctx->cipher->encrypt_blocks);
+}
+
+size_t manx2_enc_batch(const manx_ctx *ctx, manx_msg msgs[], size_t count)
+{
+    uint8_t t[2*MANX_BATCH*BLOCKBYTES];
+    size_t  idx[MANX_BATCH];
+    size_t  failed = 0;
+    size_t  i      = 0;
+
+    while (i < count) {
+        size_t lanes   = 0;
+        size_t nblocks = 0;
+
+        // gather up to MANX_BATCH valid messages
+        for (; i < count && lanes < MANX_BATCH; i++) {
+            manx_msg *msg = &msgs[i];
+            size_t    nb;
+            msg->ret = manx2_init_blocks(t + nblocks*BLOCKBYTES, &nb, msg->n,
+                                         msg->nlen, msg->in, msg->inlen,
+                                         msg->a, msg->alen);
+            if (msg->ret) {
+                msg->outlen = 0;
+                failed++;
+                continue;
+            }
+            msg->outlen  = nb*BLOCKBITS;
+            nblocks     += nb;
+            idx[lanes++] = i;
         }
+        if (lanes == 0)
+            break;
 
-        if (ds)
-            *plen = clen;
-        else
-            *plen = depad_10(s1, s1);
+        // C <- E_K(T) for all blocks of all messages
+        ctx_encrypt_blocks(ctx, t, t, nblocks);
 
-        *plen -= nlen + 2 + MANX2_ALPHASTAR;
-        lshift(p, s1 + (nlen + 2 + MANX2_ALPHASTAR) / 8, *plen, (nlen + 2 + MANX2_ALPHASTAR) % 8);
+        nblocks = 0;
+        for (size_t l = 0; l < lanes; l++) {
+            manx_msg *msg = &msgs[idx[l]];
+            for (size_t j = 0; j < msg->outlen/8; j++)
+                msg->out[j] = t[nblocks*BLOCKBYTES + j];
+            nblocks += msg->outlen/BLOCKBITS;
+        }
     }
 
-    else {
-        (void) n; // nonce is not required for decryption in case of short messages
-        uint8_t s2[BLOCKBYTES];
-        if (kexpand != NULL) {
-            decrypt(s1, c, &roundkeys);
-            decrypt(s2, c + BLOCKBYTES, &roundkeys);
-        } else {
-            decrypt(s1, c, (roundkeys_t*)k);
-            decrypt(s2, c + BLOCKBYTES, (roundkeys_t*)k);
+    return failed;
+}
+
+size_t manx2_dec_batch(const manx_ctx *ctx, manx_msg msgs[], size_t count)
+{
+    uint8_t  s[2*MANX_BATCH*BLOCKBYTES];
+    uint64_t hdr[MANX_BATCH][2][2];
+    size_t   idx[MANX_BATCH];
+    size_t   failed = 0;
+    size_t   i      = 0;
+
+    if (ctx->cipher->decrypt == NULL) {
+        for (i = 0; i < count; i++) {
+            msgs[i].outlen = 0;
+            msgs[i].ret    = -1;
         }
+        return count;
+    }
 
-        init_tiny_msg(t, s2, nlen, a, alen, c, 0);
-        CLRBIT(t[(nlen+1)/8], 7-((nlen+1)%8));
-        CLRBIT(t[nlen/8], 7-(nlen%8));
+    while (i < count) {
+        size_t lanes   = 0;
+        size_t nblocks = 0;
 
-        // ensures \tilde{N}[1] == \tilde{N}[2] && \tilde{b}[1] == 00 && \tilde{A} == \bar{A}
-        if (sec_memcmp_bits(s1, t, nlen + 2 + MANX2_ALPHASTAR)) {
-            *plen = 0;
-            return 3;
+        // gather up to MANX_BATCH valid ciphertexts
+        for (; i < count && lanes < MANX_BATCH; i++) {
+            manx_msg *msg = &msgs[i];
+            if ((msg->inlen != BLOCKBITS && msg->inlen != 2*BLOCKBITS) ||
+                manx2_hdr_init(hdr[lanes][0], hdr[lanes][1], msg->nlen, msg->a, msg->alen)) {
+                msg->outlen = 0;
+                msg->ret    = 1;
+                failed++;
+                continue;
+            }
+            for (size_t j = 0; j < msg->inlen/8; j++)
+                s[nblocks*BLOCKBYTES + j] = msg->in[j];
+            nblocks     += msg->inlen/BLOCKBITS;
+            idx[lanes++] = i;
         }
-        // ensures \tilde{b}[2] == 01
-        if (GETBIT(s2[nlen/8], 7-(nlen%8)) != 0 || GETBIT(s2[(nlen+1)/8], 7-((nlen+1)%8)) != 1) {
-            *plen = 0;
-            return 4;
+        if (lanes == 0)
+            break;
+
+        // S <- E_K^{-1}(C) for all blocks of all ciphertexts
+        ctx_decrypt_blocks(ctx, s, s, nblocks);
+
+        nblocks = 0;
+        for (size_t l = 0; l < lanes; l++) {
+            manx_msg *msg = &msgs[idx[l]];
+            msg->ret = manx2_dec_final(msg->out, &msg->outlen,
+                                       s + nblocks*BLOCKBYTES, msg->n, msg->nlen,
+                                       msg->inlen, hdr[l][0], hdr[l][1]);
+            failed  += (msg->ret != 0);
+            nblocks += msg->inlen/BLOCKBITS;
+        }
+    }
+
+    return failed;
+}
+
+int manx2_ctx_dec(const manx_ctx *ctx,
+            uint8_t p[], size_t *plen,
+            const uint8_t n[], size_t nlen,
+            const uint8_t c[], size_t clen,
+            const uint8_t a[], size_t alen)
+{
+    if (ctx->cipher->decrypt == NULL) {
+        *plen = 0;
+        return -1;
+    }
+
+    return manx2_dec_rk(p, plen, manx_ctx_rkeys_inv(ctx), n, nlen, c, clen, a, alen,
+                        NULL, NULL, ctx->cipher->decrypt, ctx->cipher->decrypt_blocks);
+}
+
+int manx2_ad_cache_init(manx2_ad_cache *cache, manx2_ad_entry entries[], size_t size)
+{
+    if (size == 0)
+        return 1;
+
+    cache->entries = entries;
+    cache->size    = size;
+    cache->next    = 0;
+    cache->hits    = 0;
+    cache->misses  = 0;
+    // no entry yet (valid nonce lengths being non-zero)
+    for (size_t i = 0; i < size; i++)
+        entries[i].nlen = 0;
+
+    return 0;
+}
+
+int manx2_ctx_dec_cached(const manx_ctx *ctx, manx2_ad_cache *cache,
+            uint8_t p[], size_t *plen,
+            const uint8_t n[], size_t nlen,
+            const uint8_t c[], size_t clen,
+            const uint8_t a[], size_t alen)
+{
+    const manx2_ad_entry *entry = NULL;
+    uint64_t              hdr[2][2];
+    int                   ret;
+
+    if (ctx->cipher->decrypt == NULL) {
+        *plen = 0;
+        return -1;
+    }
+
+    // the AD is public: it is looked up in variable time
+    for (size_t i = 0; i < cache->size && entry == NULL; i++) {
+        const manx2_ad_entry *e = &cache->entries[i];
+        if (e->nlen == nlen && nlen != 0 && e->alen == alen && !sec_memcmp_bits(e->a, a, alen))
+            entry = e;
+    }
+    if (entry != NULL) {
+        cache->hits++;
+        return manx2_dec_rk(p, plen, manx_ctx_rkeys_inv(ctx), n, nlen, c, clen, a, alen,
+                            entry->abar, entry->hmask,
+                            ctx->cipher->decrypt, ctx->cipher->decrypt_blocks);
+    }
+
+    cache->misses++;
+    if (manx2_hdr_init(hdr[0], hdr[1], nlen, a, alen)) {
+        *plen = 0;
+        return 1;
+    }
+    ret = manx2_dec_rk(p, plen, manx_ctx_rkeys_inv(ctx), n, nlen, c, clen, a, alen,
+                       hdr[0], hdr[1], ctx->cipher->decrypt, ctx->cipher->decrypt_blocks);
+
+    // only the ADs of authentic ciphertexts are cached, so that forgeries
+    // cannot evict the ones in use
+    if (ret == 0) {
+        manx2_ad_entry *e = &cache->entries[cache->next];
+        cache->next = (cache->next + 1) % cache->size;
+        e->nlen     = nlen;
+        e->alen     = alen;
+        for (size_t i = 0; i < sizeof(e->a); i++)
+            e->a[i] = (i < (alen + 7)/8) ? a[i] : 0x00;
+        for (size_t i = 0; i < 2; i++) {
+            e->abar[i]  = hdr[0][i];
+            e->hmask[i] = hdr[1][i];
+        }
+    }
+
+    return ret;
+}
+
+void manx2_ad_cache_wipe(manx2_ad_cache *cache)
+{
+    volatile uint8_t *p = (volatile uint8_t *)cache->entries;
+
+    for (size_t i = 0; i < cache->size*sizeof(manx2_ad_entry); i++)
+        p[i] = 0x00;
+    p = (volatile uint8_t *)cache;
+    for (size_t i = 0; i < sizeof(*cache); i++)
+        p[i] = 0x00;
+}
+
+int manx2_stream_init(manx2_stream *st, const manx_ctx *ctx,
+            const uint8_t n[], size_t nlen,
+            const uint8_t a[], size_t alen)
+{
+    static const uint8_t empty[1] = {0x00};
+    size_t   mpos   = nlen + 2 + MANX2_ALPHASTAR;
+    uint64_t pad[2] = {(uint64_t)1 << 63, 0};
+    uint8_t  t[2*BLOCKBYTES];
+    size_t   nblocks;
+    int      ret;
+
+    // N || xx || \bar{A} must fit in a block
+    if (mpos > BLOCKBITS)
+        return 4;
+    // N || 10 || \bar{A} || pad_r(ε) (N || 11 || \bar{A} if r = 0), whose
+    // domain separator and padding bit are then cleared
+    if ((ret = manx2_init_blocks(t, &nblocks, n, nlen, empty, 0, a, alen)))
+        return ret;
+
+    st->ctx     = ctx;
+    st->nlen    = nlen;
+    st->ds10[0] = (uint64_t)2 << 62;
+    st->ds10[1] = 0;
+    st->ds11[0] = (uint64_t)3 << 62;
+    st->ds11[1] = 0;
+    shr128(st->ds10, nlen);
+    shr128(st->ds11, nlen);
+    shr128(pad, mpos);
+    load_block64(st->t1, t);
+    st->t1[0] &= ~(st->ds11[0] | pad[0]);
+    st->t1[1] &= ~(st->ds11[1] | pad[1]);
+    // N || 01
+    st->t2[0] = st->t1[0];
+    st->t2[1] = st->t1[1];
+    mask128(st->t2, nlen);
+    st->t2[0] |= st->ds11[0] & ~st->ds10[0];
+    st->t2[1] |= st->ds11[1] & ~st->ds10[1];
+    st->inc[0] = 0;
+    st->inc[1] = 1;
+    shl128(st->inc, BLOCKBITS - nlen);
+
+    return 0;
+}
+
+int manx2_stream_enc(manx2_stream *st,
+            uint8_t c[], size_t *clen, uint8_t n[],
+            const uint8_t m[], size_t mlen)
+{
+    const manx_ctx *ctx  = st->ctx;
+    size_t          r    = BLOCKBITS - (st->nlen + MANX2_ALPHASTAR + 2);
+    size_t          mpos = BLOCKBITS - r;
+    uint64_t        w[2], w1[2], pad[2] = {(uint64_t)1 << 63, 0};
+    uint8_t         t[2*BLOCKBYTES];
+    int             ret;
+
+    // the AD length was already checked by manx2_stream_init
+    if ((ret = manx2_check_lengths(st->nlen, mlen, 0))) {
+        *clen = 0;
+        return ret;
+    }
+
+    // M and pad(M) fit in 128 bits as |M| < 2n - 2ν - α* - 4 and ν >= τ
+    load_bits128(w, m, mlen);
+    shr128(pad, mlen);
+
+    // in case of tiny message: N || xx || \bar{A} || pad_r(M)
+    if (mlen <= r) {
+        const uint64_t *ds = (mlen < r) ? st->ds10 : st->ds11;
+        if (mlen < r) {     // no padding if |M| = r
+            w[0] |= pad[0];
+            w[1] |= pad[1];
         }
-        // M <- \tilde{M}[1] || depad_{r'}(\tilde{M}[2])
-        *plen = r;
-
-        lshift(p, s1 + (nlen + 2 + MANX2_ALPHASTAR) / 8, BLOCKBITS - (nlen + MANX2_ALPHASTAR + 2), (nlen + 2 + MANX2_ALPHASTAR) % 8);
-        oct = r / 8;
-        bit = r % 8;
-        r   = depad_10(s2, s2);
-        r  -= nlen + 2;
-
-        lshift(s2, s2 + (nlen + 2) / 8, r, (nlen + 2) % 8);
-        concat_bits(p, &oct, &bit, s2, r);
-        *plen += r;
+        shr128(w, mpos);
+        w[0] |= st->t1[0] | ds[0];
+        w[1] |= st->t1[1] | ds[1];
+        store_block64(t, w);
+        // C <- E_K(N || xx || \bar{A} || pad_r(M))
+        ctx->cipher->encrypt(c, t, &ctx->rkeys);
+        *clen = BLOCKBITS;
+    }
+    // in case of short message: (N || 00 || \bar{A} || M[1], N || 01 || pad_r(M[2]))
+    else {
+        w1[0] = w[0];
+        w1[1] = w[1];
+        mask128(w1, r);
+        shr128(w1, mpos);
+        w1[0] |= st->t1[0];
+        w1[1] |= st->t1[1];
+        store_block64(t, w1);
+        w[0] |= pad[0];
+        w[1] |= pad[1];
+        shl128(w, r);
+        shr128(w, st->nlen + 2);
+        w[0] |= st->t2[0];
+        w[1] |= st->t2[1];
+        store_block64(t + BLOCKBYTES, w);
+        // C[1] <- E_K(N || 00 || \bar{A} || M[1])
+        // C[2] <- E_K(N || 01 || pad_r(M[2]))
+        ctx_encrypt_blocks(ctx, c, t, 2);
+        *clen = 2*BLOCKBITS;
     }
 
+    // N being the first field of both blocks, it is incremented in place
+    if (n != NULL)
+        store_bits128(n, st->t1, st->nlen);
+    add128(st->t1, st->inc);
+    add128(st->t2, st->inc);
+
     return 0;
 }
+
+void manx2_stream_wipe(manx2_stream *st)
+{
+    volatile uint8_t *p = (volatile uint8_t *)st;
+
+    for (size_t i = 0; i < sizeof(*st); i++)
+        p[i] = 0x00;
+}
+
+#if MANX_STATIC_BOUND
+MANX_STATIC_ATTR int manx2_static_enc(uint8_t c[], size_t *clen,
+            const uint8_t k[],
+            const uint8_t n[], size_t nlen,
+            const uint8_t m[], size_t mlen,
+            const uint8_t a[], size_t alen)
+{
+    roundkeys_t rkeys;
+
+    MANX_STATIC_KEXPAND(&rkeys, k);
+    return manx2_enc_rk(c, clen, &rkeys, n, nlen, m, mlen, a, alen,
+                        MANX_STATIC_ENCRYPT, NULL);
+}
+
+#ifdef MANX_STATIC_DECRYPT
+MANX_STATIC_ATTR int manx2_static_dec(uint8_t p[], size_t *plen,
+            const uint8_t k[],
+            const uint8_t n[], size_t nlen,
+            const uint8_t c[], size_t clen,
+            const uint8_t a[], size_t alen)
+{
+    roundkeys_t rkeys;
+#ifdef MANX_STATIC_KEXPAND_INV
+    roundkeys_t rkeys_inv;
+
+    MANX_STATIC_KEXPAND(&rkeys, k);
+    MANX_STATIC_KEXPAND_INV(&rkeys_inv, &rkeys);
+    return manx2_dec_rk(p, plen, &rkeys_inv, n, nlen, c, clen, a, alen, NULL, NULL,
+                        MANX_STATIC_DECRYPT, NULL);
+#else
+    MANX_STATIC_KEXPAND(&rkeys, k);
+    return manx2_dec_rk(p, plen, &rkeys, n, nlen, c, clen, a, alen, NULL, NULL,
+                        MANX_STATIC_DECRYPT, NULL);
+#endif
+}
+#endif
+#endif
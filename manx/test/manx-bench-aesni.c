@@ -0,0 +1,53 @@
+/**
+ * @file manx-bench-aesni.c
+ *
+ * @brief AES-NI baseline of the benchmarks of the x86_64 ports other than
+ * AES-128, to be compiled with ../../manx-aes128/x86_64 in the include path
+ * (see manx-bench-aesni.h).
+ *
+ * @author Alexandre Adomnicai <alexandre@adomnicai.me>
+ *
+ * @date October 2026
+ */
+#include "block_cipher.h"
+#include "manx-bench-aesni.h"
+
+struct aesni_bench_keys {
+    roundkeys_t rkeys;
+    roundkeys_t rkeys_inv;
+};
+
+const aesni_bench_keys *aesni_bench_expand(const uint8_t key[16])
+{
+    static aesni_bench_keys keys;
+
+    aes128_kexp(&keys.rkeys, key);
+    aes128_kexp_inv(&keys.rkeys_inv, &keys.rkeys);
+    return &keys;
+}
+
+void aesni_bench_enc(const void *keys, uint8_t *out, const uint8_t *in, size_t nblocks)
+{
+    const aesni_bench_keys *k = keys;
+    for (size_t i = 0; i < nblocks; i++)
+        aes128_enc(out + i*BLOCKBYTES, in + i*BLOCKBYTES, &k->rkeys);
+}
+
+void aesni_bench_dec(const void *keys, uint8_t *out, const uint8_t *in, size_t nblocks)
+{
+    const aesni_bench_keys *k = keys;
+    for (size_t i = 0; i < nblocks; i++)
+        aes128_dec_inv(out + i*BLOCKBYTES, in + i*BLOCKBYTES, &k->rkeys_inv);
+}
+
+void aesni_bench_mb_enc(const void *keys, uint8_t *out, const uint8_t *in, size_t nblocks)
+{
+    const aesni_bench_keys *k = keys;
+    aes128_enc_blocks(out, in, nblocks, &k->rkeys);
+}
+
+void aesni_bench_mb_dec(const void *keys, uint8_t *out, const uint8_t *in, size_t nblocks)
+{
+    const aesni_bench_keys *k = keys;
+    aes128_dec_inv_blocks(out, in, nblocks, &k->rkeys_inv);
+}
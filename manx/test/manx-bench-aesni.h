@@ -0,0 +1,37 @@
+/**
+ * @file manx-bench-aesni.h
+ *
+ * @brief AES-NI baseline of the benchmarks of the x86_64 ports other than
+ * AES-128 (see MANX_BENCH_AESNI in manx-bench.h): the AES-128 round keys are
+ * only handled by manx-bench-aesni.c, compiled along with the block_cipher.h
+ * of ../../manx-aes128/x86_64, which cannot be included alongside the one of
+ * the port.
+ *
+ * @author Alexandre Adomnicai <alexandre@adomnicai.me>
+ *
+ * @date October 2026
+ */
+#ifndef MANX_BENCH_AESNI_H_
+#define MANX_BENCH_AESNI_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Round keys for encryption and decryption, opaque outside of
+ * manx-bench-aesni.c.
+ */
+typedef struct aesni_bench_keys aesni_bench_keys;
+
+// expand a key into static storage, overwritten by the next call
+const aesni_bench_keys *aesni_bench_expand(const uint8_t key[16]);
+
+// nblocks independent blocks, one at a time (aes128_enc, aes128_dec_inv)
+void aesni_bench_enc(const void *keys, uint8_t *out, const uint8_t *in, size_t nblocks);
+void aesni_bench_dec(const void *keys, uint8_t *out, const uint8_t *in, size_t nblocks);
+
+// nblocks independent blocks, interleaved (aes128_enc_blocks, aes128_dec_inv_blocks)
+void aesni_bench_mb_enc(const void *keys, uint8_t *out, const uint8_t *in, size_t nblocks);
+void aesni_bench_mb_dec(const void *keys, uint8_t *out, const uint8_t *in, size_t nblocks);
+
+#endif
@@ -0,0 +1,188 @@
+/**
+ * @file manx-bench.h
+ *
+ * @brief Benchmarks shared by the test programs of the x86_64 ports (see
+ * test/bench.c in each of them, where this file is symlinked): timing helpers
+ * and batch functions, as well as the block functions for various frame sizes
+ * compared to AES-NI for the ports other than AES-128 (MANX_BENCH_AESNI, see
+ * manx-bench-aesni.h).
+ *
+ * @author Alexandre Adomnicai <alexandre@adomnicai.me>
+ *
+ * @date October 2026
+ */
+#ifndef MANX_BENCH_H_
+#define MANX_BENCH_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <x86intrin.h>
+#include "../manx.h"
+
+/**
+ * Number of timed runs (the median is reported) and number of blocks or
+ * messages processed per run.
+ */
+#define RUNS    101
+#define NBLOCKS 4096
+#define NMSGS   1024
+
+static int cmp_u64(const void *x, const void *y)
+{
+    uint64_t a = *(const uint64_t *)x, b = *(const uint64_t *)y;
+    return (a > b) - (a < b);
+}
+
+static uint64_t median(uint64_t t[RUNS])
+{
+    qsort(t, RUNS, sizeof(t[0]), cmp_u64);
+    return t[RUNS/2];
+}
+
+static uint8_t in[NBLOCKS*BLOCKBYTES], out[NBLOCKS*BLOCKBYTES];
+
+/**
+ * Time the batch functions over NMSGS messages for a few (ν, α, ℓ) parameter
+ * sets, and check that no message has been rejected.
+ */
+static void bench_batch(const manx_ctx *ctx)
+{
+    static uint8_t  n[BLOCKBYTES], a[BLOCKBYTES], m[2*BLOCKBYTES];
+    static uint8_t  c[NMSGS][2*BLOCKBYTES], p[NMSGS][2*BLOCKBYTES];
+    static manx_msg msgs[NMSGS];
+    static const struct {
+        size_t (*enc)(const manx_ctx*, manx_msg*, size_t);
+        size_t (*dec)(const manx_ctx*, manx_msg*, size_t);
+        size_t nlen, alen, mlen;
+    } cases[] = {
+        { manx1_enc_batch, manx1_dec_batch, 96, 32, 30 },
+        { manx2_enc_batch, manx2_dec_batch, 64, 16, 32 },  // tiny messages
+        { manx2_enc_batch, manx2_dec_batch, 64, 16, 96 },  // short messages
+    };
+    size_t failed = 0;
+    uint64_t t_enc[RUNS], t_dec[RUNS];
+
+    printf("%-20s", ctx->cipher->name);
+    for (size_t k = 0; k < sizeof(cases)/sizeof(cases[0]); k++) {
+        for (size_t r = 0; r < RUNS; r++) {
+            for (size_t i = 0; i < NMSGS; i++)
+                msgs[i] = (manx_msg){ .n = n, .nlen = cases[k].nlen, .a = a,
+                    .alen = cases[k].alen, .in = m, .inlen = cases[k].mlen, .out = c[i] };
+            uint64_t start = __rdtsc();
+            failed += cases[k].enc(ctx, msgs, NMSGS);
+            t_enc[r] = __rdtsc() - start;
+            for (size_t i = 0; i < NMSGS; i++) {
+                msgs[i].in    = c[i];
+                msgs[i].inlen = msgs[i].outlen;
+                msgs[i].out   = p[i];
+            }
+            start = __rdtsc();
+            failed += cases[k].dec(ctx, msgs, NMSGS);
+            t_dec[r] = __rdtsc() - start;
+        }
+        printf(" %8.1f %8.1f", (double)median(t_enc)/NMSGS, (double)median(t_dec)/NMSGS);
+    }
+    printf("%s\n", failed ? " (FAILED)" : "");
+}
+
+static void bench_batch_header(void)
+{
+    printf("\n%-20s %17s %17s %17s\n", "cycles/message", "manx1 (96,32,30)",
+           "manx2 (64,16,32)", "manx2 (64,16,96)");
+    printf("%-20s %8s %8s %8s %8s %8s %8s\n", "", "enc", "dec", "enc", "dec", "enc", "dec");
+}
+
+#ifdef MANX_BENCH_AESNI
+#include "manx-bench-aesni.h"
+
+/**
+ * Function processing nblocks independent blocks, the round keys of the port
+ * (through a Manx context) or the AES-128 ones being passed through rkeys.
+ */
+typedef void (blocks_func)(const void *rkeys, uint8_t *out, const uint8_t *in, size_t nblocks);
+
+static void ctx_enc(const void *rkeys, uint8_t *out, const uint8_t *in, size_t nblocks)
+{
+    const manx_ctx *ctx = rkeys;
+    ctx->cipher->encrypt_blocks(out, in, nblocks, &ctx->rkeys);
+}
+
+static void ctx_dec(const void *rkeys, uint8_t *out, const uint8_t *in, size_t nblocks)
+{
+    const manx_ctx *ctx = rkeys;
+    ctx->cipher->decrypt_blocks(out, in, nblocks, manx_ctx_rkeys_inv(ctx));
+}
+
+/**
+ * Time the processing of NBLOCKS blocks by calls of nblocks blocks each, and
+ * print the cost in cycles per block.
+ */
+static void bench_frames(blocks_func f, const void *rkeys, size_t nblocks)
+{
+    uint64_t t[RUNS];
+    size_t   ncalls = NBLOCKS / nblocks;
+
+    for (size_t r = 0; r < RUNS; r++) {
+        uint64_t start = __rdtsc();
+        for (size_t i = 0; i < ncalls; i++)
+            f(rkeys, out + i*nblocks*BLOCKBYTES, in + i*nblocks*BLOCKBYTES, nblocks);
+        t[r] = __rdtsc() - start;
+    }
+    printf(" %6.1f", (double)median(t)/(ncalls*nblocks));
+}
+
+static void bench_blocks(const char *name, const size_t frames[], size_t nframes,
+            blocks_func enc, blocks_func dec, const void *rkeys, const void *rkeys_inv)
+{
+    printf("%-20s", name);
+    for (size_t i = 0; i < nframes; i++)
+        bench_frames(enc, rkeys, frames[i]);
+    printf(" |");
+    for (size_t i = 0; i < nframes; i++)
+        bench_frames(dec, rkeys_inv, frames[i]);
+    printf("\n");
+}
+
+/**
+ * Time the block functions of each implementation of the table of ciphers
+ * (the ones not supported being NULL) by frames of frames[i] blocks, then
+ * the AES-NI ones if supported, and the batch functions.
+ */
+static void bench_ciphers(const manx_cipher *const ciphers[], size_t count,
+            const uint8_t key[16], const size_t frames[], size_t nframes)
+{
+    manx_ctx ctx;
+
+    printf("%-20s %-41s   %s\n", "cycles/block", "enc", "dec");
+    printf("%-20s", "(blocks per call)");
+    for (int k = 0; k < 2; k++) {
+        for (size_t i = 0; i < nframes; i++)
+            printf(" %6zu", frames[i]);
+        printf("%s", k ? "\n" : " |");
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (ciphers[i] == NULL)
+            continue;
+        manx_ctx_init(&ctx, key, ciphers[i]);
+        bench_blocks(ciphers[i]->name, frames, nframes, ctx_enc, ctx_dec, &ctx, &ctx);
+        manx_ctx_wipe(&ctx);
+    }
+    if (__builtin_cpu_supports("aes")) {
+        const aesni_bench_keys *aes = aesni_bench_expand(key);
+        bench_blocks("AES-NI", frames, nframes, aesni_bench_enc, aesni_bench_dec, aes, aes);
+        bench_blocks("AES-NI multi-block", frames, nframes, aesni_bench_mb_enc,
+                     aesni_bench_mb_dec, aes, aes);
+    }
+
+    bench_batch_header();
+    for (size_t i = 0; i < count; i++) {
+        if (ciphers[i] == NULL)
+            continue;
+        manx_ctx_init(&ctx, key, ciphers[i]);
+        bench_batch(&ctx);
+        manx_ctx_wipe(&ctx);
+    }
+}
+#endif
+
+#endif
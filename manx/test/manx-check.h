@@ -0,0 +1,348 @@
+/**
+ * @file manx-check.h
+ *
+ * @brief Checks shared by the test programs of the x86_64 ports (see
+ * test/check.c in each of them, where this file is symlinked): helpers, KATs,
+ * sweeps over the parameter sets and batch functions, run for each
+ * implementation of the table of ciphers of a port against its reference
+ * block cipher functions.
+ *
+ * @author Alexandre Adomnicai <alexandre@adomnicai.me>
+ *
+ * @date October 2026
+ */
+#ifndef MANX_CHECK_H_
+#define MANX_CHECK_H_
+
+#include <stdio.h>
+#include <string.h>
+#include "../manx.h"
+
+/**
+ * Block cipher of a port as checked by check_ciphers: reference functions
+ * (decrypt relying on the round keys returned by kexpand, as passed to
+ * manx1_dec and manx2_dec), known-answer ciphertexts for the inputs of
+ * check_kat and FNV-1a digests of all the ciphertexts produced when sweeping
+ * over the parameter sets (ν, α, l) supported by the configuration in
+ * manx-config.h.
+ */
+typedef struct check_suite check_suite;
+
+struct check_suite {
+    kexp_func  *kexpand;
+    enc_func   *encrypt;
+    dec_func   *decrypt;
+    const char *kat_manx1_96_30_64;
+    const char *kat_manx1_128_63_0;
+    const char *kat_manx2_64_96_0;
+    uint64_t    sweep_manx1;
+    uint64_t    sweep_manx2;
+    // additional checks for each implementation (optional, e.g. check_kat)
+    void      (*check_impl)(const check_suite *suite, const manx_ctx *ctx, const uint8_t key[16]);
+};
+
+static int         failures = 0;
+static const char *impl     = ""; // implementation being checked
+
+static void check(int cond, const char *what)
+{
+    if (!cond) {
+        printf("FAIL: %s%s\n", impl, what);
+        failures++;
+    }
+}
+
+static int hexeq(const uint8_t *buf, size_t len, const char *hex)
+{
+    char tmp[2*2*BLOCKBYTES + 1];
+    for (size_t i = 0; i < len; i++)
+        sprintf(tmp + 2*i, "%02x", buf[i]);
+    return strcmp(tmp, hex) == 0;
+}
+
+static void fnv1a(uint64_t *h, const uint8_t *buf, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        *h ^= buf[i];
+        *h *= 0x100000001b3ULL;
+    }
+}
+
+static void fill(uint8_t *buf, size_t len, uint8_t seed)
+{
+    for (size_t i = 0; i < len; i++)
+        buf[i] = (uint8_t)(seed + 0x9d*i + (i >> 1));
+}
+
+static int bits_equal(const uint8_t *x, const uint8_t *y, size_t bitlen)
+{
+    if (memcmp(x, y, bitlen/8))
+        return 0;
+    if (bitlen % 8)
+        return ((x[bitlen/8] ^ y[bitlen/8]) & (0xff << (8 - bitlen%8))) == 0;
+    return 1;
+}
+
+static void check_kat(const check_suite *suite, const manx_ctx *ctx, const uint8_t key[16])
+{
+    uint8_t ad[16], nonce[16], ptext[16];
+    uint8_t ctext[2*BLOCKBYTES], ctext_ctx[2*BLOCKBYTES];
+    size_t  outlen, outlen_ctx;
+
+    for (size_t i = 0; i < 16; i++)
+        ad[i] = nonce[i] = i;
+    memcpy(ptext, "\x7f\x43\xf6\xaf\x88\x5a\x30\x8d\x31\x31\x98\xa2\xe0\x37\x07\x34", 16);
+
+    manx1_enc(ctext, &outlen, key, nonce, 96, ptext, 30, ad, 64, suite->encrypt, suite->kexpand);
+    check(hexeq(ctext, outlen/8, suite->kat_manx1_96_30_64), "manx1_enc KAT (96, 30, 64)");
+    manx1_ctx_enc(ctx, ctext_ctx, &outlen_ctx, nonce, 96, ptext, 30, ad, 64);
+    check(hexeq(ctext_ctx, outlen_ctx/8, suite->kat_manx1_96_30_64), "manx1_ctx_enc KAT (96, 30, 64)");
+
+    manx1_enc(ctext, &outlen, key, nonce, 128, ptext, 63, ad, 0, suite->encrypt, suite->kexpand);
+    check(hexeq(ctext, outlen/8, suite->kat_manx1_128_63_0), "manx1_enc KAT (128, 63, 0)");
+    manx1_ctx_enc(ctx, ctext_ctx, &outlen_ctx, nonce, 128, ptext, 63, ad, 0);
+    check(hexeq(ctext_ctx, outlen_ctx/8, suite->kat_manx1_128_63_0), "manx1_ctx_enc KAT (128, 63, 0)");
+
+    manx2_enc(ctext, &outlen, key, nonce, 64, ptext, 96, ad, 0, suite->encrypt, suite->kexpand);
+    check(hexeq(ctext, outlen/8, suite->kat_manx2_64_96_0), "manx2_enc KAT (64, 96, 0)");
+    manx2_ctx_enc(ctx, ctext_ctx, &outlen_ctx, nonce, 64, ptext, 96, ad, 0);
+    check(hexeq(ctext_ctx, outlen_ctx/8, suite->kat_manx2_64_96_0), "manx2_ctx_enc KAT (64, 96, 0)");
+}
+
+/**
+ * Multi-block kernels of a context against the reference single-block
+ * functions (with the round keys rkeys), for all block counts.
+ */
+static int check_blocks_with(const check_suite *suite, const manx_ctx *ctx,
+            const roundkeys_t *rkeys, encn_func encn, decn_func decn)
+{
+    uint8_t in[37*BLOCKBYTES], ref[37*BLOCKBYTES], out[37*BLOCKBYTES];
+    int     ok = 1;
+
+    fill(in, sizeof(in), 0x42);
+    for (size_t nblocks = 0; nblocks <= 37; nblocks++) {
+        memset(out, 0xa5, sizeof(out));
+        for (size_t i = 0; i < nblocks; i++)
+            suite->encrypt(ref + i*BLOCKBYTES, in + i*BLOCKBYTES, rkeys);
+        encn(out, in, nblocks, &ctx->rkeys);
+        ok &= memcmp(ref, out, nblocks*BLOCKBYTES) == 0;
+        for (size_t i = nblocks*BLOCKBYTES; i < sizeof(out); i++)
+            ok &= out[i] == 0xa5;
+        for (size_t i = 0; i < nblocks; i++)
+            suite->decrypt(ref + i*BLOCKBYTES, in + i*BLOCKBYTES, rkeys);
+        decn(out, in, nblocks, manx_ctx_rkeys_inv(ctx));
+        ok &= memcmp(ref, out, nblocks*BLOCKBYTES) == 0;
+    }
+    return ok;
+}
+
+static void check_sweep_manx1(const check_suite *suite, const manx_ctx *ctx, const uint8_t key[16])
+{
+    uint8_t  n[BLOCKBYTES], a[BLOCKBYTES], m[2*BLOCKBYTES];
+    uint8_t  c[BLOCKBYTES], c_ctx[BLOCKBYTES], p[2*BLOCKBYTES];
+    size_t   clen, clen_ctx, plen;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    int      ok_enc = 1, ok_dec = 1, ok_static = 1;
+
+    for (size_t nlen = 0; nlen <= BLOCKBITS; nlen++) {
+        for (size_t alen = 0; alen <= MANX1_ALPHAMAX; alen++) {
+            for (size_t mlen = 0; mlen < BLOCKBITS; mlen++) {
+                fill(n, sizeof(n), nlen);
+                fill(a, sizeof(a), alen + 7);
+                fill(m, sizeof(m), mlen + 13);
+                int ret = manx1_enc(c, &clen, key, n, nlen, m, mlen, a, alen, suite->encrypt, suite->kexpand);
+                int ret_ctx = manx1_ctx_enc(ctx, c_ctx, &clen_ctx, n, nlen, m, mlen, a, alen);
+                ok_enc &= (ret == ret_ctx) && (clen == clen_ctx);
+                if (ret)
+                    continue;
+                ok_enc &= memcmp(c, c_ctx, clen/8) == 0;
+                fnv1a(&h, c, clen/8);
+#if MANX_STATIC_BOUND
+                ok_static &= manx1_static_enc(c_ctx, &clen_ctx, key, n, nlen, m, mlen, a, alen) == 0;
+                ok_static &= (clen_ctx == clen) && memcmp(c, c_ctx, clen/8) == 0;
+                ok_static &= manx1_static_dec(p, &plen, key, n, nlen, c, clen, a, alen) == 0;
+                ok_static &= (plen == mlen) && bits_equal(p, m, mlen);
+#endif
+                ret = manx1_ctx_dec(ctx, p, &plen, n, nlen, c, clen, a, alen);
+                ok_dec &= (ret == 0) && (plen == mlen) && bits_equal(p, m, mlen);
+                ret = manx1_dec(p, &plen, key, n, nlen, c, clen, a, alen, suite->encrypt, suite->decrypt, suite->kexpand);
+                ok_dec &= (ret == 0) && (plen == mlen) && bits_equal(p, m, mlen);
+                // flipping a ciphertext bit should always be detected
+                c[nlen % BLOCKBYTES] ^= 0x01;
+                ok_dec &= manx1_ctx_dec(ctx, p, &plen, n, nlen, c, clen, a, alen) != 0;
+            }
+        }
+    }
+    check(ok_enc, "manx1 sweep: manx1_ctx_enc matches manx1_enc");
+    check(ok_dec, "manx1 sweep: decryption round trip");
+    check(ok_static, "manx1 sweep: manx1_static_enc and manx1_static_dec match manx1_enc");
+    check(h == suite->sweep_manx1, "manx1 sweep: ciphertext digest");
+}
+
+static void check_sweep_manx2(const check_suite *suite, const manx_ctx *ctx, const uint8_t key[16])
+{
+    uint8_t  n[BLOCKBYTES], a[BLOCKBYTES], m[2*BLOCKBYTES];
+    uint8_t  c[2*BLOCKBYTES], c_ctx[2*BLOCKBYTES], p[2*BLOCKBYTES];
+    size_t   clen, clen_ctx, plen;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    int      ok_enc = 1, ok_dec = 1, ok_static = 1;
+
+    for (size_t nlen = MANX_TAU; nlen <= BLOCKBITS - MANX2_ALPHASTAR - 2; nlen++) {
+        for (size_t alen = 0; alen <= MANX2_ALPHAMAX; alen++) {
+            for (size_t mlen = 0; mlen < 2*BLOCKBITS; mlen++) {
+                fill(n, sizeof(n), nlen);
+                fill(a, sizeof(a), alen + 7);
+                fill(m, sizeof(m), mlen + 13);
+                int ret = manx2_enc(c, &clen, key, n, nlen, m, mlen, a, alen, suite->encrypt, suite->kexpand);
+                int ret_ctx = manx2_ctx_enc(ctx, c_ctx, &clen_ctx, n, nlen, m, mlen, a, alen);
+                ok_enc &= (ret == ret_ctx) && (clen == clen_ctx);
+                if (ret)
+                    continue;
+                ok_enc &= memcmp(c, c_ctx, clen/8) == 0;
+                fnv1a(&h, c, clen/8);
+#if MANX_STATIC_BOUND
+                ok_static &= manx2_static_enc(c_ctx, &clen_ctx, key, n, nlen, m, mlen, a, alen) == 0;
+                ok_static &= (clen_ctx == clen) && memcmp(c, c_ctx, clen/8) == 0;
+                ok_static &= manx2_static_dec(p, &plen, key, n, nlen, c, clen, a, alen) == 0;
+                ok_static &= (plen == mlen) && bits_equal(p, m, mlen);
+#endif
+                ret = manx2_ctx_dec(ctx, p, &plen, n, nlen, c, clen, a, alen);
+                ok_dec &= (ret == 0) && (plen == mlen) && bits_equal(p, m, mlen);
+                ret = manx2_dec(p, &plen, key, n, nlen, c, clen, a, alen, suite->decrypt, suite->kexpand);
+                ok_dec &= (ret == 0) && (plen == mlen) && bits_equal(p, m, mlen);
+                // flipping a ciphertext bit should always be detected
+                c[nlen % BLOCKBYTES] ^= 0x01;
+                ok_dec &= manx2_ctx_dec(ctx, p, &plen, n, nlen, c, clen, a, alen) != 0;
+            }
+        }
+    }
+    check(ok_enc, "manx2 sweep: manx2_ctx_enc matches manx2_enc");
+    check(ok_dec, "manx2 sweep: decryption round trip");
+    check(ok_static, "manx2 sweep: manx2_static_enc and manx2_static_dec match manx2_enc");
+    check(h == suite->sweep_manx2, "manx2 sweep: ciphertext digest");
+}
+
+typedef int (ctx_func)(const manx_ctx*, uint8_t*, size_t*, const uint8_t*, size_t,
+                       const uint8_t*, size_t, const uint8_t*, size_t);
+typedef size_t (batch_func)(const manx_ctx*, manx_msg*, size_t);
+
+#define BATCH_MSGS (9*2*BLOCKBITS)
+
+/**
+ * Run the messages through the batch function by chunks of count messages and
+ * compare each output, length and return code against the single-message one.
+ */
+static int check_batch_msgs(const manx_ctx *ctx, manx_msg msgs[], size_t nmsgs,
+            size_t count, batch_func batch, ctx_func single)
+{
+    uint8_t out[2*BLOCKBYTES];
+    size_t  outlen;
+    int     ok = 1;
+
+    for (size_t j = 0; j < nmsgs; j += count) {
+        size_t cnt   = (nmsgs - j < count) ? nmsgs - j : count;
+        size_t fails = batch(ctx, msgs + j, cnt);
+        for (size_t k = 0; k < cnt; k++) {
+            const manx_msg *msg = &msgs[j+k];
+            int ret = single(ctx, out, &outlen, msg->n, msg->nlen,
+                             msg->in, msg->inlen, msg->a, msg->alen);
+            ok &= (ret == msg->ret) && (outlen == msg->outlen);
+            ok &= ret || bits_equal(out, msg->out, outlen);
+            fails -= (ret != 0);
+        }
+        ok &= (fails == 0);
+    }
+    return ok;
+}
+
+/**
+ * Batches of various sizes (including invalid and forged messages) against
+ * the single-message functions, for a given nonce length.
+ */
+static int check_batch_nlen(const manx_ctx *ctx, size_t nlen, size_t count,
+            batch_func enc_batch, ctx_func enc,
+            batch_func dec_batch, ctx_func dec,
+            size_t alphamax, size_t maxlen)
+{
+    static uint8_t  n[BLOCKBYTES], a[9][BLOCKBYTES];
+    static uint8_t  m[BATCH_MSGS][2*BLOCKBYTES], p[BATCH_MSGS][2*BLOCKBYTES];
+    static uint8_t  c[BATCH_MSGS][2*BLOCKBYTES];
+    static manx_msg msgs[BATCH_MSGS];
+    size_t nmsgs = 0;
+    int    ok;
+
+    fill(n, sizeof(n), nlen);
+    for (size_t i = 0; i < 9; i++) {
+        size_t alen = i*alphamax/8;
+        fill(a[i], BLOCKBYTES, alen + 7);
+        for (size_t mlen = 0; mlen < maxlen; mlen++, nmsgs++) {
+            fill(m[nmsgs], sizeof(m[nmsgs]), mlen + 13);
+            msgs[nmsgs] = (manx_msg){ .n = n, .nlen = nlen, .a = a[i],
+                .alen = alen, .in = m[nmsgs], .inlen = mlen, .out = c[nmsgs] };
+        }
+    }
+    ok = check_batch_msgs(ctx, msgs, nmsgs, count, enc_batch, enc);
+
+    // decrypt the ciphertexts (empty ones being invalid), forging one out of 3
+    for (size_t i = 0; i < nmsgs; i++) {
+        msgs[i].in    = c[i];
+        msgs[i].inlen = msgs[i].outlen;
+        msgs[i].out   = p[i];
+        if (i % 3 == 0)
+            c[i][i % BLOCKBYTES] ^= 0x01;
+    }
+    ok &= check_batch_msgs(ctx, msgs, nmsgs, count, dec_batch, dec);
+    return ok;
+}
+
+static void check_batch(const manx_ctx *ctx)
+{
+    int ok1 = 1, ok2 = 1;
+
+    for (size_t nlen = 0; nlen <= BLOCKBITS; nlen++)
+        ok1 &= check_batch_nlen(ctx, nlen, 1 + nlen % 19,
+                                manx1_enc_batch, manx1_ctx_enc,
+                                manx1_dec_batch, manx1_ctx_dec,
+                                MANX1_ALPHAMAX, BLOCKBITS);
+    for (size_t nlen = 0; nlen <= BLOCKBITS - MANX2_ALPHASTAR - 2; nlen++)
+        ok2 &= check_batch_nlen(ctx, nlen, 1 + nlen % 19,
+                                manx2_enc_batch, manx2_ctx_enc,
+                                manx2_dec_batch, manx2_ctx_dec,
+                                MANX2_ALPHAMAX, 2*BLOCKBITS);
+    check(ok1, "manx1 batch functions match single-message ones");
+    check(ok2, "manx2 batch functions match single-message ones");
+}
+
+/**
+ * All the checks relying on a Manx context, for each implementation of the
+ * table of ciphers (the ones not supported being NULL).
+ */
+static void check_ciphers(const check_suite *suite, const manx_cipher *const ciphers[],
+            size_t count, const uint8_t key[16])
+{
+    manx_ctx    ctx;
+    roundkeys_t rkeys;
+    char        buf[64];
+
+    suite->kexpand(&rkeys, key);
+    for (size_t i = 0; i < count; i++) {
+        const manx_cipher *cipher = ciphers[i];
+        if (cipher == NULL)
+            continue;
+        snprintf(buf, sizeof(buf), "[%s] ", cipher->name);
+        impl = buf;
+        check(manx_ctx_init(&ctx, key, cipher) == 0, "manx_ctx_init");
+        if (suite->check_impl != NULL)
+            suite->check_impl(suite, &ctx, key);
+        if (cipher->encrypt_blocks != NULL && cipher->decrypt_blocks != NULL)
+            check(check_blocks_with(suite, &ctx, &rkeys, cipher->encrypt_blocks, cipher->decrypt_blocks),
+                  "multi-block functions match the single-block ones");
+        check_sweep_manx1(suite, &ctx, key);
+        check_sweep_manx2(suite, &ctx, key);
+        check_batch(&ctx);
+        manx_ctx_wipe(&ctx);
+        impl = "";
+    }
+}
+
+#endif